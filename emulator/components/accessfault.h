@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "exceptions/InvalidAddress.h"
+#include "exceptions/MemoryNoImplementation.h"
+#include "exceptions/MemoryReadOnly.h"
+
+namespace emulator::component
+{
+
+// How the bus answers an access nothing on it can serve
+enum class AccessFaultPolicy {
+    OpenBus, // Reads return the open bus value, writes are dropped
+    LogOnce, // As OpenBus, logging the first fault at each address
+    Trap,    // As OpenBus, then stop in the debugger if one is attached
+    Strict,  // Throw the matching exception, for tests
+};
+
+struct AccessFault {
+    enum class Reason : std::uint8_t {
+        Unmapped,      // No component at the address
+        ReadOnly,      // Write to read-only memory
+        Unimplemented, // Component has no handler for the access width
+    };
+
+    std::uint64_t address{0};
+    std::size_t size{0};
+    bool isWrite{false};
+    Reason reason{Reason::Unmapped};
+
+    [[noreturn]] void Throw() const
+    {
+        switch (reason) {
+        case Reason::ReadOnly:
+            throw MemoryReadOnlyViolation(address, size);
+        case Reason::Unimplemented:
+            throw MemoryNoImplementation(!isWrite, address, size);
+        default:
+            throw InvalidAddress(address, isWrite ? InvalidAddress::AccessType::WRITE : InvalidAddress::AccessType::READ);
+        }
+    }
+};
+
+// Every byte of a value read from open bus is the bus value
+template <typename T>
+T OpenBusValue(std::uint8_t value) noexcept
+{
+    T result;
+    std::memset(&result, value, sizeof(T));
+    return result;
+}
+
+}; // namespace emulator::component
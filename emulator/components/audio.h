@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "blipbuffer.h"
+#include "component.h"
+#include "spscqueue.h"
+#include "wavwriter.h"
+
+namespace emulator::component
+{
+
+/**
+ * Sound output, mono samples at the host rate handed from the emulation thread to an
+ * audio thread.
+ *
+ * Systems add the changes of their channel outputs to the band-limited buffer as they
+ * happen and end a frame every so often, which moves the finished samples into a
+ * lock-free ring for ReadSamples. Anything the consumer falls behind on is dropped.
+ */
+class Audio : public IComponent
+{
+public:
+    using Sample = BlipBuffer::Sample;
+
+    static constexpr std::uint32_t kDefaultSampleRate = 48000;
+
+    // About a third of a second at the default rate
+    static constexpr std::size_t kRingSize = 16384;
+
+    // Queued when the system paces itself by audio, the latency added on top of the device's
+    static constexpr std::uint32_t kTargetLatencyMs = 40;
+
+protected:
+    double clockRate_;
+    std::uint64_t maxFrameClocks_;
+    std::uint32_t sampleRate_;
+
+    BlipBuffer blip_;
+    SPSCQueue<Sample, kRingSize> ring_;
+    std::vector<Sample> frame_;
+
+    std::uint64_t droppedSamples_{0};
+    std::unique_ptr<WavWriter> wav_;
+
+    std::size_t FrameSamples(std::uint32_t sampleRate) const noexcept
+    {
+        return std::size_t(maxFrameClocks_ * double(sampleRate) / clockRate_) + 1;
+    }
+
+    // Close the current frame clocks cycles after it started and publish its samples
+    void EndFrame(std::uint64_t clocks)
+    {
+        blip_.EndFrame(clocks);
+
+        frame_.resize(blip_.SamplesAvailable());
+        blip_.ReadSamples(frame_);
+        droppedSamples_ += frame_.size() - ring_.Push(frame_);
+
+        if (wav_) {
+            wav_->Write(frame_);
+        }
+    }
+
+public:
+    // Frames must end within maxFrameClocks cycles of starting
+    Audio(double clockRate, std::uint64_t maxFrameClocks, std::uint32_t sampleRate = kDefaultSampleRate)
+        : IComponent(ComponentType::Sound), clockRate_(clockRate), maxFrameClocks_(maxFrameClocks),
+          sampleRate_(sampleRate), blip_(clockRate, sampleRate, FrameSamples(sampleRate))
+    {
+    }
+
+    std::uint32_t GetSampleRate() const noexcept
+    {
+        return sampleRate_;
+    }
+
+    // Only while the system is not running
+    void SetSampleRate(std::uint32_t sampleRate) noexcept
+    {
+        sampleRate_ = sampleRate;
+        blip_ = BlipBuffer(clockRate_, sampleRate, FrameSamples(sampleRate));
+    }
+
+    //
+    // Audio thread
+    //
+
+    // Returns how many samples were read, the rest of samples is left untouched
+    std::size_t ReadSamples(std::span<Sample> samples) noexcept
+    {
+        return ring_.Pop(samples);
+    }
+
+    std::size_t GetBufferedSamples() const noexcept
+    {
+        return ring_.Size();
+    }
+
+    std::size_t GetTargetSamples() const noexcept
+    {
+        return std::size_t(sampleRate_) * kTargetLatencyMs / 1000;
+    }
+
+    //
+    // Emulation thread, or while the system is not running
+    //
+
+    std::uint64_t GetDroppedSamples() const noexcept
+    {
+        return droppedSamples_;
+    }
+
+    // Also write everything produced to a WAV file, throws std::runtime_error if it can not be opened
+    void StartWav(const std::string& path)
+    {
+        wav_ = std::make_unique<WavWriter>(path, sampleRate_);
+    }
+
+    void StopWav() noexcept
+    {
+        wav_.reset();
+    }
+
+    bool WritingWav() const noexcept
+    {
+        return wav_ != nullptr;
+    }
+};
+
+}; // namespace emulator::component
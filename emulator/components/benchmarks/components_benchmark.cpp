@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include "bus.h"
+#include "display.h"
+#include "memory.h"
+#include "multimappedmemory.h"
+
+using emulator::component::Bus;
+using emulator::component::Display;
+using emulator::component::Memory;
+using emulator::component::MemoryType;
+using emulator::component::MultiMappedMemory;
+
+// Bus with args(0) RAM banks of 0x1000 bytes, accesses land in the last one
+static void BusWithBanks(Bus& bus, std::size_t banks)
+{
+    for (std::size_t i = 0; i < banks; i++) {
+        bus.AddComponent(new Memory<MemoryType::ReadWrite>(i * 0x1000, 0x1000));
+    }
+}
+
+static void BM_BusRead(benchmark::State& state)
+{
+    Bus bus;
+    BusWithBanks(bus, state.range(0));
+    std::size_t base = (state.range(0) - 1) * 0x1000;
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.Read<std::uint8_t>(base + (i++ & 0xFFF)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BusRead)->Arg(1)->Arg(4)->Arg(16);
+
+static void BM_BusWrite(benchmark::State& state)
+{
+    Bus bus;
+    BusWithBanks(bus, state.range(0));
+    std::size_t base = (state.range(0) - 1) * 0x1000;
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        bus.Write<std::uint8_t>(base + (i & 0xFFF), static_cast<std::uint8_t>(i));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BusWrite)->Arg(1)->Arg(4)->Arg(16);
+
+// 8 KiB dump across two banks, args(0) uses ReadBlock instead of a byte loop
+static void BM_BusReadBlock(benchmark::State& state)
+{
+    Bus bus;
+    BusWithBanks(bus, 2);
+    std::vector<std::uint8_t> buffer(0x2000);
+
+    for (auto _ : state) {
+        if (state.range(0)) {
+            bus.ReadBlock(0, buffer);
+        } else {
+            for (std::size_t i = 0; i < buffer.size(); i++) {
+                buffer[i] = bus.Read<std::uint8_t>(i);
+            }
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_BusReadBlock)->ArgName("block")->Arg(0)->Arg(1);
+
+static void BM_MemoryRead(benchmark::State& state)
+{
+    Memory<MemoryType::ReadWrite> memory(0x1000);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(memory.ReadUInt8(i++ & 0xFFF));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryRead);
+
+static void BM_MemoryWrite(benchmark::State& state)
+{
+    Memory<MemoryType::ReadWrite> memory(0x1000);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        memory.WriteUInt8(i & 0xFFF, static_cast<std::uint8_t>(i));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryWrite);
+
+// Echo RAM style mirror, accesses go through the second mapping
+static void BM_MultiMappedMemoryRead(benchmark::State& state)
+{
+    Bus bus;
+    bus.AddComponent(new MultiMappedMemory<MemoryType::ReadWrite>({{0xC000, 0xE000}, {0xE000, 0xFDFF}}, 0x2000));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bus.Read<std::uint8_t>(0xE000 + (i++ & 0xFFF)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MultiMappedMemoryRead);
+
+static void BM_DisplayGetPixelData(benchmark::State& state)
+{
+    Display display(160, 144);
+    display.SetScale(state.range(0));
+
+    for (auto _ : state) {
+        std::size_t width, height;
+        auto pixels = display.GetPixelData(width, height);
+        benchmark::DoNotOptimize(pixels);
+        delete[] pixels;
+    }
+    state.SetItemsProcessed(state.iterations() * 160 * 144);
+}
+BENCHMARK(BM_DisplayGetPixelData)->Arg(1)->Arg(4);
+
+// Memory contexts are the only snapshot mechanism components have
+static void BM_MemorySnapshot(benchmark::State& state)
+{
+    Memory<MemoryType::ReadWrite> memory(state.range(0));
+    auto context = memory.SaveContext(state.range(0));
+
+    for (auto _ : state) {
+        memory.OverwriteContext(context, state.range(0));
+        memory.RestoreContext(context);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MemorySnapshot)->Arg(0x1000)->Arg(0x2000);
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace emulator::component
+{
+
+/**
+ * Band-limited synthesis of a signal made of steps, resampled from a clock to a host rate.
+ *
+ * Sources add the change in their output at the clock cycle it happens, so a square
+ * wave costs two deltas per period no matter the rates. Each delta lands as a windowed
+ * sinc impulse at its fractional output position; reading integrates the impulses back
+ * into steps without the aliasing of point sampling, and removes any DC offset.
+ *
+ * Deltas are timed relative to the start of the current frame, which EndFrame closes
+ * and makes the samples before it readable.
+ */
+class BlipBuffer
+{
+public:
+    using Sample = std::int16_t;
+
+    static constexpr int kTaps = 16;
+    static constexpr int kPhases = 64;
+
+private:
+    // Fraction of the output Nyquist rate kept, the rest is the window's transition
+    static constexpr double kCutoff = 0.9;
+
+    // Per sample weight of the DC blocking filter, about 10Hz at 48kHz
+    static constexpr float kHighPass = 0.0013f;
+
+    std::array<std::array<float, kTaps>, kPhases + 1> kernel_;
+
+    double samplesPerClock_{0};
+
+    // Output position of the current frame's start, whole samples before it are readable
+    double frameStart_{0};
+    std::size_t available_{0};
+    std::vector<float> deltas_;
+
+    // End of the deltas written so far
+    std::size_t used_{0};
+
+    float integrator_{0};
+    float dc_{0};
+
+    void BuildKernel() noexcept
+    {
+        for (int phase = 0; phase <= kPhases; phase++) {
+            auto offset = double(phase) / kPhases;
+
+            double sum = 0;
+            for (int tap = 0; tap < kTaps; tap++) {
+                // Impulse centered between taps kTaps / 2 - 1 and kTaps / 2, moved by offset
+                auto x = tap - (kTaps / 2 - 1) - offset;
+                auto sinc = x == 0 ? 1.0 : std::sin(std::numbers::pi * kCutoff * x) / (std::numbers::pi * kCutoff * x);
+
+                auto n = (tap - offset + 1) / kTaps;
+                auto window = 0.42 - 0.5 * std::cos(2 * std::numbers::pi * n) + 0.08 * std::cos(4 * std::numbers::pi * n);
+
+                kernel_[phase][tap] = float(sinc * window);
+                sum += kernel_[phase][tap];
+            }
+
+            // Every step must integrate to exactly its delta
+            for (auto& weight : kernel_[phase]) {
+                weight = float(weight / sum);
+            }
+        }
+    }
+
+public:
+    // Holds up to maxSamples unread samples, frames must end before that many are produced
+    BlipBuffer(double clockRate, double sampleRate, std::size_t maxSamples)
+        : deltas_(maxSamples + kTaps + 1, 0.0f)
+    {
+        BuildKernel();
+        SetRates(clockRate, sampleRate);
+    }
+
+    void SetRates(double clockRate, double sampleRate) noexcept
+    {
+        samplesPerClock_ = sampleRate / clockRate;
+    }
+
+    // Output samples the given number of clock cycles produce, rounded down
+    std::size_t SamplesFor(std::uint64_t clocks) const noexcept
+    {
+        return std::size_t(clocks * samplesPerClock_);
+    }
+
+    // The source output changed by delta at clock cycle time of the current frame
+    void AddDelta(std::uint64_t time, int delta) noexcept
+    {
+        auto position = frameStart_ + time * samplesPerClock_;
+        auto sample = std::size_t(position);
+        if (sample + kTaps > deltas_.size()) [[unlikely]] {
+            return;
+        }
+
+        const auto& kernel = kernel_[std::size_t((position - sample) * kPhases + 0.5)];
+        for (int tap = 0; tap < kTaps; tap++) {
+            deltas_[sample + tap] += delta * kernel[tap];
+        }
+        used_ = std::max(used_, sample + kTaps);
+    }
+
+    // Close the current frame after clocks cycles, the next one starts there
+    void EndFrame(std::uint64_t clocks) noexcept
+    {
+        frameStart_ += clocks * samplesPerClock_;
+        available_ = std::min(std::size_t(frameStart_), deltas_.size() - kTaps - 1);
+    }
+
+    std::size_t SamplesAvailable() const noexcept
+    {
+        return available_;
+    }
+
+    // Returns how many samples were read, at most the ones available
+    std::size_t ReadSamples(std::span<Sample> out) noexcept
+    {
+        auto count = std::min(out.size(), available_);
+        for (std::size_t i = 0; i < count; i++) {
+            integrator_ += deltas_[i];
+            auto value = integrator_ - dc_;
+            dc_ += value * kHighPass;
+            out[i] = Sample(std::clamp(value, -32768.0f, 32767.0f));
+        }
+
+        // Impulses still spread past the read samples move down with them
+        auto used = std::max(used_, count);
+        std::copy(deltas_.begin() + count, deltas_.begin() + used, deltas_.begin());
+        std::fill(deltas_.begin() + (used - count), deltas_.begin() + used, 0.0f);
+        used_ = used - count;
+
+        frameStart_ -= count;
+        available_ -= count;
+        return count;
+    }
+
+    void Clear() noexcept
+    {
+        std::fill(deltas_.begin(), deltas_.end(), 0.0f);
+        frameStart_ = 0;
+        available_ = 0;
+        used_ = 0;
+        integrator_ = 0;
+        dc_ = 0;
+    }
+};
+
+}; // namespace emulator::component
@@ -1,4 +1,7 @@
 #include "bus.h"
+#include "log.h"
+
+#include <cstring>
 
 #include <spdlog/spdlog.h>
 
@@ -23,6 +26,9 @@ void Bus::AddComponent(IComponent* component)
 {
     component->AttachToBus(this);
     components_.push_back(component);
+    if (component->IsTickable()) {
+        tickables_.push_back(component);
+    }
 }
 
 void Bus::RemoveComponent(IComponent* component)
@@ -35,14 +41,23 @@ void Bus::RemoveComponent(IComponent* component)
         }
     }
 
+    RemoveWriteObservers(component);
+
     components_.erase(
         std::remove(components_.begin(), components_.end(), component),
         components_.end());
+    tickables_.erase(
+        std::remove(tickables_.begin(), tickables_.end(), component),
+        tickables_.end());
 }
 
 bool Bus::RegisterComponentAddressRange(IComponent* component, std::pair<std::size_t, std::size_t> range) noexcept
 {
     for (const auto& addressable : addressRanges_) {
+        if (addressable.override) {
+            continue;
+        }
+
         // If new address is within an existing address range, return false
         if (range.first >= addressable.start && range.first < addressable.end) {
             return false;
@@ -52,7 +67,7 @@ bool Bus::RegisterComponentAddressRange(IComponent* component, std::pair<std::si
         }
     }
 
-    spdlog::trace("[bus] Registering address range 0x{:X}-0x{:X}", range.first, range.second);
+    EMU_TRACE(Bus, "[bus] Registering address range 0x{:X}-0x{:X}", range.first, range.second);
     addressRanges_.push_back({range.first,
                               range.second,
                               component});
@@ -65,7 +80,7 @@ bool Bus::UpdateComponentAddressRange(IComponent* component, std::pair<std::size
     // Is this double loop the most efficient way to do this, no
     // Is it the most readable, yes
     for (const auto& addressable : addressRanges_) {
-        if (addressable.component == component) {
+        if (addressable.component == component || addressable.override) {
             continue;
         }
 
@@ -79,8 +94,8 @@ bool Bus::UpdateComponentAddressRange(IComponent* component, std::pair<std::size
     }
 
     for (auto& addressable : addressRanges_) {
-        if (addressable.component == component) {
-            spdlog::trace("[bus] Updating address range 0x{:X}-0x{:X} -> 0x{:X}-0x{:X}",
+        if (addressable.component == component && !addressable.override) {
+            EMU_TRACE(Bus, "[bus] Updating address range 0x{:X}-0x{:X} -> 0x{:X}-0x{:X}",
                           addressable.start, addressable.end,
                           range.first, range.second);
 
@@ -92,6 +107,18 @@ bool Bus::UpdateComponentAddressRange(IComponent* component, std::pair<std::size
     return true;
 }
 
+void Bus::AddAddressOverride(IComponent* component, std::pair<std::size_t, std::size_t> range)
+{
+    addressRanges_.insert(addressRanges_.begin(), {range.first, range.second, component, true});
+}
+
+void Bus::RemoveAddressOverrides(IComponent* component) noexcept
+{
+    std::erase_if(addressRanges_, [component](const AddressRange& addressable) {
+        return addressable.override && addressable.component == component;
+    });
+}
+
 void Bus::AddMemoryWatchPoint(MemoryWatchAddress addr) noexcept
 {
     for (const auto& watch : memoryWatchPoints_) {
@@ -119,21 +146,219 @@ void Bus::RegisterMemoryWatchCallback(MemoryWatchCallback callback) noexcept
     memoryWatchCallback_ = callback;
 }
 
+void Bus::SetAccessFaultPolicy(AccessFaultPolicy policy, std::uint8_t openBusValue) noexcept
+{
+    accessFaultPolicy_ = policy;
+    openBusValue_ = openBusValue;
+    loggedFaultAddresses_.clear();
+}
+
+void Bus::RegisterAccessFaultCallback(AccessFaultCallback callback) noexcept
+{
+    accessFaultCallback_ = callback;
+}
+
+std::uint8_t Bus::HandleAccessFault(const AccessFault& fault)
+{
+    accessFaultCount_++;
+    lastAccessFault_ = fault;
+
+    switch (accessFaultPolicy_) {
+    case AccessFaultPolicy::Strict:
+        fault.Throw();
+    case AccessFaultPolicy::LogOnce:
+        if (loggedFaultAddresses_.insert(fault.address).second) {
+            spdlog::warn("[Bus] {} fault {} 0x{:X} ({} bytes), using open bus 0x{:02X}",
+                         fault.reason == AccessFault::Reason::Unmapped   ? "Unmapped"
+                         : fault.reason == AccessFault::Reason::ReadOnly ? "Read-only"
+                                                                         : "Unimplemented",
+                         fault.isWrite ? "writing" : "reading", fault.address, fault.size, openBusValue_);
+        }
+        break;
+    case AccessFaultPolicy::Trap:
+        EMU_WARN_LIMITED(Bus, "[Bus] Trapped {} fault at 0x{:X}", fault.isWrite ? "write" : "read", fault.address);
+        if (accessFaultCallback_) {
+            accessFaultCallback_(this, fault);
+        }
+        break;
+    case AccessFaultPolicy::OpenBus:
+        break;
+    }
+    return openBusValue_;
+}
+
+bool Bus::IsMapped(std::size_t address) const noexcept
+{
+    return FindAddressRange(address) != nullptr;
+}
+
+std::size_t Bus::MappedLength(std::size_t address, std::size_t size) const noexcept
+{
+    std::size_t length = 0;
+    while (length < size) {
+        auto range = FindAddressRange(address + length);
+        if (range == nullptr) {
+            break;
+        }
+        length += std::min<std::size_t>(size - length, range->end - (address + length) + 1);
+    }
+    return length;
+}
+
+std::size_t Bus::UnmappedLength(std::size_t address, std::size_t size) const noexcept
+{
+    for (const auto& addressable : addressRanges_) {
+        if (addressable.start > address && addressable.start - address < size) {
+            size = addressable.start - address;
+        }
+    }
+    return size;
+}
+
+void Bus::NotifyMemoryWatchPoints(std::size_t address, std::size_t size, bool isWrite)
+{
+    for (const auto& watch : memoryWatchPoints_) {
+        if (watch >= address && watch - address < size) {
+            memoryWatchCallback_(this, watch, isWrite);
+        }
+    }
+}
+
+void Bus::ReadBlock(std::size_t address, std::span<std::uint8_t> data)
+{
+    if (!memoryWatchPoints_.empty()) [[unlikely]] {
+        NotifyMemoryWatchPoints(address, data.size(), false);
+    }
+
+    while (!data.empty()) {
+        std::size_t length;
+        if (auto range = FindAddressRange(address)) {
+            length = std::min<std::size_t>(data.size(), range->end - address + 1);
+            range->component->ReadBlock(address, data.first(length));
+        } else {
+            length = UnmappedLength(address, data.size());
+            std::memset(data.data(), HandleAccessFault({address, length, false, AccessFault::Reason::Unmapped}), length);
+        }
+        address += length;
+        data = data.subspan(length);
+    }
+}
+
+void Bus::WriteBlock(std::size_t address, std::span<const std::uint8_t> data)
+{
+    if (!memoryWatchPoints_.empty()) [[unlikely]] {
+        NotifyMemoryWatchPoints(address, data.size(), true);
+    }
+
+    while (!data.empty()) {
+        std::size_t length;
+        if (auto range = FindAddressRange(address)) {
+            length = std::min<std::size_t>(data.size(), range->end - address + 1);
+            range->component->WriteBlock(address, data.first(length));
+            if (!writeObservers_.empty()) [[unlikely]] {
+                NotifyWriteObservers(address, length);
+            }
+        } else {
+            length = UnmappedLength(address, data.size());
+            HandleAccessFault({address, length, true, AccessFault::Reason::Unmapped});
+        }
+        address += length;
+        data = data.subspan(length);
+    }
+}
+
+std::uint8_t IComponent::ReportAccessFault(const AccessFault& fault) const
+{
+    if (bus_ == nullptr) {
+        fault.Throw();
+    }
+    return bus_->HandleAccessFault(fault);
+}
+
+void Bus::AddWriteObserver(IComponent* owner, std::pair<std::size_t, std::size_t> range, WriteObserverCallback callback)
+{
+    writeObservers_.push_back({range.first, range.second, owner, callback});
+}
+
+void Bus::RemoveWriteObservers(IComponent* owner) noexcept
+{
+    writeObservers_.erase(
+        std::remove_if(writeObservers_.begin(), writeObservers_.end(),
+                       [owner](const WriteObserver& observer) { return observer.owner == owner; }),
+        writeObservers_.end());
+}
+
+void Bus::SetTickLoop(TickLoop loop, void* context) noexcept
+{
+    tickLoop_ = loop;
+    tickLoopContext_ = context;
+}
+
 bool Bus::ReceiveTick()
 {
     if (!powered_) [[unlikely]] {
         return false;
     }
 
-    for (auto component : components_) {
-        component->ReceiveTick();
+    if (perfCounters_.SampleTick()) [[unlikely]] {
+        SampledTick();
+    } else if (tickLoop_ != nullptr) {
+        tickLoop_(tickLoopContext_);
+    } else {
+        for (auto component : tickables_) {
+            component->ReceiveTick();
+        }
+    }
+    scheduler_.Tick();
+
+    if (idleSkipRequested_) [[unlikely]] {
+        idleSkipRequested_ = false;
+        SkipIdleCycles();
     }
     return true;
 }
 
+void Bus::SampledTick()
+{
+    for (auto component : tickables_) {
+        auto start = PerfCounters::Clock::now();
+        component->ReceiveTick();
+        perfCounters_.AddTickSample(component, PerfCounters::Clock::now() - start);
+    }
+}
+
+Scheduler::Cycle Bus::SkipIdleCycles()
+{
+    // Never skip past the next scheduled event, it may wake something up
+    auto cycles = scheduler_.NextEventCycle() - scheduler_.Now();
+    for (auto component : tickables_) {
+        cycles = std::min(cycles, component->IdleCycles());
+        if (cycles == 0) {
+            return 0;
+        }
+    }
+
+    // Nothing would ever wake up, keep ticking so the host can still interact
+    if (scheduler_.NextEventCycle() == Scheduler::kNever && cycles >= Scheduler::kNever - scheduler_.Now()) {
+        return 0;
+    }
+
+    for (auto component : tickables_) {
+        component->SkipCycles(cycles);
+    }
+    scheduler_.Advance(cycles);
+    skippedCycles_ += cycles;
+
+    return cycles;
+}
+
 void Bus::PowerOn() noexcept
 {
     powered_ = true;
+    scheduler_.Reset();
+    idleSkipRequested_ = false;
+    skippedCycles_ = 0;
+    perfCounters_.Reset();
     for (auto component : components_) {
         component->PowerOn();
     }
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <iterator>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "accessfault.h"
 #include "component.h"
-#include "exceptions/InvalidAddress.h"
+#include "perfcounters.h"
+#include "scheduler.h"
 
 namespace emulator::component
 {
@@ -17,6 +23,13 @@ class Bus
 {
 private:
     std::vector<IComponent*> components_;
+    std::vector<IComponent*> tickables_;
+
+    Scheduler scheduler_;
+    PerfCounters perfCounters_;
+
+    bool idleSkipRequested_{false};
+    Scheduler::Cycle skippedCycles_{0};
 
     struct AddressRange {
         std::uint64_t start;
@@ -24,6 +37,9 @@ private:
 
         IComponent* component;
 
+        // Served ahead of the regular mapping, see AddAddressOverride
+        bool override{false};
+
         bool operator<(const AddressRange& other) const
         {
             return std::tie(start, end) < std::tie(other.start, other.end);
@@ -40,8 +56,64 @@ private:
     std::vector<MemoryWatchAddress> memoryWatchPoints_;
     MemoryWatchCallback memoryWatchCallback_{nullptr};
 
+    // Notified after writes land in a range, e.g. to drop cached decodes of self-modifying code
+    using WriteObserverCallback = std::function<void(std::size_t address, std::size_t size)>;
+    struct WriteObserver {
+        std::uint64_t start;
+        std::uint64_t end;
+
+        IComponent* owner;
+        WriteObserverCallback callback;
+    };
+    std::vector<WriteObserver> writeObservers_;
+
+    inline void NotifyWriteObservers(std::size_t address, std::size_t size)
+    {
+        for (const auto& observer : writeObservers_) {
+            if (address + size > observer.start && address <= observer.end) {
+                observer.callback(address, size);
+            }
+        }
+    }
+
     std::vector<AddressRange> addressRanges_;
 
+    const AddressRange* FindAddressRange(std::size_t address) const noexcept
+    {
+        for (const auto& addressable : addressRanges_) {
+            if (address >= addressable.start && address <= addressable.end) {
+                return &addressable;
+            }
+        }
+        return nullptr;
+    }
+
+    // Bytes from address, up to size, before the next mapped range
+    std::size_t UnmappedLength(std::size_t address, std::size_t size) const noexcept;
+
+    void NotifyMemoryWatchPoints(std::size_t address, std::size_t size, bool isWrite);
+
+    AccessFaultPolicy accessFaultPolicy_{AccessFaultPolicy::OpenBus};
+    std::uint8_t openBusValue_{0xFF};
+    std::uint64_t accessFaultCount_{0};
+    AccessFault lastAccessFault_;
+    std::unordered_set<std::uint64_t> loggedFaultAddresses_;
+
+    // Called for every fault under AccessFaultPolicy::Trap, e.g. to stop in the debugger
+    using AccessFaultCallback = std::function<void(Bus*, const AccessFault&)>;
+    AccessFaultCallback accessFaultCallback_{nullptr};
+
+    // Tick with each component timed for the perf counters
+    void SampledTick();
+
+public:
+    // Ticks every tickable component in one call, lets a StaticSystem resolve the calls at compile time
+    using TickLoop = void (*)(void* context);
+
+private:
+    TickLoop tickLoop_{nullptr};
+    void* tickLoopContext_{nullptr};
+
     emulator::component::System* system_{nullptr};
 
     bool powered_{false};
@@ -57,15 +129,68 @@ public:
     void BindSystem(System* system) noexcept;
     emulator::component::System* GetBoundSystem() noexcept { return system_; };
 
+    Scheduler& GetScheduler() noexcept { return scheduler_; }
+    const Scheduler& GetScheduler() const noexcept { return scheduler_; }
+    PerfCounters& GetPerfCounters() noexcept { return perfCounters_; }
+    const PerfCounters& GetPerfCounters() const noexcept { return perfCounters_; }
+    const std::vector<IComponent*>& GetTickableComponents() const noexcept { return tickables_; }
+
+    // Ask the bus to skip ahead once the current tick completes (e.g. halted CPU)
+    void RequestIdleSkip() noexcept { idleSkipRequested_ = true; }
+    Scheduler::Cycle SkipIdleCycles();
+    Scheduler::Cycle GetSkippedCycles() const noexcept { return skippedCycles_; }
+
     void AddComponent(IComponent* component);
     void RemoveComponent(IComponent* component);
     bool RegisterComponentAddressRange(IComponent* component, std::pair<size_t, std::size_t> range) noexcept;
     bool UpdateComponentAddressRange(IComponent* component, std::pair<size_t, std::size_t> range) noexcept;
 
+    // Route a range to component ahead of whatever is mapped there, e.g. to lock the bus during DMA
+    void AddAddressOverride(IComponent* component, std::pair<std::size_t, std::size_t> range);
+    void RemoveAddressOverrides(IComponent* component) noexcept;
+
     void AddMemoryWatchPoint(MemoryWatchAddress) noexcept;
     void RemoveMemoryWatchPoint(MemoryWatchAddress) noexcept;
     void RegisterMemoryWatchCallback(MemoryWatchCallback) noexcept;
 
+    // Strict throws on faults, every other policy returns the open bus value for reads
+    void SetAccessFaultPolicy(AccessFaultPolicy policy, std::uint8_t openBusValue = 0xFF) noexcept;
+    AccessFaultPolicy GetAccessFaultPolicy() const noexcept { return accessFaultPolicy_; }
+    void RegisterAccessFaultCallback(AccessFaultCallback) noexcept;
+
+    std::uint64_t GetAccessFaultCount() const noexcept { return accessFaultCount_; }
+    const AccessFault& GetLastAccessFault() const noexcept { return lastAccessFault_; }
+
+    // Apply the fault policy to an access nothing could serve, returns the open bus value
+    [[gnu::cold]] std::uint8_t HandleAccessFault(const AccessFault& fault);
+
+    // Whether any component serves the address, never faults
+    bool IsMapped(std::size_t address) const noexcept;
+
+    // Number of bytes from address, up to size, served by components without a gap
+    std::size_t MappedLength(std::size_t address, std::size_t size) const noexcept;
+
+    // Regular mappings ordered by address, temporary overrides left out
+    std::vector<AddressRange> GetAddressRanges() const
+    {
+        std::vector<AddressRange> ranges;
+        std::copy_if(addressRanges_.begin(), addressRanges_.end(), std::back_inserter(ranges),
+                     [](const AddressRange& range) { return !range.override; });
+        std::sort(ranges.begin(), ranges.end());
+        return ranges;
+    }
+
+    // Bulk transfers split at component boundaries, faults cover whole unmapped gaps
+    void ReadBlock(std::size_t address, std::span<std::uint8_t> data);
+    void WriteBlock(std::size_t address, std::span<const std::uint8_t> data);
+
+    void AddWriteObserver(IComponent* owner, std::pair<std::size_t, std::size_t> range, WriteObserverCallback callback);
+    void RemoveWriteObservers(IComponent* owner) noexcept;
+
+    // Replace the virtual call per tickable component, nullptr restores it
+    void SetTickLoop(TickLoop loop, void* context) noexcept;
+    bool HasTickLoop() const noexcept { return tickLoop_ != nullptr; }
+
     bool ReceiveTick();
 
     void PowerOn() noexcept;
@@ -108,7 +233,7 @@ public:
                 }
             }
         }
-        throw InvalidAddress(address, InvalidAddress::AccessType::READ);
+        return OpenBusValue<T>(HandleAccessFault({address, sizeof(T), false, AccessFault::Reason::Unmapped}));
     }
 
     template <typename T>
@@ -129,31 +254,29 @@ public:
             if (address >= addressable.start && address <= addressable.end) {
                 if constexpr (std::is_same_v<T, uint8_t>) {
                     addressable.component->WriteUInt8(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, int8_t>) {
                     addressable.component->WriteInt8(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, uint16_t>) {
                     addressable.component->WriteUInt16(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, int16_t>) {
                     addressable.component->WriteInt16(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, uint32_t>) {
                     addressable.component->WriteUInt32(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, int32_t>) {
                     addressable.component->WriteInt32(address, value);
-                    return;
                 } else if constexpr (std::is_same_v<T, float>) {
                     addressable.component->WriteFloat(address, value);
-                    return;
                 } else {
                     static_assert(always_false<T>::value, "Unsupported write type on bus");
                 }
+
+                if (!writeObservers_.empty()) [[unlikely]] {
+                    NotifyWriteObservers(address, sizeof(T));
+                }
+                return;
             }
         }
-        throw InvalidAddress(address, InvalidAddress::AccessType::WRITE);
+        HandleAccessFault({address, sizeof(T), true, AccessFault::Reason::Unmapped});
     }
 };
 
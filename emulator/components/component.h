@@ -1,9 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
+#include "accessfault.h"
 #include "exceptions/InvalidAddress.h"
-#include "exceptions/MemoryNoImplementation.h"
+#include "savestate.h"
 
 namespace emulator::component
 {
@@ -47,6 +49,10 @@ protected:
         return address - baseAddress_;
     }
 
+    // Hand an access this component cannot serve to the bus fault policy, returns the open bus value
+    // Throws when the component is not on a bus
+    std::uint8_t ReportAccessFault(const AccessFault& fault) const;
+
 public:
     IComponent(ComponentType type) : IComponent(type, nullptr) {}
     IComponent(ComponentType type, Bus* bus) : type_{type}, bus_(bus) {}
@@ -57,9 +63,42 @@ public:
 
     virtual void ReceiveTick() = 0;
 
+    // Components driven purely by bus accesses or scheduled events can opt out of the per-cycle tick loop
+    virtual bool IsTickable() const noexcept
+    {
+        return true;
+    }
+
+    // Whether bus writes to the component are refused, e.g. cartridge ROM
+    virtual bool IsReadOnly() const noexcept
+    {
+        return false;
+    }
+
+    // Number of upcoming ticks that would not change any state, lets the bus skip ahead while idle
+    virtual std::uint64_t IdleCycles() const noexcept
+    {
+        return 0;
+    }
+
+    // Account for ticks the bus skipped, never more than IdleCycles() reported
+    virtual void SkipCycles(std::uint64_t cycles) noexcept
+    {
+    }
+
     virtual void PowerOn() noexcept = 0;
     virtual void PowerOff() noexcept = 0;
 
+    // Append everything that changes while running, LoadState reads it back in the same order
+    // Components without such state keep the empty defaults
+    virtual void SaveState(StateWriter&) const
+    {
+    }
+
+    virtual void LoadState(StateReader&)
+    {
+    }
+
     virtual void AttachToBus(Bus* bus)
     {
         bus_ = bus;
@@ -79,15 +118,16 @@ public:
     //
 
 #define RW_STR_TYPE_NAME(x) #x
-#define READ_FUNC_DECL(TypeName, type)                                                  \
-    virtual type Read##TypeName(std::size_t address)                                    \
-    {                                                                                   \
-        throw MemoryNoImplementation(true, address, sizeof(type));                      \
+#define READ_FUNC_DECL(TypeName, type)                                            \
+    virtual type Read##TypeName(std::size_t address)                              \
+    {                                                                             \
+        return OpenBusValue<type>(ReportAccessFault(                              \
+            {address, sizeof(type), false, AccessFault::Reason::Unimplemented})); \
     }
-#define WRITE_FUNC_DECL(TypeName, type)                                                  \
-    virtual void Write##TypeName(std::size_t address, type value)                        \
-    {                                                                                    \
-        throw MemoryNoImplementation(false, address, sizeof(type));                      \
+#define WRITE_FUNC_DECL(TypeName, type)                                                       \
+    virtual void Write##TypeName(std::size_t address, type value)                             \
+    {                                                                                         \
+        ReportAccessFault({address, sizeof(type), true, AccessFault::Reason::Unimplemented}); \
     }
 #define READ_WRITE_FUNC_DECL(TypeName, type) \
     READ_FUNC_DECL(TypeName, type)           \
@@ -109,6 +149,22 @@ public:
 #undef WRITE_FUNC_DECL
 #undef READ_WRITE_FUNC_DECL
 
+    // Bulk access to [address, address + data.size()), never crossing out of the component
+    // The default goes through the byte interface, plain memory copies directly
+    virtual void ReadBlock(std::size_t address, std::span<std::uint8_t> data)
+    {
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = ReadUInt8(address + i);
+        }
+    }
+
+    virtual void WriteBlock(std::size_t address, std::span<const std::uint8_t> data)
+    {
+        for (std::size_t i = 0; i < data.size(); i++) {
+            WriteUInt8(address + i, data[i]);
+        }
+    }
+
     //
     // End of Read and Write Interfaces
     //
@@ -1,17 +1,71 @@
 #pragma once
 
 #include "component.h"
-#include "system.h"
+#include "bus.h"
+#include "tracerecorder.h"
 
 #include <functional>
 #include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace emulator::debugger
+{
+class ISystemDebugger;
+}; // namespace emulator::debugger
 
 namespace emulator::component
 {
 
 class CPU : public IComponent
 {
+public:
+    // Cycles the bus skipped on behalf of this CPU
+    struct IdleStats {
+        std::uint64_t haltedCycles{0};
+        std::uint64_t idleLoopCycles{0};
+        std::uint64_t idleLoopsDetected{0};
+    };
+
+    struct RegisterValue {
+        std::string_view name;
+        std::uint64_t value;
+
+        bool operator==(const RegisterValue&) const = default;
+    };
+    using RegisterFile = std::vector<RegisterValue>;
+
+    // Address of the current instruction, bank distinguishes code mapped at the same address
+    struct ProgramLocation {
+        std::uint64_t pc{0};
+        std::uint32_t bank{0};
+    };
+
 protected:
+    IdleStats idleStats_;
+
+    // Instructions started since power on
+    std::uint64_t instructionCount_{0};
+
+    // Only set while debugging, so a detached debugger costs one branch per instruction
+    emulator::debugger::ISystemDebugger* debugger_{nullptr};
+
+    // Set while an instruction trace is being recorded
+    TraceRecorder* traceRecorder_{nullptr};
+    RegisterFile traceRegisters_;
+
+    bool Tracing() const noexcept
+    {
+        return traceRecorder_ != nullptr;
+    }
+
+    // Implementations call this as each instruction starts when Tracing()
+    void TraceInstruction(std::uint64_t pc, std::uint32_t opcode)
+    {
+        GetRegisterFile(traceRegisters_);
+        traceRecorder_->Record(bus_->GetScheduler().Now(), pc, opcode, traceRegisters_);
+    }
+
     System* GetSystem() noexcept
     {
         if (bus_ == nullptr) {
@@ -22,6 +76,57 @@ protected:
 
 public:
     CPU() : IComponent(IComponent::ComponentType::CPU) {}
+
+    void AttachDebugger(emulator::debugger::ISystemDebugger* debugger) noexcept
+    {
+        debugger_ = debugger;
+    }
+
+    const IdleStats& GetIdleStats() const noexcept
+    {
+        return idleStats_;
+    }
+
+    void ResetIdleStats() noexcept
+    {
+        idleStats_ = {};
+    }
+
+    // Implementations call this first from their own SaveState/LoadState
+    void SaveState(StateWriter& state) const override
+    {
+        state.Write(idleStats_);
+        state.Write(instructionCount_);
+    }
+
+    void LoadState(StateReader& state) override
+    {
+        state.Read(idleStats_);
+        state.Read(instructionCount_);
+    }
+
+    // Two execution engines must agree on all state whenever their counts match
+    std::uint64_t GetInstructionCount() const noexcept
+    {
+        return instructionCount_;
+    }
+
+    // Architectural registers, replaces the contents of registers
+    virtual void GetRegisterFile(RegisterFile& registers) const
+    {
+        registers.clear();
+    }
+
+    // Record every instruction started from now on, nullptr stops. Not while the bus is being ticked.
+    void SetTraceRecorder(TraceRecorder* recorder) noexcept
+    {
+        traceRecorder_ = recorder;
+    }
+
+    virtual ProgramLocation GetProgramLocation() const noexcept
+    {
+        return {};
+    }
 };
 
 }; // namespace emulator::component
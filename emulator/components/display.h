@@ -42,6 +42,9 @@ protected:
 
     std::vector<Pixel> pixels_;
 
+    // Frames completed since power on
+    std::uint64_t frameCount_{0};
+
 public:
     Display(std::size_t width, std::size_t height)
         : IComponent(IComponent::ComponentType::Display),
@@ -54,8 +57,14 @@ public:
     {
     }
 
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
     void PowerOn() noexcept override
     {
+        frameCount_ = 0;
     }
 
     void PowerOff() noexcept override
@@ -63,6 +72,29 @@ public:
         std::fill(pixels_.begin(), pixels_.end(), clearColor_);
     }
 
+    void SaveState(StateWriter& state) const override
+    {
+        state.WriteBytes(pixels_.data(), pixels_.size() * sizeof(Pixel));
+        state.Write(frameCount_);
+    }
+
+    void LoadState(StateReader& state) override
+    {
+        state.ReadBytes(pixels_.data(), pixels_.size() * sizeof(Pixel));
+        state.Read(frameCount_);
+    }
+
+    // Called by the system when a full frame has been drawn
+    void CompleteFrame() noexcept
+    {
+        ++frameCount_;
+    }
+
+    std::uint64_t GetFrameCount() const noexcept
+    {
+        return frameCount_;
+    }
+
     std::size_t GetWidth() const noexcept
     {
         return width_;
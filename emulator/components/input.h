@@ -1,124 +1,288 @@
 #pragma once
-#include <functional>
+#include <array>
+#include <memory>
 #include <spdlog/spdlog.h>
-#include <unordered_map>
+#include <stdexcept>
+#include <vector>
 
+#include "bus.h"
 #include "component.h"
+#include "movie.h"
+#include "scheduler.h"
+#include "spscqueue.h"
 
 namespace emulator::component
 {
 
-struct InputKeyHandler {
-    std::function<void()> onPress, onRelease;
-    bool isPressed{false};
-};
-
+/**
+ * Keys pressed on the host, seen by the guest only at frame boundaries.
+ *
+ * Each registered key owns a bit, its slot, of a pressed mask the guest reads with a
+ * single load. Slots follow registration order, so systems register keys in the order
+ * of their own key numbers. Small keycodes find their slot through a table, the rest
+ * by a scan of at most kMaxKeys.
+ *
+ * Press, release and toggle requests may come from any single thread, such as the
+ * UI, and are queued. Whatever reads the keys for the guest calls Poll() first,
+ * which applies the queue at most once per pollInterval cycles. The guest then sees
+ * input change only on its own reads at frame granularity, so a movie of the keys
+ * polled each frame replays a run exactly.
+ *
+ * Polling on reads rather than on a scheduled event keeps idle skipping and
+ * compiled blocks free of a periodic interruption.
+ */
 class Input : public IComponent
 {
 public:
     using InputKeyCode = int;
+    using KeyMask = Movie::KeyMask;
+
+    static constexpr std::size_t kMaxKeys = sizeof(KeyMask) * 8;
+    static constexpr std::size_t kQueueSize = 256;
+    static constexpr std::size_t kNoSlot = kMaxKeys;
 
 protected:
-    std::unordered_map<InputKeyCode, InputKeyHandler> inputs_;
+    // Keycode of each slot
+    std::vector<InputKeyCode> keys_;
+
+    static constexpr std::size_t kDenseKeyCodes = 256;
+    std::array<std::uint8_t, kDenseKeyCodes> denseSlots_;
+
+    enum class KeyAction : std::uint8_t {
+        Press,
+        Release,
+        Toggle,
+    };
+    struct KeyEvent {
+        InputKeyCode key;
+        KeyAction action;
+    };
+    SPSCQueue<KeyEvent, kQueueSize> events_;
+
+    Scheduler::Cycle pollInterval_;
+
+    // Earliest frame, in poll intervals since power on, the next poll applies input at
+    std::uint64_t nextFrame_{0};
+    KeyMask pressed_{0};
+
+    enum class MovieMode {
+        None,
+        Recording,
+        Playing,
+    } movieMode_{MovieMode::None};
+    std::unique_ptr<Movie> movie_;
+    std::size_t movieCursor_{0};
+
+    void Apply(const KeyEvent& event) noexcept
+    {
+        auto slot = GetSlot(event.key);
+        if (slot == kNoSlot) {
+            return;
+        }
 
-    std::function<void(InputKeyCode)> onKeyPress_{nullptr}, onKeyRelease_{nullptr};
+        auto bit = KeyMask(1) << slot;
+        switch (event.action) {
+        case KeyAction::Press:
+            pressed_ |= bit;
+            break;
+        case KeyAction::Release:
+            pressed_ &= ~bit;
+            break;
+        case KeyAction::Toggle:
+            pressed_ ^= bit;
+            break;
+        }
+    }
+
+    void Queue(InputKeyCode key, KeyAction action)
+    {
+        if (!events_.TryPush({key, action})) {
+            spdlog::warn("[Input] Dropped key {}, more than {} events waiting for the next poll", key, kQueueSize);
+        }
+    }
 
 public:
-    Input() : IComponent(ComponentType::Input)
+    // Guest sees key changes every pollInterval cycles, e.g. once per frame
+    explicit Input(Scheduler::Cycle pollInterval = 1)
+        : IComponent(ComponentType::Input), pollInterval_(pollInterval == 0 ? 1 : pollInterval)
     {
+        denseSlots_.fill(static_cast<std::uint8_t>(kNoSlot));
     }
 
     void ReceiveTick() override
     {
     }
 
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
     void PowerOn() noexcept override
     {
+        pressed_ = 0;
+        nextFrame_ = 0;
+        movieCursor_ = 0;
+        if (movieMode_ == MovieMode::Recording) {
+            movie_->Clear();
+        }
     }
 
     void PowerOff() noexcept override
     {
     }
 
-    struct InputKeyHandler& RegisterKey(InputKeyCode key)
+    void SaveState(StateWriter& state) const override
     {
-        if (inputs_.find(key) == inputs_.end()) {
-            inputs_[key] = {nullptr, nullptr};
-        }
-        return inputs_[key];
+        state.Write(nextFrame_);
+        state.Write(pressed_);
+        state.Write(movieCursor_);
     }
 
-    void SetKeyPressHandlers(std::function<void(InputKeyCode)> onPress, std::function<void(InputKeyCode)> onRelease)
+    void LoadState(StateReader& state) override
     {
-        onKeyPress_ = onPress;
-        onKeyRelease_ = onRelease;
+        state.Read(nextFrame_);
+        state.Read(pressed_);
+        state.Read(movieCursor_);
     }
 
-    void PressKey(InputKeyCode key)
+    // Returns the slot of key, throws std::length_error once more keys are registered than fit in a KeyMask
+    std::size_t RegisterKey(InputKeyCode key)
     {
-        if (inputs_.find(key) == inputs_.end()) {
-            return;
+        auto slot = GetSlot(key);
+        if (slot != kNoSlot) {
+            return slot;
         }
-        auto& handler = inputs_[key];
 
-        // Don't signal onPress if key is already pressed
-        if (handler.isPressed) {
-            return;
+        if (keys_.size() == kMaxKeys) {
+            throw std::length_error("Input supports at most 64 keys");
         }
-
-        handler.isPressed = true;
-        if (handler.onPress) {
-            handler.onPress();
+        slot = keys_.size();
+        keys_.push_back(key);
+        if (key >= 0 && key < static_cast<InputKeyCode>(kDenseKeyCodes)) {
+            denseSlots_[key] = static_cast<std::uint8_t>(slot);
         }
+        return slot;
+    }
 
-        if (onKeyPress_) {
-            onKeyPress_(key);
+    // kNoSlot if key was never registered
+    std::size_t GetSlot(InputKeyCode key) const noexcept
+    {
+        if (key >= 0 && key < static_cast<InputKeyCode>(kDenseKeyCodes)) {
+            return denseSlots_[key];
         }
+        for (std::size_t slot = 0; slot < keys_.size(); slot++) {
+            if (keys_[slot] == key) {
+                return slot;
+            }
+        }
+        return kNoSlot;
+    }
+
+    // Queued for the next frame that is polled, only ever call these from one thread
+    void PressKey(InputKeyCode key)
+    {
+        Queue(key, KeyAction::Press);
     }
 
     void ReleaseKey(InputKeyCode key)
     {
-        if (inputs_.find(key) == inputs_.end()) {
+        Queue(key, KeyAction::Release);
+    }
+
+    void ToggleKey(InputKeyCode key)
+    {
+        Queue(key, KeyAction::Toggle);
+    }
+
+    // On the emulation thread before reading keys for the guest, applies what is queued
+    // or the movie being played once per frame, and records the result
+    void Poll()
+    {
+        auto frame = bus_ == nullptr ? nextFrame_ : bus_->GetScheduler().Now() / pollInterval_;
+        if (frame < nextFrame_) [[likely]] {
             return;
         }
-        auto& handler = inputs_[key];
+        nextFrame_ = frame + 1;
+
+        if (movieMode_ == MovieMode::Playing) {
+            // Live input is ignored while a movie plays
+            events_.Clear();
 
-        // Don't signal onRelease if key is already released
-        if (!handler.isPressed) {
+            const auto& changes = movie_->GetChanges();
+            while (movieCursor_ < changes.size() && changes[movieCursor_].frame <= frame) {
+                pressed_ = changes[movieCursor_++].pressed;
+            }
             return;
         }
 
-        handler.isPressed = false;
-        if (handler.onRelease) {
-            handler.onRelease();
+        KeyEvent event;
+        while (events_.TryPop(event)) {
+            Apply(event);
         }
-
-        if (onKeyRelease_) {
-            onKeyRelease_(key);
+        if (movieMode_ == MovieMode::Recording) {
+            movie_->Record(frame, pressed_);
         }
     }
 
-    void ToggleKey(InputKeyCode key)
+    // Bit slot of the mask is set while that key is pressed
+    KeyMask GetPressed() const noexcept
     {
-        if (inputs_.find(key) == inputs_.end()) {
-            return;
-        }
-        auto& handler = inputs_[key];
-
-        handler.isPressed = !handler.isPressed;
-        if (handler.isPressed && handler.onPress) {
-            handler.onPress();
-        } else if (!handler.isPressed && handler.onRelease) {
-            handler.onRelease();
-        }
+        return pressed_;
     }
 
     bool IsPressed(InputKeyCode key) const noexcept
     {
-        if (inputs_.find(key) == inputs_.end()) {
-            return false;
+        auto slot = GetSlot(key);
+        return slot != kNoSlot && ((pressed_ >> slot) & 1) != 0;
+    }
+
+    const std::vector<InputKeyCode>& GetKeys() const noexcept
+    {
+        return keys_;
+    }
+
+    Scheduler::Cycle GetPollInterval() const noexcept
+    {
+        return pollInterval_;
+    }
+
+    //
+    // Movies start from power on, so these are called while Run is not executing
+    //
+
+    void RecordMovie()
+    {
+        movie_ = std::make_unique<Movie>(pollInterval_, keys_);
+        movieMode_ = MovieMode::Recording;
+    }
+
+    // Throws std::invalid_argument if the movie was recorded with other keys or poll interval
+    void PlayMovie(Movie movie)
+    {
+        if (!movie.Matches(pollInterval_, keys_)) {
+            throw std::invalid_argument("Movie was recorded for different input");
         }
-        return inputs_.at(key).isPressed;
+        movie_ = std::make_unique<Movie>(std::move(movie));
+        movieCursor_ = 0;
+        movieMode_ = MovieMode::Playing;
+    }
+
+    // Returns the movie recorded or played, if any
+    std::unique_ptr<Movie> StopMovie() noexcept
+    {
+        movieMode_ = MovieMode::None;
+        return std::move(movie_);
+    }
+
+    bool RecordingMovie() const noexcept
+    {
+        return movieMode_ == MovieMode::Recording;
+    }
+
+    bool PlayingMovie() const noexcept
+    {
+        return movieMode_ == MovieMode::Playing;
     }
 };
 
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <format>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "cpu.h"
+#include "system.h"
+
+namespace emulator::component
+{
+
+/**
+ * Runs a reference and a candidate system side by side and reports the first point they disagree.
+ *
+ * Both systems are ticked until their CPUs have started the same number of instructions, then
+ * the register files and a hash of the configured memory ranges are compared. An engine that runs
+ * several instructions in one tick is compared at the next count both systems land on.
+ */
+class Lockstep
+{
+public:
+    struct Options {
+        // Inclusive address ranges to compare, read through the bus so must be free of read side effects
+        std::vector<std::pair<std::size_t, std::size_t>> memoryRanges;
+
+        // Memory is compared every N instructions, registers on every instruction
+        std::uint64_t memoryInterval{1};
+
+        // Instructions of history kept per system for the report
+        std::size_t traceWindow{16};
+
+        // A system that goes this many ticks without starting an instruction has stalled
+        std::uint64_t maxTicksPerInstruction{1 << 20};
+
+        // Engines that run several instructions per tick reach a count early, skip the timing check for them
+        bool compareCycles{true};
+    };
+
+    struct TraceEntry {
+        std::uint64_t instruction;
+        std::uint64_t cycle;
+        CPU::RegisterFile registers;
+    };
+
+    struct Divergence {
+        std::uint64_t instruction;
+        std::string reason;
+
+        std::deque<TraceEntry> referenceTrace;
+        std::deque<TraceEntry> candidateTrace;
+
+        std::string Describe() const
+        {
+            auto out = std::format("Diverged at instruction {}: {}\n", instruction, reason);
+            for (auto [name, trace] : {std::pair{"Reference", &referenceTrace}, std::pair{"Candidate", &candidateTrace}}) {
+                out += std::format("{} trace:\n", name);
+                for (auto& entry : *trace) {
+                    out += std::format("  #{} @ {}:", entry.instruction, entry.cycle);
+                    for (auto& reg : entry.registers) {
+                        out += std::format(" {}={:X}", reg.name, reg.value);
+                    }
+                    out += "\n";
+                }
+            }
+            return out;
+        }
+    };
+
+private:
+    struct Side {
+        const char* name;
+        System* system;
+        CPU* cpu;
+        std::deque<TraceEntry> trace;
+    };
+
+    Side reference_;
+    Side candidate_;
+    Options options_;
+
+    std::uint64_t compared_{0};
+    std::uint64_t lastMemoryCompare_{0};
+
+    static CPU* FindCPU(System& system)
+    {
+        auto cpu = system.GetFirstComponentByType<CPU>(IComponent::ComponentType::CPU);
+        if (cpu == nullptr) {
+            throw std::invalid_argument(std::format("System {} has no CPU", system.Name()));
+        }
+        return cpu;
+    }
+
+    void Record(Side& side)
+    {
+        TraceEntry entry{side.cpu->GetInstructionCount(), side.system->GetBus().GetScheduler().Now(), {}};
+        side.cpu->GetRegisterFile(entry.registers);
+
+        side.trace.push_back(std::move(entry));
+        while (side.trace.size() > std::max<std::size_t>(options_.traceWindow, 1)) {
+            side.trace.pop_front();
+        }
+    }
+
+    // Tick until the CPU has started at least target instructions, returns why it could not
+    std::optional<std::string> Advance(Side& side, std::uint64_t target)
+    {
+        auto& bus = side.system->GetBus();
+        std::uint64_t ticks = 0;
+        while (side.cpu->GetInstructionCount() < target) {
+            auto count = side.cpu->GetInstructionCount();
+            try {
+                if (!bus.ReceiveTick()) {
+                    return std::format("{} is powered off", side.name);
+                }
+            } catch (const std::exception& e) {
+                return std::format("{} threw: {}", side.name, e.what());
+            }
+
+            if (side.cpu->GetInstructionCount() != count) {
+                Record(side);
+                ticks = 0;
+            } else if (++ticks >= options_.maxTicksPerInstruction) {
+                return std::format("{} stalled for {} ticks", side.name, ticks);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string> CompareRegisters() const
+    {
+        auto& reference = reference_.trace.back().registers;
+        auto& candidate = candidate_.trace.back().registers;
+        if (reference.size() != candidate.size()) {
+            return std::format("Register files differ in size: {} vs {}", reference.size(), candidate.size());
+        }
+
+        for (std::size_t i = 0; i < reference.size(); i++) {
+            if (reference[i] != candidate[i]) {
+                return std::format("Register {}: reference 0x{:X}, candidate 0x{:X}",
+                                   reference[i].name, reference[i].value, candidate[i].value);
+            }
+        }
+
+        // Same number of instructions must take the same time
+        if (options_.compareCycles && reference_.trace.back().cycle != candidate_.trace.back().cycle) {
+            return std::format("Cycle: reference {}, candidate {}", reference_.trace.back().cycle, candidate_.trace.back().cycle);
+        }
+        return std::nullopt;
+    }
+
+    static std::uint64_t HashMemory(Bus& bus, std::pair<std::size_t, std::size_t> range)
+    {
+        // FNV-1a
+        std::uint64_t hash = 0xCBF29CE484222325;
+        for (auto address = range.first; address <= range.second; address++) {
+            hash = (hash ^ bus.Read<std::uint8_t>(address)) * 0x100000001B3;
+        }
+        return hash;
+    }
+
+    std::optional<std::string> CompareMemory() const
+    {
+        auto& reference = reference_.system->GetBus();
+        auto& candidate = candidate_.system->GetBus();
+        for (auto& range : options_.memoryRanges) {
+            if (HashMemory(reference, range) == HashMemory(candidate, range)) {
+                continue;
+            }
+
+            for (auto address = range.first; address <= range.second; address++) {
+                auto a = reference.Read<std::uint8_t>(address);
+                auto b = candidate.Read<std::uint8_t>(address);
+                if (a != b) {
+                    return std::format("Memory 0x{:04X}: reference 0x{:02X}, candidate 0x{:02X}", address, a, b);
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    Divergence Diverged(std::uint64_t instruction, std::string reason) const
+    {
+        spdlog::error("[Lockstep] Diverged at instruction {}: {}", instruction, reason);
+        return {instruction, std::move(reason), reference_.trace, candidate_.trace};
+    }
+
+public:
+    Lockstep(System& reference, System& candidate) : Lockstep(reference, candidate, Options()) {}
+    Lockstep(System& reference, System& candidate, Options options)
+        : reference_{"Reference", &reference, FindCPU(reference), {}},
+          candidate_{"Candidate", &candidate, FindCPU(candidate), {}},
+          options_(std::move(options))
+    {
+        compared_ = std::min(reference_.cpu->GetInstructionCount(), candidate_.cpu->GetInstructionCount());
+        lastMemoryCompare_ = compared_;
+    }
+
+    // Instruction count both systems last agreed on
+    std::uint64_t InstructionsCompared() const noexcept
+    {
+        return compared_;
+    }
+
+    // Run both systems for up to instructions more instructions, stopping at the first divergence
+    std::optional<Divergence> Run(std::uint64_t instructions)
+    {
+        auto end = compared_ + instructions;
+        auto target = compared_ + 1;
+        while (compared_ < end) {
+            for (auto side : {&reference_, &candidate_}) {
+                if (auto error = Advance(*side, target)) {
+                    return Diverged(compared_ + 1, *error);
+                }
+            }
+
+            // One side ran ahead, catch the other up before comparing
+            auto referenceCount = reference_.cpu->GetInstructionCount();
+            auto candidateCount = candidate_.cpu->GetInstructionCount();
+            if (referenceCount != candidateCount) {
+                target = std::max(referenceCount, candidateCount);
+                continue;
+            }
+
+            if (auto error = CompareRegisters()) {
+                return Diverged(referenceCount, *error);
+            }
+            if (referenceCount - lastMemoryCompare_ >= options_.memoryInterval || referenceCount >= end) {
+                lastMemoryCompare_ = referenceCount;
+                if (auto error = CompareMemory()) {
+                    return Diverged(referenceCount, *error);
+                }
+            }
+
+            compared_ = referenceCount;
+            target = compared_ + 1;
+        }
+        return std::nullopt;
+    }
+};
+
+}; // namespace emulator::component
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+/**
+ * Emulator logging macros.
+ *
+ * EMU_TRACE(Subsystem, fmt, ...) through EMU_ERROR compile to nothing when
+ * their level is below EMULATOR_LOG_LEVEL, so arguments are not even
+ * evaluated. Release builds (NDEBUG) default to keeping info and above.
+ * What remains is filtered at runtime per subsystem before any formatting.
+ *
+ * The _LIMITED variants drop repeats from the same call site beyond a few
+ * per second, for warnings on paths the guest can hit every cycle.
+ */
+#ifndef EMULATOR_LOG_LEVEL
+#ifdef NDEBUG
+#define EMULATOR_LOG_LEVEL SPDLOG_LEVEL_INFO
+#else
+#define EMULATOR_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+#endif
+
+namespace emulator::log
+{
+
+enum class Subsystem : std::uint8_t {
+    Bus,
+    CPU,
+    PPU,
+    Debugger,
+};
+
+static constexpr std::array<std::string_view, 4> kSubsystemNames = {"bus", "cpu", "ppu", "debugger"};
+
+// Below the global spdlog level nothing is logged regardless
+inline std::array<std::atomic<int>, kSubsystemNames.size()> subsystemLevels = {};
+
+inline void SetLevel(Subsystem subsystem, spdlog::level::level_enum level) noexcept
+{
+    subsystemLevels[std::size_t(subsystem)].store(level, std::memory_order_relaxed);
+}
+
+inline spdlog::level::level_enum GetLevel(Subsystem subsystem) noexcept
+{
+    return spdlog::level::level_enum(subsystemLevels[std::size_t(subsystem)].load(std::memory_order_relaxed));
+}
+
+inline bool Enabled(Subsystem subsystem, spdlog::level::level_enum level) noexcept
+{
+    return level >= subsystemLevels[std::size_t(subsystem)].load(std::memory_order_relaxed) && spdlog::should_log(level);
+}
+
+// Apply a list such as "bus=off,cpu=debug", returns false if any entry was not understood
+inline bool Configure(std::string_view config)
+{
+    bool ok = true;
+    while (!config.empty()) {
+        auto end = config.find(',');
+        auto entry = config.substr(0, end);
+        config = end == std::string_view::npos ? std::string_view() : config.substr(end + 1);
+
+        auto equals = entry.find('=');
+        if (equals == std::string_view::npos) {
+            ok = false;
+            continue;
+        }
+
+        auto name = entry.substr(0, equals);
+        auto level = spdlog::level::from_str(std::string(entry.substr(equals + 1)));
+
+        bool found = false;
+        for (std::size_t i = 0; i < kSubsystemNames.size(); i++) {
+            if (kSubsystemNames[i] == name) {
+                SetLevel(Subsystem(i), level);
+                found = true;
+            }
+        }
+        ok &= found;
+    }
+    return ok;
+}
+
+/**
+ * Allows a burst of messages per window, counting the ones it drops.
+ */
+class RateLimiter
+{
+public:
+    static constexpr std::uint32_t kMessagesPerWindow = 5;
+    static constexpr std::chrono::seconds kWindow{1};
+
+private:
+    std::atomic<std::int64_t> windowStart_{0};
+    std::atomic<std::uint32_t> messages_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+
+public:
+    // Whether to log this message, suppressed is set to how many were dropped before it
+    bool Allow(std::uint64_t& suppressed) noexcept
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto window = std::chrono::duration_cast<std::chrono::steady_clock::duration>(kWindow).count();
+        if (now - windowStart_.load(std::memory_order_relaxed) >= window) {
+            windowStart_.store(now, std::memory_order_relaxed);
+            messages_.store(0, std::memory_order_relaxed);
+        }
+
+        if (messages_.fetch_add(1, std::memory_order_relaxed) >= kMessagesPerWindow) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+}; // namespace emulator::log
+
+#define EMU_LOG_ENABLED(subsystem, severity)          \
+    (SPDLOG_LEVEL_##severity >= EMULATOR_LOG_LEVEL && \
+     ::emulator::log::Enabled(::emulator::log::Subsystem::subsystem, ::spdlog::level::level_enum(SPDLOG_LEVEL_##severity)))
+
+#define EMU_LOG(subsystem, severity, ...)                                                     \
+    do {                                                                                      \
+        if (EMU_LOG_ENABLED(subsystem, severity)) {                                           \
+            ::spdlog::log(::spdlog::level::level_enum(SPDLOG_LEVEL_##severity), __VA_ARGS__); \
+        }                                                                                     \
+    } while (0)
+
+#define EMU_LOG_LIMITED(subsystem, severity, ...)                                             \
+    do {                                                                                      \
+        static ::emulator::log::RateLimiter emuLogLimiter;                                    \
+        std::uint64_t emuLogSuppressed = 0;                                                   \
+        if (EMU_LOG_ENABLED(subsystem, severity) && emuLogLimiter.Allow(emuLogSuppressed)) {  \
+            if (emuLogSuppressed != 0) {                                                      \
+                ::spdlog::log(::spdlog::level::level_enum(SPDLOG_LEVEL_##severity),           \
+                              "({} similar messages suppressed)", emuLogSuppressed);          \
+            }                                                                                 \
+            ::spdlog::log(::spdlog::level::level_enum(SPDLOG_LEVEL_##severity), __VA_ARGS__); \
+        }                                                                                     \
+    } while (0)
+
+#if EMULATOR_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+#define EMU_TRACE(subsystem, ...) EMU_LOG(subsystem, TRACE, __VA_ARGS__)
+#else
+#define EMU_TRACE(subsystem, ...) ((void)0)
+#endif
+
+#if EMULATOR_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define EMU_DEBUG(subsystem, ...) EMU_LOG(subsystem, DEBUG, __VA_ARGS__)
+#else
+#define EMU_DEBUG(subsystem, ...) ((void)0)
+#endif
+
+#if EMULATOR_LOG_LEVEL <= SPDLOG_LEVEL_INFO
+#define EMU_INFO(subsystem, ...) EMU_LOG(subsystem, INFO, __VA_ARGS__)
+#else
+#define EMU_INFO(subsystem, ...) ((void)0)
+#endif
+
+#if EMULATOR_LOG_LEVEL <= SPDLOG_LEVEL_WARN
+#define EMU_WARN(subsystem, ...) EMU_LOG(subsystem, WARN, __VA_ARGS__)
+#define EMU_WARN_LIMITED(subsystem, ...) EMU_LOG_LIMITED(subsystem, WARN, __VA_ARGS__)
+#else
+#define EMU_WARN(subsystem, ...) ((void)0)
+#define EMU_WARN_LIMITED(subsystem, ...) ((void)0)
+#endif
+
+#if EMULATOR_LOG_LEVEL <= SPDLOG_LEVEL_ERROR
+#define EMU_ERROR(subsystem, ...) EMU_LOG(subsystem, ERROR, __VA_ARGS__)
+#define EMU_ERROR_LIMITED(subsystem, ...) EMU_LOG_LIMITED(subsystem, ERROR, __VA_ARGS__)
+#else
+#define EMU_ERROR(subsystem, ...) ((void)0)
+#define EMU_ERROR_LIMITED(subsystem, ...) ((void)0)
+#endif
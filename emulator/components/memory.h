@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <span>
 #include <vector>
 
 #include "bus.h"
@@ -39,6 +40,14 @@ protected:
     bool silentException_;
     std::vector<std::uint8_t> memory_;
 
+    std::size_t ValidateAndNormalizeBlock(std::size_t address, std::size_t size)
+    {
+        if (address < baseAddress_ || address + size > boundAddress_ || address + size < address) {
+            throw InvalidAddress(address);
+        }
+        return address - baseAddress_;
+    }
+
 public:
     Memory(std::size_t size) : Memory(0, size) {}
     Memory(std::size_t baseAddress, size_t size, bool silentException = false)
@@ -157,6 +166,16 @@ public:
 
     void ReceiveTick() override {};
 
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
+    bool IsReadOnly() const noexcept override
+    {
+        return mtype == MemoryType::ReadOnly;
+    }
+
     void PowerOn() noexcept override {};
     void PowerOff() noexcept override
     {
@@ -164,10 +183,27 @@ public:
         contexts_.clear();
     };
 
+    // Read only contents only change when something is loaded, so they are left out
+    void SaveState(StateWriter& state) const override
+    {
+        if constexpr (mtype == MemoryType::ReadWrite) {
+            state.WriteBytes(memory_.data(), memory_.size());
+        }
+    }
+
+    void LoadState(StateReader& state) override
+    {
+        if constexpr (mtype == MemoryType::ReadWrite) {
+            state.ReadBytes(memory_.data(), memory_.size());
+        }
+    }
+
     void WriteUInt8(std::size_t address, std::uint8_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::uint8_t>(address);
             memory_[normalizedAddress] = value;
@@ -177,7 +213,9 @@ public:
     void WriteInt8(std::size_t address, std::int8_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::int8_t>(address);
             memory_[normalizedAddress] = value;
@@ -187,7 +225,9 @@ public:
     void WriteUInt16(std::size_t address, std::uint16_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::uint16_t>(address);
             memory_[normalizedAddress] = value & 0xFF;
@@ -198,7 +238,9 @@ public:
     void WriteInt16(std::size_t address, std::int16_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::int16_t>(address);
             memory_[normalizedAddress] = value & 0xFF;
@@ -209,7 +251,9 @@ public:
     void WriteUInt32(std::size_t address, std::uint32_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::uint32_t>(address);
             memory_[normalizedAddress] = value & 0xFF;
@@ -222,7 +266,9 @@ public:
     void WriteInt32(std::size_t address, std::int32_t value) override
     {
         if constexpr (mtype == MemoryType::ReadOnly) {
-            if (!silentException_) throw MemoryReadOnlyViolation(address, sizeof(value));
+            if (!silentException_) {
+                ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::ReadOnly});
+            }
         } else {
             auto normalizedAddress = ValidateAndNormalizeAddress<std::int32_t>(address);
             memory_[normalizedAddress] = value & 0xFF;
@@ -232,6 +278,24 @@ public:
         }
     }
 
+    void WriteBlock(std::size_t address, std::span<const std::uint8_t> data) override
+    {
+        if constexpr (mtype == MemoryType::ReadOnly) {
+            if (!silentException_) {
+                ReportAccessFault({address, data.size(), true, AccessFault::Reason::ReadOnly});
+            }
+        } else {
+            auto normalizedAddress = ValidateAndNormalizeBlock(address, data.size());
+            std::memcpy(memory_.data() + normalizedAddress, data.data(), data.size());
+        }
+    }
+
+    void ReadBlock(std::size_t address, std::span<std::uint8_t> data) override
+    {
+        auto normalizedAddress = ValidateAndNormalizeBlock(address, data.size());
+        std::memcpy(data.data(), memory_.data() + normalizedAddress, data.size());
+    }
+
     std::uint8_t ReadUInt8(std::size_t address) override
     {
         auto normalizedAddress = ValidateAndNormalizeAddress<std::uint8_t>(address);
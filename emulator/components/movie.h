@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tracerecorder.h"
+
+namespace emulator::component
+{
+
+/**
+ * Input recorded as the keys pressed at each polled frame, for replaying a run exactly.
+ *
+ * Frames are poll intervals since power on. Only changes are kept, encoded after a
+ * header of the poll interval and the recorded keycodes as LEB128 varints:
+ *
+ *   frame delta, pressed mask XOR the previous mask (bit i is keycode i)
+ */
+class Movie
+{
+public:
+    static constexpr char kMagic[8] = {'E', 'M', 'U', 'M', 'O', 'V', 'I', 'E'};
+    static constexpr std::uint8_t kVersion = 1;
+
+    using KeyMask = std::uint64_t;
+
+    struct Change {
+        std::uint64_t frame;
+        KeyMask pressed;
+
+        bool operator==(const Change&) const = default;
+    };
+
+private:
+    std::uint64_t pollInterval_{0};
+    std::vector<int> keys_;
+    std::vector<Change> changes_;
+
+    static void PutVarint(std::ostream& out, std::uint64_t value)
+    {
+        std::uint8_t buffer[10];
+        auto end = trace::PutVarint(buffer, value);
+        out.write(reinterpret_cast<const char*>(buffer), end - buffer);
+    }
+
+    // False at the end of the stream, throws if it ends mid value
+    static bool GetVarint(std::istream& in, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = in.get();
+            if (byte == std::istream::traits_type::eof()) {
+                if (shift != 0) {
+                    throw std::runtime_error("Movie ends mid record");
+                }
+                return false;
+            }
+            value |= std::uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        throw std::runtime_error("Malformed varint in movie");
+    }
+
+    static std::uint64_t GetField(std::istream& in)
+    {
+        std::uint64_t value;
+        if (!GetVarint(in, value)) {
+            throw std::runtime_error("Truncated movie");
+        }
+        return value;
+    }
+
+public:
+    Movie(std::uint64_t pollInterval, std::vector<int> keys)
+        : pollInterval_(pollInterval), keys_(std::move(keys))
+    {
+    }
+
+    std::uint64_t GetPollInterval() const noexcept
+    {
+        return pollInterval_;
+    }
+
+    const std::vector<int>& GetKeys() const noexcept
+    {
+        return keys_;
+    }
+
+    const std::vector<Change>& GetChanges() const noexcept
+    {
+        return changes_;
+    }
+
+    // Whether a movie can drive an input with these keys, polled this often
+    bool Matches(std::uint64_t pollInterval, const std::vector<int>& keys) const noexcept
+    {
+        return pollInterval_ == pollInterval && keys_ == keys;
+    }
+
+    // Note the keys pressed at frame, kept only if they differ from the last change
+    void Record(std::uint64_t frame, KeyMask pressed)
+    {
+        auto last = changes_.empty() ? 0 : changes_.back().pressed;
+        if (pressed != last) {
+            changes_.push_back({frame, pressed});
+        }
+    }
+
+    void Clear() noexcept
+    {
+        changes_.clear();
+    }
+
+    void Save(std::ostream& out) const
+    {
+        out.write(kMagic, sizeof(kMagic));
+        out.put(static_cast<char>(kVersion));
+
+        PutVarint(out, pollInterval_);
+        PutVarint(out, keys_.size());
+        for (auto key : keys_) {
+            PutVarint(out, trace::ZigZag(static_cast<std::uint64_t>(static_cast<std::int64_t>(key))));
+        }
+
+        Change last{0, 0};
+        for (const auto& change : changes_) {
+            PutVarint(out, change.frame - last.frame);
+            PutVarint(out, change.pressed ^ last.pressed);
+            last = change;
+        }
+
+        if (!out) {
+            throw std::runtime_error("Failed writing movie");
+        }
+    }
+
+    // Throws std::runtime_error if in does not hold a movie
+    static Movie Load(std::istream& in)
+    {
+        char magic[sizeof(kMagic)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a movie file");
+        }
+
+        auto version = in.get();
+        if (version != kVersion) {
+            throw std::runtime_error("Unsupported movie version " + std::to_string(version));
+        }
+
+        auto pollInterval = GetField(in);
+        auto count = GetField(in);
+        if (count > 64) {
+            throw std::runtime_error("Movie records more keys than fit in a mask");
+        }
+
+        std::vector<int> keys;
+        for (std::uint64_t i = 0; i < count; i++) {
+            keys.push_back(static_cast<int>(static_cast<std::int64_t>(trace::UnZigZag(GetField(in)))));
+        }
+
+        Movie movie(pollInterval, std::move(keys));
+        Change last{0, 0};
+        std::uint64_t delta;
+        while (GetVarint(in, delta)) {
+            last.frame += delta;
+            last.pressed ^= GetField(in);
+            movie.changes_.push_back(last);
+        }
+        return movie;
+    }
+};
+
+}; // namespace emulator::component
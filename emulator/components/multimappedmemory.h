@@ -54,7 +54,8 @@ public:
     void WriteInt8(std::size_t address, std::int8_t value) override
     {
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteInt8(NormalizeToBaseAddress(address), value);
     }
@@ -62,7 +63,8 @@ public:
     void WriteUInt8(std::size_t address, std::uint8_t value) override
     {
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteUInt8(NormalizeToBaseAddress(address), value);
     }
@@ -70,7 +72,8 @@ public:
     void WriteInt16(std::size_t address, std::int16_t value) override
     {
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteInt16(NormalizeToBaseAddress(address), value);
     }
@@ -78,7 +81,8 @@ public:
     void WriteUInt16(std::size_t address, std::uint16_t value) override
     {
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteUInt16(NormalizeToBaseAddress(address), value);
     }
@@ -87,7 +91,8 @@ public:
     {
         // Validate in one of our address ranges
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteInt32(NormalizeToBaseAddress(address), value);
     }
@@ -95,7 +100,8 @@ public:
     void WriteUInt32(std::size_t address, std::uint32_t value) override
     {
         if (!InMemoryRange(address, sizeof(value))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::WRITE, "Not in range of multi-mapped memory.");
+            this->ReportAccessFault({address, sizeof(value), true, AccessFault::Reason::Unmapped});
+            return;
         }
         Memory<mtype>::WriteUInt32(NormalizeToBaseAddress(address), value);
     }
@@ -103,7 +109,7 @@ public:
     std::int8_t ReadInt8(std::size_t address) override
     {
         if (!InMemoryRange(address, sizeof(std::int8_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::int8_t>(this->ReportAccessFault({address, sizeof(std::int8_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadInt8(NormalizeToBaseAddress(address));
     }
@@ -111,7 +117,7 @@ public:
     std::uint8_t ReadUInt8(std::size_t address) override
     {
         if (!InMemoryRange(address, sizeof(std::uint8_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::uint8_t>(this->ReportAccessFault({address, sizeof(std::uint8_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadUInt8(NormalizeToBaseAddress(address));
     }
@@ -119,7 +125,7 @@ public:
     std::int16_t ReadInt16(std::size_t address) override
     {
         if (!InMemoryRange(address, sizeof(std::int16_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::int16_t>(this->ReportAccessFault({address, sizeof(std::int16_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadInt16(NormalizeToBaseAddress(address));
     }
@@ -127,7 +133,7 @@ public:
     std::uint16_t ReadUInt16(std::size_t address) override
     {
         if (!InMemoryRange(address, sizeof(std::uint16_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::uint16_t>(this->ReportAccessFault({address, sizeof(std::uint16_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadUInt16(NormalizeToBaseAddress(address));
     }
@@ -135,7 +141,7 @@ public:
     std::uint32_t ReadUInt32(std::size_t address) override
     {
         if (!InMemoryRange(address, sizeof(std::uint32_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::uint32_t>(this->ReportAccessFault({address, sizeof(std::uint32_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadUInt32(NormalizeToBaseAddress(address));
     }
@@ -144,10 +150,29 @@ public:
     {
         // Validate in one of our address ranges
         if (!InMemoryRange(address, sizeof(std::int32_t))) {
-            throw InvalidAddress(address, InvalidAddress::AccessType::READ, "Not in range of multi-mapped memory.");
+            return OpenBusValue<std::int32_t>(this->ReportAccessFault({address, sizeof(std::int32_t), false, AccessFault::Reason::Unmapped}));
         }
         return Memory<mtype>::ReadInt32(NormalizeToBaseAddress(address));
     }
+
+    void WriteBlock(std::size_t address, std::span<const std::uint8_t> data) override
+    {
+        // Blocks crossing between mappings take the byte path
+        if (!InMemoryRange(address, data.size())) {
+            IComponent::WriteBlock(address, data);
+            return;
+        }
+        Memory<mtype>::WriteBlock(NormalizeToBaseAddress(address), data);
+    }
+
+    void ReadBlock(std::size_t address, std::span<std::uint8_t> data) override
+    {
+        if (!InMemoryRange(address, data.size())) {
+            IComponent::ReadBlock(address, data);
+            return;
+        }
+        Memory<mtype>::ReadBlock(NormalizeToBaseAddress(address), data);
+    }
 };
 
 }; // namespace emulator::component
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "component.h"
+
+namespace emulator::component
+{
+
+/**
+ * Always-on emulation performance counters.
+ *
+ * The emulation thread only accumulates raw totals: one bus tick in every
+ * kSampleInterval is timed per component, and System::Run adds its work and
+ * sleep time. A few times a second it publishes a Snapshot with rates, which
+ * any thread (e.g. a frontend overlay) can copy out.
+ */
+class PerfCounters
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::uint64_t kSampleInterval = 4096;
+    static constexpr std::chrono::milliseconds kPublishInterval{250};
+
+    struct Timing {
+        std::uint64_t samples{0};
+        std::uint64_t nanoseconds{0};
+    };
+
+    struct ComponentTiming {
+        std::string name;
+
+        // Cumulative over the sampled ticks
+        std::uint64_t samples{0};
+        std::uint64_t nanoseconds{0};
+
+        double averageTickNanoseconds{0};
+
+        // Fraction of the sampled tick time spent in this component
+        double share{0};
+    };
+
+    struct Snapshot {
+        std::string system;
+
+        // Cumulative since power on
+        std::uint64_t cycles{0};
+        std::uint64_t instructions{0};
+        std::uint64_t frames{0};
+
+        // Rates over the last publish interval
+        double seconds{0};
+        double cyclesPerSecond{0};
+        double instructionsPerSecond{0};
+        double framesPerSecond{0};
+
+        // Emulated time over real time, 1.0 is full speed
+        double speed{0};
+
+        // Time spent in System::Run and how far emulated time lags real time
+        double workSeconds{0};
+        double sleepSeconds{0};
+        double behindSeconds{0};
+
+        std::vector<ComponentTiming> components;
+
+        std::string ToJson() const
+        {
+            auto out = std::format("{{\"system\":\"{}\",\"cycles\":{},\"instructions\":{},\"frames\":{},"
+                                   "\"seconds\":{:.6f},\"cyclesPerSecond\":{:.1f},\"instructionsPerSecond\":{:.1f},"
+                                   "\"framesPerSecond\":{:.2f},\"speed\":{:.4f},\"workSeconds\":{:.6f},"
+                                   "\"sleepSeconds\":{:.6f},\"behindSeconds\":{:.6f},\"components\":[",
+                                   system, cycles, instructions, frames,
+                                   seconds, cyclesPerSecond, instructionsPerSecond,
+                                   framesPerSecond, speed, workSeconds,
+                                   sleepSeconds, behindSeconds);
+            for (std::size_t i = 0; i < components.size(); i++) {
+                auto& component = components[i];
+                out += std::format("{}{{\"name\":\"{}\",\"samples\":{},\"nanoseconds\":{},"
+                                   "\"averageTickNanoseconds\":{:.1f},\"share\":{:.4f}}}",
+                                   i == 0 ? "" : ",", component.name, component.samples, component.nanoseconds,
+                                   component.averageTickNanoseconds, component.share);
+            }
+            return out + "]}";
+        }
+    };
+
+private:
+    std::uint64_t ticksUntilSample_{kSampleInterval};
+    std::unordered_map<const IComponent*, Timing> timings_;
+
+    std::chrono::nanoseconds work_{0};
+    std::chrono::nanoseconds sleep_{0};
+    std::chrono::nanoseconds behind_{0};
+
+    // Totals at the previous publish, rates are taken against them
+    Clock::time_point lastPublish_{Clock::now()};
+    Snapshot previous_;
+
+    mutable std::mutex mutex_;
+    Snapshot published_;
+
+public:
+    PerfCounters() = default;
+
+    // Counters describe one running system, copies start from zero
+    PerfCounters(const PerfCounters&) : PerfCounters() {}
+    PerfCounters& operator=(const PerfCounters&)
+    {
+        Reset();
+        return *this;
+    }
+
+    void Reset()
+    {
+        ticksUntilSample_ = kSampleInterval;
+        timings_.clear();
+        work_ = sleep_ = behind_ = std::chrono::nanoseconds(0);
+        lastPublish_ = Clock::now();
+        previous_ = {};
+
+        std::lock_guard lock(mutex_);
+        published_ = {};
+    }
+
+    // True once every kSampleInterval calls, the caller times that tick
+    bool SampleTick() noexcept
+    {
+        if (--ticksUntilSample_ != 0) [[likely]] {
+            return false;
+        }
+        ticksUntilSample_ = kSampleInterval;
+        return true;
+    }
+
+    void AddTickSample(const IComponent* component, std::chrono::nanoseconds elapsed)
+    {
+        auto& timing = timings_[component];
+        ++timing.samples;
+        timing.nanoseconds += elapsed.count();
+    }
+
+    Timing GetTickSamples(const IComponent* component) const noexcept
+    {
+        auto it = timings_.find(component);
+        return it != timings_.end() ? it->second : Timing{};
+    }
+
+    // Real time spent emulating and sleeping, and how far it ran over the emulated time
+    void AddRunTime(std::chrono::nanoseconds work, std::chrono::nanoseconds sleep, std::chrono::nanoseconds emulated) noexcept
+    {
+        work_ += work;
+        sleep_ += sleep;
+
+        // Running ahead only pays back time already lost
+        behind_ = std::max(behind_ + work + sleep - emulated, std::chrono::nanoseconds(0));
+    }
+
+    bool PublishDue(Clock::time_point now) const noexcept
+    {
+        return now - lastPublish_ >= kPublishInterval;
+    }
+
+    // Fill in rates and run times for totals collected by the caller and make them visible to readers
+    void Publish(Snapshot snapshot, std::uint64_t tickRate, Clock::time_point now)
+    {
+        auto seconds = std::chrono::duration<double>(now - lastPublish_).count();
+        if (seconds > 0) {
+            snapshot.seconds = seconds;
+            snapshot.cyclesPerSecond = (snapshot.cycles - std::min(previous_.cycles, snapshot.cycles)) / seconds;
+            snapshot.instructionsPerSecond = (snapshot.instructions - std::min(previous_.instructions, snapshot.instructions)) / seconds;
+            snapshot.framesPerSecond = (snapshot.frames - std::min(previous_.frames, snapshot.frames)) / seconds;
+            snapshot.speed = tickRate != 0 ? snapshot.cyclesPerSecond / tickRate : 0;
+        }
+
+        snapshot.workSeconds = std::chrono::duration<double>(work_).count();
+        snapshot.sleepSeconds = std::chrono::duration<double>(sleep_).count();
+        snapshot.behindSeconds = std::chrono::duration<double>(behind_).count();
+
+        std::uint64_t total = 0;
+        for (auto& component : snapshot.components) {
+            total += component.nanoseconds;
+        }
+        for (auto& component : snapshot.components) {
+            if (component.samples != 0) {
+                component.averageTickNanoseconds = double(component.nanoseconds) / component.samples;
+            }
+            if (total != 0) {
+                component.share = double(component.nanoseconds) / total;
+            }
+        }
+
+        lastPublish_ = now;
+        previous_ = snapshot;
+
+        std::lock_guard lock(mutex_);
+        published_ = std::move(snapshot);
+    }
+
+    // Latest published snapshot, safe to call from any thread
+    Snapshot GetSnapshot() const
+    {
+        std::lock_guard lock(mutex_);
+        return published_;
+    }
+};
+
+}; // namespace emulator::component
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "bus.h"
+#include "cpu.h"
+#include "scheduler.h"
+
+namespace emulator::component
+{
+
+/**
+ * Sampling profiler for guest code.
+ *
+ * While enabled a scheduler event records the CPU's program location every
+ * interval cycles into a histogram keyed by bank and PC. When disabled no
+ * event is scheduled, so the emulation pays nothing for it. Enabling is a
+ * request from any thread that is applied by the emulation thread in Sync().
+ */
+class Profiler
+{
+public:
+    static constexpr Scheduler::Cycle kDefaultInterval = 1024;
+
+    struct Entry {
+        std::uint32_t bank;
+        std::uint64_t pc;
+        std::uint64_t samples;
+    };
+
+private:
+    Bus& bus_;
+    CPU* cpu_{nullptr};
+
+    std::atomic<bool> requested_{false};
+    std::atomic<Scheduler::Cycle> interval_{kDefaultInterval};
+    Scheduler::EventID event_{Scheduler::kInvalidEvent};
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::uint64_t> histogram_;
+    std::uint64_t samples_{0};
+
+    static constexpr std::uint64_t Key(CPU::ProgramLocation location) noexcept
+    {
+        return (std::uint64_t(location.bank) << 32) | (location.pc & 0xFFFFFFFF);
+    }
+
+    void Arm()
+    {
+        event_ = bus_.GetScheduler().Schedule(interval_, [this]() {
+            Sample();
+            Arm();
+        });
+    }
+
+    void Sample()
+    {
+        auto key = Key(cpu_->GetProgramLocation());
+
+        std::lock_guard lock(mutex_);
+        ++histogram_[key];
+        ++samples_;
+    }
+
+public:
+    explicit Profiler(Bus& bus) : bus_(bus) {}
+
+    void Attach(CPU* cpu) noexcept
+    {
+        cpu_ = cpu;
+    }
+
+    // Takes effect at the next Sync()
+    void SetEnabled(bool enabled) noexcept
+    {
+        requested_ = enabled;
+    }
+
+    bool Enabled() const noexcept
+    {
+        return requested_;
+    }
+
+    void SetInterval(Scheduler::Cycle cycles) noexcept
+    {
+        interval_ = std::max<Scheduler::Cycle>(cycles, 1);
+    }
+
+    Scheduler::Cycle GetInterval() const noexcept
+    {
+        return interval_;
+    }
+
+    // Apply the requested state, only from the thread ticking the bus
+    void Sync()
+    {
+        bool armed = event_ != Scheduler::kInvalidEvent;
+        if (requested_ == armed || cpu_ == nullptr) [[likely]] {
+            return;
+        }
+
+        if (armed) {
+            bus_.GetScheduler().Cancel(event_);
+            event_ = Scheduler::kInvalidEvent;
+        } else {
+            Arm();
+        }
+    }
+
+    // Bus power on drops all scheduled events
+    void PowerOn()
+    {
+        event_ = Scheduler::kInvalidEvent;
+        Sync();
+    }
+
+    void Clear() noexcept
+    {
+        std::lock_guard lock(mutex_);
+        histogram_.clear();
+        samples_ = 0;
+    }
+
+    std::uint64_t GetSampleCount() const noexcept
+    {
+        std::lock_guard lock(mutex_);
+        return samples_;
+    }
+
+    // Most sampled locations first
+    std::vector<Entry> GetHistogram() const
+    {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard lock(mutex_);
+            entries.reserve(histogram_.size());
+            for (auto [key, samples] : histogram_) {
+                entries.push_back({std::uint32_t(key >> 32), key & 0xFFFFFFFF, samples});
+            }
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return std::tie(b.samples, a.bank, a.pc) < std::tie(a.samples, b.bank, b.pc);
+        });
+        return entries;
+    }
+
+    // One location per line with its share of the samples
+    std::string ExportFlat() const
+    {
+        auto entries = GetHistogram();
+
+        std::uint64_t total = 0;
+        for (auto& entry : entries) {
+            total += entry.samples;
+        }
+
+        auto out = std::format("# {} samples, every {} cycles\n", total, GetInterval());
+        for (auto& entry : entries) {
+            out += std::format("{:>10} {:>6.2f}% {:02X}:{:04X}\n", entry.samples,
+                               100.0 * entry.samples / total, entry.bank, entry.pc);
+        }
+        return out;
+    }
+
+    // Collapsed stacks (root;bank;pc count) as read by flamegraph tools
+    std::string ExportCollapsed(std::string_view root) const
+    {
+        std::string out;
+        for (auto& entry : GetHistogram()) {
+            out += std::format("{};bank_{:02X};0x{:04X} {}\n", root, entry.bank, entry.pc, entry.samples);
+        }
+        return out;
+    }
+};
+
+}; // namespace emulator::component
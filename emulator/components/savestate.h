@@ -0,0 +1,93 @@
+#pragma once
+
+#include <any>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace emulator::component
+{
+
+/**
+ * Flat byte buffer components append their state to, read back in the same order.
+ *
+ * Values are copied as raw bytes, so a state only loads into the build that wrote it.
+ * Anything that is not plain data, such as pending callbacks, is kept aside as an object
+ * and only loads back into the same process.
+ */
+class StateWriter
+{
+private:
+    std::vector<std::uint8_t>& out_;
+    std::vector<std::any>& objects_;
+
+public:
+    StateWriter(std::vector<std::uint8_t>& out, std::vector<std::any>& objects) : out_(out), objects_(objects) {}
+
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes");
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const std::uint8_t*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void WriteObject(const T& value)
+    {
+        objects_.emplace_back(value);
+    }
+};
+
+class StateReader
+{
+private:
+    std::span<const std::uint8_t> in_;
+    std::span<const std::any> objects_;
+
+public:
+    StateReader(std::span<const std::uint8_t> in, std::span<const std::any> objects) : in_(in), objects_(objects) {}
+
+    template <typename T>
+    void Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes");
+        ReadBytes(&value, sizeof(T));
+    }
+
+    // Throws std::runtime_error if the state ends first
+    void ReadBytes(void* data, std::size_t size)
+    {
+        if (size > in_.size()) {
+            throw std::runtime_error("Saved state is truncated");
+        }
+        std::memcpy(data, in_.data(), size);
+        in_ = in_.subspan(size);
+    }
+
+    // Throws std::runtime_error if the next object is missing or of another type
+    template <typename T>
+    void ReadObject(T& value)
+    {
+        if (objects_.empty() || objects_.front().type() != typeid(T)) {
+            throw std::runtime_error("Saved state does not match");
+        }
+        value = std::any_cast<const T&>(objects_.front());
+        objects_ = objects_.subspan(1);
+    }
+
+    std::size_t Remaining() const noexcept
+    {
+        return in_.size() + objects_.size();
+    }
+};
+
+}; // namespace emulator::component
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace emulator::component
+{
+
+/**
+ * Cycle based event queue owned by the bus.
+ *
+ * Components that only need to act at a known point in the future (timers,
+ * interrupt sources, etc.) register an event instead of counting down on
+ * every tick. The bus advances the scheduler once per tick, which is a
+ * single compare until the next event is due.
+ */
+class Scheduler
+{
+public:
+    using Cycle = std::uint64_t;
+    using EventID = std::uint64_t;
+    using EventCallback = std::function<void(void)>;
+
+    static constexpr Cycle kNever = std::numeric_limits<Cycle>::max();
+    static constexpr EventID kInvalidEvent = 0;
+
+private:
+    struct Event {
+        Cycle when;
+        EventID id;
+        EventCallback callback;
+    };
+
+    Cycle now_{0};
+    Cycle nextEvent_{kNever};
+    EventID nextID_{kInvalidEvent + 1};
+
+    // Sorted so the next event to fire is at the back
+    std::vector<Event> events_;
+
+    void RunDueEvents()
+    {
+        while (!events_.empty() && events_.back().when <= now_) {
+            // Pop before calling, callbacks are allowed to schedule more events
+            auto callback = std::move(events_.back().callback);
+            events_.pop_back();
+            nextEvent_ = events_.empty() ? kNever : events_.back().when;
+
+            if (callback) {
+                callback();
+            }
+        }
+    }
+
+public:
+    Cycle Now() const noexcept
+    {
+        return now_;
+    }
+
+    Cycle NextEventCycle() const noexcept
+    {
+        return nextEvent_;
+    }
+
+    bool HasPendingEvents() const noexcept
+    {
+        return !events_.empty();
+    }
+
+    EventID Schedule(Cycle delay, EventCallback callback)
+    {
+        return ScheduleAt(now_ + delay, std::move(callback));
+    }
+
+    EventID ScheduleAt(Cycle when, EventCallback callback)
+    {
+        // Events with the same deadline fire in the order they were scheduled
+        auto it = events_.begin();
+        while (it != events_.end() && it->when > when) {
+            ++it;
+        }
+
+        auto id = nextID_++;
+        events_.insert(it, {when, id, std::move(callback)});
+        nextEvent_ = events_.back().when;
+        return id;
+    }
+
+    bool Cancel(EventID id) noexcept
+    {
+        for (auto it = events_.begin(); it != events_.end(); ++it) {
+            if (it->id == id) {
+                events_.erase(it);
+                nextEvent_ = events_.empty() ? kNever : events_.back().when;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void Tick()
+    {
+        if (++now_ >= nextEvent_) [[unlikely]] {
+            RunDueEvents();
+        }
+    }
+
+    // Move time forward, firing every event that becomes due on the way at its own deadline
+    void Advance(Cycle cycles)
+    {
+        auto target = now_ + cycles;
+        while (nextEvent_ <= target) {
+            now_ = std::max(now_, nextEvent_);
+            RunDueEvents();
+        }
+        now_ = target;
+    }
+
+    void Reset() noexcept
+    {
+        now_ = 0;
+        nextEvent_ = kNever;
+        events_.clear();
+    }
+};
+
+}; // namespace emulator::component
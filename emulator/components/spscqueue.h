@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+
+namespace emulator::component
+{
+
+/**
+ * Lock-free queue from exactly one producer thread to exactly one consumer thread.
+ *
+ * Pushing to a full queue fails instead of waiting, so neither side ever blocks.
+ */
+template <typename T, std::size_t Capacity>
+class SPSCQueue
+{
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    std::array<T, Capacity> slots_{};
+
+    // Each index is only written by one side, kept apart so they do not share a cache line
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+
+public:
+    // Producer only, false if the queue is full
+    bool TryPush(const T& value) noexcept
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        slots_[head & kMask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false if the queue is empty
+    bool TryPop(T& value) noexcept
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = slots_[tail & kMask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only, pushes as many values as fit and returns how many
+    std::size_t Push(std::span<const T> values) noexcept
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto count = std::min(values.size(), Capacity - (head - tail_.load(std::memory_order_acquire)));
+
+        for (std::size_t i = 0; i < count; i++) {
+            slots_[(head + i) & kMask] = values[i];
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only, pops up to values.size() and returns how many
+    std::size_t Pop(std::span<T> values) noexcept
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        auto count = std::min(values.size(), head_.load(std::memory_order_acquire) - tail);
+
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = slots_[(tail + i) & kMask];
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only, drop everything pushed so far
+    void Clear() noexcept
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Approximate when called while the other side is active
+    std::size_t Size() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    static constexpr std::size_t GetCapacity() noexcept
+    {
+        return Capacity;
+    }
+};
+
+}; // namespace emulator::component
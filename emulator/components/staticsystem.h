@@ -0,0 +1,73 @@
+#pragma once
+
+#include <format>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
+
+#include "system.h"
+
+namespace emulator::component
+{
+
+/**
+ * System whose tickable components are known at compile time.
+ *
+ * The bus ticks Tickables in the order given through qualified, non-virtual
+ * calls instead of a virtual call per component, so small ReceiveTick bodies
+ * can be inlined. Everything else is the dynamic System, so it is created and
+ * used by plugins and frontends the same way.
+ */
+template <typename... Tickables>
+class StaticSystem : public System
+{
+private:
+    std::tuple<Tickables*...> tickables_;
+
+    static void TickAll(void* context)
+    {
+        std::apply([](Tickables*... components) { (components->Tickables::ReceiveTick(), ...); },
+                   static_cast<StaticSystem*>(context)->tickables_);
+    }
+
+    template <typename T>
+    T* FindExact(const std::unordered_map<std::string, IComponent*>& components)
+    {
+        T* found = nullptr;
+        for (auto& [name, component] : components) {
+            if (typeid(*component) == typeid(T)) {
+                if (found != nullptr) {
+                    throw std::invalid_argument(std::format("StaticSystem: more than one {}", typeid(T).name()));
+                }
+                found = static_cast<T*>(component);
+            }
+        }
+        if (found == nullptr) {
+            throw std::invalid_argument(std::format("StaticSystem: no {}", typeid(T).name()));
+        }
+        return found;
+    }
+
+public:
+    StaticSystem(std::string name, std::uint64_t tickRate,
+                 std::unordered_map<std::string, IComponent*> components,
+                 emulator::debugger::ISystemDebugger* debugger = nullptr)
+        : System(name, tickRate, components, debugger),
+          tickables_(FindExact<Tickables>(components)...)
+    {
+        // A tickable component left out would silently stop being ticked
+        if (GetBus().GetTickableComponents().size() != sizeof...(Tickables)) {
+            throw std::invalid_argument(std::format("StaticSystem: {} tickable components but {} static types",
+                                                    GetBus().GetTickableComponents().size(), sizeof...(Tickables)));
+        }
+        GetBus().SetTickLoop(&TickAll, this);
+    }
+
+    // Fall back to the dynamic tick loop, e.g. to compare against it
+    void UseDynamicTick(bool dynamic = true) noexcept
+    {
+        GetBus().SetTickLoop(dynamic ? nullptr : &TickAll, this);
+    }
+};
+
+}; // namespace emulator::component
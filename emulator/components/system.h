@@ -1,16 +1,27 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include <spdlog/spdlog.h>
 
 #include <debugger/sysdebugger.h>
 
+#include "audio.h"
 #include "bus.h"
+#include "cpu.h"
 #include "display.h"
+#include "perfcounters.h"
+#include "profiler.h"
+#include "savestate.h"
+#include "scheduler.h"
+#include "tracerecorder.h"
 
 namespace emulator::component
 {
@@ -31,18 +42,60 @@ using FrontendFunction = std::function<void(FrontendInterface&)>;
 
 class System
 {
+public:
+    // Everything that changes while running, taken between ticks or as an instruction starts.
+    // Scheduled events call back into this system's components, so it only restores into the system that took it.
+    struct Snapshot {
+        Scheduler scheduler;
+        std::vector<std::uint8_t> state;
+        std::vector<std::any> objects;
+    };
+
 private:
     std::string name_;
     std::uint64_t tickRate_;
     Bus bus_;
+    Profiler profiler_{bus_};
+    std::unique_ptr<TraceRecorder> traceRecorder_;
 
     std::unordered_map<std::string, IComponent*> components_;
 
     bool enableDebugging_{false};
     emulator::debugger::ISystemDebugger* debugger_;
 
+    // Set from the frontend while Run executes
+    std::atomic<bool> audioSync_{false};
+
     std::unordered_map<std::string, FrontendFunction> frontendFunctions_;
 
+    // Sleep off however far the queued audio is ahead of its target, which the audio device drains
+    // at the host rate in chunks of its own size. Returns false if it did not drain in time.
+    static bool WaitForAudio(const Audio& audio, volatile SystemStatus& status, std::chrono::nanoseconds& slept)
+    {
+        static constexpr auto kAudioStallTimeout = std::chrono::milliseconds(250);
+
+        // Nearly every tick, kept to a single load
+        auto queued = audio.GetBufferedSamples();
+        if (queued <= audio.GetTargetSamples()) [[likely]] {
+            return true;
+        }
+
+        auto sleepStart = std::chrono::high_resolution_clock::now();
+        auto drained = true;
+        for (; queued > audio.GetTargetSamples() && status == SystemStatus::RUNNING; queued = audio.GetBufferedSamples()) {
+            if (std::chrono::high_resolution_clock::now() - sleepStart >= kAudioStallTimeout) {
+                drained = false;
+                break;
+            }
+
+            auto ahead = std::int64_t(queued - audio.GetTargetSamples()) * 1000000000 / audio.GetSampleRate();
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ahead));
+        }
+        slept += std::chrono::high_resolution_clock::now() - sleepStart;
+
+        return drained;
+    }
+
 public:
     System(std::string name, std::uint64_t tickRate,
            std::unordered_map<std::string, IComponent*> components,
@@ -54,10 +107,19 @@ public:
         for (auto& [name, component] : components) {
             bus_.AddComponent(component);
         }
+        profiler_.Attach(GetFirstComponentByType<CPU>(IComponent::ComponentType::CPU));
+
+        // Faults under AccessFaultPolicy::Trap stop in the debugger
+        bus_.RegisterAccessFaultCallback([this](Bus*, const AccessFault&) {
+            if (enableDebugging_ && debugger_ != nullptr) {
+                debugger_->HandleSignal(emulator::debugger::kSIGTRAP);
+            }
+        });
     }
 
-    ~System()
+    virtual ~System()
     {
+        StopTrace();
     }
 
     std::string Name() const noexcept
@@ -68,6 +130,7 @@ public:
     void PowerOn() noexcept
     {
         bus_.PowerOn();
+        profiler_.PowerOn();
     }
 
     void PowerOff() noexcept
@@ -80,6 +143,30 @@ public:
         return bus_;
     }
 
+    Snapshot SaveSnapshot() const
+    {
+        Snapshot snapshot{bus_.GetScheduler(), {}, {}};
+        StateWriter writer(snapshot.state, snapshot.objects);
+        for (auto& [_, component] : components_) {
+            component->SaveState(writer);
+        }
+        return snapshot;
+    }
+
+    // Throws std::runtime_error if the snapshot does not match the components
+    void RestoreSnapshot(const Snapshot& snapshot)
+    {
+        bus_.GetScheduler() = snapshot.scheduler;
+
+        StateReader reader(snapshot.state, snapshot.objects);
+        for (auto& [_, component] : components_) {
+            component->LoadState(reader);
+        }
+        if (reader.Remaining() != 0) {
+            throw std::runtime_error("Snapshot was taken from a different system");
+        }
+    }
+
     IComponent* GetComponent(std::string name) const noexcept
     {
         auto it = components_.find(name);
@@ -115,47 +202,96 @@ public:
     void Run(volatile SystemStatus& status)
     {
         static constexpr int kTickRecalculateInterval = 1000;
+        static constexpr auto kDebuggerParkTimeout = std::chrono::milliseconds(100);
+
+        auto& scheduler = bus_.GetScheduler();
+        auto& perfCounters = bus_.GetPerfCounters();
 
         auto tickCounter = kTickRecalculateInterval;
         auto interval = std::chrono::nanoseconds(1000000000 / tickRate_).count();
+        auto startCycle = scheduler.Now();
 
         // Purposefully not in nanoseconds to prevent average at a 0 delay
         auto sleepTime = std::chrono::microseconds(0);
+        auto slept = std::chrono::nanoseconds(0);
+
+        // Paced by how much sound is queued instead of the wall clock, when there is sound to go by
+        auto audio = GetFirstComponentByType<Audio>(IComponent::ComponentType::Sound);
 
         auto start = std::chrono::high_resolution_clock::now();
         while (status == SystemStatus::RUNNING) {
-            if (enableDebugging_ && debugger_ != nullptr && debugger_->IsStopped()) {
+            if (enableDebugging_ && debugger_ != nullptr && debugger_->IsStopped()) [[unlikely]] {
+                // Park until the debugger resumes, waking now and then to notice the system being stopped
+                debugger_->WaitWhileStopped(kDebuggerParkTimeout);
+
+                // Time stopped in the debugger is not counted against the emulation
+                tickCounter = kTickRecalculateInterval;
                 continue;
             }
 
             if (tickCounter >= kTickRecalculateInterval) {
                 start = std::chrono::high_resolution_clock::now();
+                startCycle = scheduler.Now();
+                slept = std::chrono::nanoseconds(0);
             }
 
             // Fails if powered off
+            auto tickCycle = scheduler.Now();
             if (!bus_.ReceiveTick()) {
                 break;
             }
 
+            // A single tick covers more than one cycle when the bus skipped idle time
+            auto cycles = scheduler.Now() - tickCycle;
+
+            // Replaying history for the debugger catches up as fast as possible
+            auto paced = !(enableDebugging_ && debugger_ != nullptr && debugger_->IsReplaying());
+
+            // Checked every tick, as one that skipped idle time can produce a lot of sound
+            auto audioSynced = audio != nullptr && audioSync_.load(std::memory_order_relaxed);
+            if (audioSynced && paced && !WaitForAudio(*audio, status, slept)) [[unlikely]] {
+                spdlog::warn("[System] Audio is not being played, pacing {} by the wall clock", name_);
+                audioSync_ = false;
+            }
+
             // Average the tick rate to minimize spin calls
             // Higher values for kTickRecalculateInterval can result in longer stutters
             if (--tickCounter == 0) {
                 tickCounter = kTickRecalculateInterval;
-                auto elapsedAverage = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                          std::chrono::high_resolution_clock::now() - start)
-                                          .count() /
-                                      kTickRecalculateInterval;
-                if (elapsedAverage <= interval) {
-                    // We are running too fast, slow down
-                    sleepTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(interval - elapsedAverage));
-                } else {
-                    // We are running too slow, speed up
+
+                if (audioSynced) {
                     sleepTime = std::chrono::microseconds(0);
+                } else {
+                    auto now = std::chrono::high_resolution_clock::now();
+                    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+                    auto elapsedCycles = scheduler.Now() - startCycle;
+                    auto elapsedAverage = elapsed.count() /
+                                          static_cast<std::int64_t>(std::max<std::uint64_t>(elapsedCycles, 1));
+                    if (elapsedAverage <= interval) {
+                        // We are running too fast, slow down
+                        sleepTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(interval - elapsedAverage));
+                    } else {
+                        // We are running too slow, speed up
+                        sleepTime = std::chrono::microseconds(0);
+                    }
+                }
+
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start);
+                auto elapsedCycles = scheduler.Now() - startCycle;
+                profiler_.Sync();
+                perfCounters.AddRunTime(elapsed - slept, slept, std::chrono::nanoseconds(elapsedCycles * 1000000000 / tickRate_));
+                if (perfCounters.PublishDue(PerfCounters::Clock::now())) [[unlikely]] {
+                    PublishPerfCounters();
                 }
             }
 
-            std::this_thread::sleep_for(sleepTime);
+            if (sleepTime.count() != 0 && cycles != 0 && paced) {
+                auto sleepStart = std::chrono::high_resolution_clock::now();
+                std::this_thread::sleep_for(sleepTime * static_cast<std::int64_t>(cycles));
+                slept += std::chrono::high_resolution_clock::now() - sleepStart;
+            }
         }
+        PublishPerfCounters();
         status = SystemStatus::HALTED;
     }
 
@@ -165,9 +301,101 @@ public:
         Run(status);
     }
 
+    // Gather the cumulative totals and publish them as the latest perf counter snapshot
+    void PublishPerfCounters()
+    {
+        auto& perfCounters = bus_.GetPerfCounters();
+
+        PerfCounters::Snapshot snapshot;
+        snapshot.system = name_;
+        snapshot.cycles = bus_.GetScheduler().Now();
+
+        for (auto cpu : GetComponentsByType<CPU>(IComponent::ComponentType::CPU)) {
+            snapshot.instructions += cpu->GetInstructionCount();
+        }
+        for (auto display : GetComponentsByType<Display>(IComponent::ComponentType::Display)) {
+            snapshot.frames = std::max(snapshot.frames, display->GetFrameCount());
+        }
+
+        for (auto& [name, component] : components_) {
+            if (!component->IsTickable()) {
+                continue;
+            }
+            auto timing = perfCounters.GetTickSamples(component);
+            snapshot.components.push_back({name, timing.samples, timing.nanoseconds});
+        }
+        std::sort(snapshot.components.begin(), snapshot.components.end(),
+                  [](const auto& a, const auto& b) { return a.name < b.name; });
+
+        perfCounters.Publish(std::move(snapshot), tickRate_, PerfCounters::Clock::now());
+    }
+
+    // Record every instruction of the CPU to path until StopTrace(), only while Run is not executing
+    void StartTrace(const std::string& path)
+    {
+        StopTrace();
+
+        auto cpu = GetFirstComponentByType<CPU>(IComponent::ComponentType::CPU);
+        if (cpu == nullptr) {
+            throw std::runtime_error("System has no CPU to trace");
+        }
+
+        traceRecorder_ = std::make_unique<TraceRecorder>(path);
+        cpu->SetTraceRecorder(traceRecorder_.get());
+        spdlog::info("[Trace] Recording {} to {}", name_, path);
+    }
+
+    void StopTrace()
+    {
+        if (traceRecorder_ == nullptr) {
+            return;
+        }
+
+        for (auto cpu : GetComponentsByType<CPU>(IComponent::ComponentType::CPU)) {
+            cpu->SetTraceRecorder(nullptr);
+        }
+        traceRecorder_->Stop();
+
+        auto& stats = traceRecorder_->GetStats();
+        spdlog::info("[Trace] Recorded {} instructions in {} bytes, buffer full {} times",
+                     stats.records, stats.bytes, stats.stalls);
+        traceRecorder_.reset();
+    }
+
+    bool Tracing() const noexcept
+    {
+        return traceRecorder_ != nullptr;
+    }
+
+    Profiler& GetProfiler() noexcept
+    {
+        return profiler_;
+    }
+
+    // Latest counters published by Run, safe to call from any thread
+    PerfCounters::Snapshot GetPerfSnapshot() const
+    {
+        return bus_.GetPerfCounters().GetSnapshot();
+    }
+
+    // Pace Run by the audio queue rather than the wall clock, only once something plays the audio.
+    // Ignored by systems without sound, and turned back off if the audio stops draining.
+    void SetAudioSync(bool enabled) noexcept
+    {
+        audioSync_ = enabled;
+    }
+
+    bool AudioSync() const noexcept
+    {
+        return audioSync_;
+    }
+
     void UseDebugger(bool enabled = true) noexcept
     {
         enableDebugging_ = enabled;
+        for (auto cpu : GetComponentsByType<CPU>(IComponent::ComponentType::CPU)) {
+            cpu->AttachDebugger(enabled ? debugger_ : nullptr);
+        }
     }
 
     bool DebuggerEnabled() const noexcept
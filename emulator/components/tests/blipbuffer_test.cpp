@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdlib>
+
+#include "blipbuffer.h"
+
+using emulator::component::BlipBuffer;
+
+// 20 clock cycles per output sample
+static constexpr double kClockRate = 1000000;
+static constexpr double kSampleRate = 50000;
+
+// Test a step comes out as a settled step after the kernel's delay
+TEST(ComponentBlipBuffer, Step)
+{
+    BlipBuffer blip(kClockRate, kSampleRate, 1024);
+    std::array<BlipBuffer::Sample, 100> samples;
+
+    blip.AddDelta(200, 1000);
+    blip.EndFrame(2000);
+    ASSERT_EQ(blip.SamplesAvailable(), 100);
+    ASSERT_EQ(blip.ReadSamples(samples), 100);
+
+    // Nothing before the step, then within the DC filter's slow decay of it
+    ASSERT_EQ(samples[0], 0);
+    ASSERT_LT(std::abs(samples[5]), 10);
+    ASSERT_GT(samples[20], 950);
+    ASSERT_LT(samples[20], 1050);
+    ASSERT_LT(samples[99], samples[20]);
+}
+
+// Test fractional samples carry over between frames
+TEST(ComponentBlipBuffer, FrameLengths)
+{
+    BlipBuffer blip(kClockRate, kSampleRate, 1024);
+    std::array<BlipBuffer::Sample, 8> samples;
+
+    std::size_t read = 0;
+    for (int frame = 0; frame < 3; frame++) {
+        blip.EndFrame(30);
+        read += blip.ReadSamples(samples);
+    }
+    ASSERT_EQ(read, 4);
+    ASSERT_EQ(blip.SamplesFor(90), 4);
+}
+
+// Test an offset held for long enough is filtered back to silence
+TEST(ComponentBlipBuffer, RemovesDC)
+{
+    BlipBuffer blip(kClockRate, kSampleRate, 1024);
+    std::array<BlipBuffer::Sample, 500> samples;
+
+    blip.AddDelta(0, 10000);
+    for (int frame = 0; frame < 20; frame++) {
+        blip.EndFrame(10000);
+        ASSERT_EQ(blip.ReadSamples(samples), 500);
+    }
+    ASSERT_LT(std::abs(samples.back()), 10);
+}
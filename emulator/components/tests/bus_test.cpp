@@ -48,10 +48,11 @@ TEST(ComponentBUS, AddressComponent)
     ASSERT_EQ(value, 0);
 }
 
-// Test addressing into invalid memory on bus
+// Test addressing into invalid memory on bus in strict mode
 TEST(ComponentBUS, InvalidAddressComponent)
 {
     auto bus = emulator::component::Bus();
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::Strict);
     auto ram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(1024);
 
     ASSERT_NO_THROW(bus.AddComponent(ram));
@@ -74,6 +75,7 @@ TEST(ComponentBUS, RemoveComponent)
 TEST(ComponentBUS, RemoveComponentAccessAddress)
 {
     auto bus = emulator::component::Bus();
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::Strict);
     auto ram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(1024);
 
     ASSERT_NO_THROW(bus.AddComponent(ram));
@@ -128,3 +130,120 @@ TEST(ComponentBUS, WritePrimitiveTypes)
     bus.Write<std::int32_t>(0x50, 0x87654321);
     ASSERT_EQ(bus.Read<std::int32_t>(0x50), 0x87654321);
 }
+
+// Test unmapped accesses read open bus without throwing
+TEST(ComponentBUS, OpenBus)
+{
+    auto bus = emulator::component::Bus();
+    auto ram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(1024);
+
+    ASSERT_NO_THROW(bus.AddComponent(ram));
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::LogOnce, 0xAB);
+
+    ASSERT_EQ(bus.Read<std::uint8_t>(2048), 0xAB);
+    ASSERT_EQ(bus.Read<std::uint16_t>(2048), 0xABAB);
+    ASSERT_NO_THROW(bus.Write<std::uint8_t>(2048, 0x12));
+
+    ASSERT_EQ(bus.GetAccessFaultCount(), 3);
+    ASSERT_EQ(bus.GetLastAccessFault().address, 2048);
+    ASSERT_TRUE(bus.GetLastAccessFault().isWrite);
+    ASSERT_FALSE(bus.IsMapped(2048));
+    ASSERT_TRUE(bus.IsMapped(1023));
+}
+
+// Test component faults follow the bus policy
+TEST(ComponentBUS, ComponentFaults)
+{
+    auto bus = emulator::component::Bus();
+    auto rom = new emulator::component::Memory<emulator::component::MemoryType::ReadOnly>(1024);
+    ASSERT_NO_THROW(bus.AddComponent(rom));
+
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::Strict);
+    ASSERT_THROW(bus.Write<std::uint8_t>(0x10, 0x12), emulator::component::MemoryReadOnlyViolation);
+    ASSERT_THROW(bus.Write<float>(0x10, 1.0f), emulator::component::MemoryNoImplementation);
+
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::OpenBus);
+    ASSERT_NO_THROW(bus.Write<std::uint8_t>(0x10, 0x12));
+    ASSERT_EQ(bus.Read<std::uint8_t>(0x10), 0);
+    ASSERT_EQ(bus.GetLastAccessFault().reason, emulator::component::AccessFault::Reason::ReadOnly);
+}
+
+// Test trapped faults are reported to the callback
+TEST(ComponentBUS, TrapFault)
+{
+    auto bus = emulator::component::Bus();
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::Trap);
+
+    std::vector<std::uint64_t> trapped;
+    bus.RegisterAccessFaultCallback([&trapped](emulator::component::Bus*, const emulator::component::AccessFault& fault) {
+        trapped.push_back(fault.address);
+    });
+
+    bus.Read<std::uint8_t>(0x10);
+    bus.Write<std::uint8_t>(0x20, 0);
+    ASSERT_EQ(trapped, (std::vector<std::uint64_t>{0x10, 0x20}));
+}
+
+// Test block transfers split across components and unmapped gaps
+TEST(ComponentBUS, BlockTransfers)
+{
+    auto bus = emulator::component::Bus();
+    auto ram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0, 0x100);
+    auto ram2 = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0x100, 0x100);
+    auto ram3 = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0x300, 0x100);
+    bus.AddComponent(ram);
+    bus.AddComponent(ram2);
+    bus.AddComponent(ram3);
+    bus.SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::OpenBus, 0xEE);
+
+    std::vector<std::uint8_t> data(0x400);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = std::uint8_t(i * 7);
+    }
+    bus.WriteBlock(0, data);
+
+    for (std::size_t i = 0; i < data.size(); i++) {
+        auto expected = (i >= 0x200 && i < 0x300) ? 0xEE : data[i];
+        ASSERT_EQ(bus.Read<std::uint8_t>(i), expected);
+    }
+
+    // One fault for the whole gap
+    std::vector<std::uint8_t> read(0x400);
+    auto faults = bus.GetAccessFaultCount();
+    bus.ReadBlock(0, read);
+    ASSERT_EQ(bus.GetAccessFaultCount(), faults + 1);
+    ASSERT_EQ(bus.GetLastAccessFault().address, 0x200);
+    ASSERT_EQ(bus.GetLastAccessFault().size, 0x100);
+
+    for (std::size_t i = 0; i < read.size(); i++) {
+        ASSERT_EQ(read[i], bus.Read<std::uint8_t>(i));
+    }
+    ASSERT_EQ(bus.MappedLength(0x80, 0x400), 0x180);
+}
+
+// Test block writes reach watch points and write observers
+TEST(ComponentBUS, BlockTransferNotifications)
+{
+    auto bus = emulator::component::Bus();
+    auto ram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0, 0x100);
+    bus.AddComponent(ram);
+
+    std::vector<std::uint64_t> watched;
+    bus.AddMemoryWatchPoint(0x10);
+    bus.AddMemoryWatchPoint(0x80);
+    bus.RegisterMemoryWatchCallback([&watched](emulator::component::Bus*, std::uint64_t address, bool) {
+        watched.push_back(address);
+    });
+
+    std::vector<std::pair<std::size_t, std::size_t>> observed;
+    bus.AddWriteObserver(ram, {0x40, 0x4F}, [&observed](std::size_t address, std::size_t size) {
+        observed.push_back({address, size});
+    });
+
+    std::vector<std::uint8_t> data(0x20);
+    bus.WriteBlock(0x08, data);
+    bus.WriteBlock(0x30, data);
+
+    ASSERT_EQ(watched, (std::vector<std::uint64_t>{0x10}));
+    ASSERT_EQ(observed, (std::vector<std::pair<std::size_t, std::size_t>>{{0x30, 0x20}}));
+}
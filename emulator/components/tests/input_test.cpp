@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "bus.h"
+#include "input.h"
+
+class ComponentInput : public ::testing::Test
+{
+protected:
+    static constexpr int kPollInterval = 8;
+
+    emulator::component::Bus bus_;
+    emulator::component::Input* input_;
+
+    virtual void SetUp()
+    {
+        input_ = new emulator::component::Input(kPollInterval);
+        input_->RegisterKey('a');
+        input_->RegisterKey('b');
+        input_->RegisterKey('c');
+
+        bus_.AddComponent(input_);
+    }
+
+    void Tick(int ticks)
+    {
+        for (int i = 0; i < ticks; i++) {
+            bus_.ReceiveTick();
+        }
+    }
+
+    // Move to a later frame and read the keys there, as the guest would
+    void Frames(int frames)
+    {
+        Tick(frames * kPollInterval);
+        input_->Poll();
+    }
+};
+
+// Test key changes reach the guest once per frame, however often it polls
+TEST_F(ComponentInput, AppliedAtPoll)
+{
+    bus_.PowerOn();
+
+    input_->PressKey('a');
+    input_->PressKey('z');
+    ASSERT_FALSE(input_->IsPressed('a'));
+    input_->Poll();
+    ASSERT_TRUE(input_->IsPressed('a'));
+    ASSERT_EQ(input_->GetPressed(), 0b001);
+
+    // Changes within a frame apply together, in order
+    input_->ReleaseKey('a');
+    input_->PressKey('c');
+    input_->ToggleKey('b');
+    input_->ToggleKey('b');
+    input_->ToggleKey('b');
+    Tick(kPollInterval - 1);
+    input_->Poll();
+    ASSERT_EQ(input_->GetPressed(), 0b001);
+
+    Tick(1);
+    input_->Poll();
+    ASSERT_EQ(input_->GetPressed(), 0b110);
+}
+
+// Test keys get slots in registration order, whatever their keycode
+TEST_F(ComponentInput, Slots)
+{
+    constexpr int kLargeKeyCode = 0x4000004F;
+
+    ASSERT_EQ(input_->RegisterKey('b'), 1);
+    ASSERT_EQ(input_->RegisterKey(kLargeKeyCode), 3);
+    ASSERT_EQ(input_->RegisterKey(-1), 4);
+    ASSERT_EQ(input_->GetSlot('c'), 2);
+    ASSERT_EQ(input_->GetSlot(kLargeKeyCode), 3);
+    ASSERT_EQ(input_->GetSlot('z'), emulator::component::Input::kNoSlot);
+    ASSERT_EQ(input_->GetSlot(kLargeKeyCode + 1), emulator::component::Input::kNoSlot);
+
+    bus_.PowerOn();
+    input_->PressKey(kLargeKeyCode);
+    input_->PressKey(-1);
+    input_->Poll();
+    ASSERT_EQ(input_->GetPressed(), 0b11000);
+    ASSERT_TRUE(input_->IsPressed(kLargeKeyCode));
+
+    for (int key = 0; input_->GetKeys().size() < emulator::component::Input::kMaxKeys; key++) {
+        input_->RegisterKey(0x1000 + key);
+    }
+    ASSERT_THROW(input_->RegisterKey('z'), std::length_error);
+}
+
+// Test a recorded movie plays the same keys back at the same frames
+TEST_F(ComponentInput, RecordAndPlay)
+{
+    input_->RecordMovie();
+    bus_.PowerOn();
+
+    input_->PressKey('a');
+    Frames(0);
+    Frames(3);
+    input_->PressKey('c');
+    input_->ReleaseKey('a');
+    Frames(1);
+    input_->ReleaseKey('c');
+    Frames(2);
+
+    auto movie = input_->StopMovie();
+    ASSERT_NE(movie, nullptr);
+    using Change = emulator::component::Movie::Change;
+    ASSERT_EQ(movie->GetChanges(), (std::vector<Change>{{0, 0b001}, {4, 0b100}, {6, 0}}));
+
+    // Through the file format and into a fresh power on
+    std::stringstream file;
+    movie->Save(file);
+    input_->PlayMovie(emulator::component::Movie::Load(file));
+    bus_.PowerOn();
+
+    // Live input is ignored while playing
+    input_->PressKey('b');
+    Frames(0);
+    ASSERT_TRUE(input_->IsPressed('a'));
+    ASSERT_FALSE(input_->IsPressed('b'));
+    Frames(4);
+    ASSERT_FALSE(input_->IsPressed('a'));
+    ASSERT_TRUE(input_->IsPressed('c'));
+
+    // Frames the guest did not poll are caught up on
+    Frames(3);
+    ASSERT_FALSE(input_->IsPressed('c'));
+
+    // Other keys or polling can not replay it
+    emulator::component::Input other(kPollInterval * 2);
+    other.RegisterKey('a');
+    other.RegisterKey('b');
+    other.RegisterKey('c');
+    ASSERT_THROW(other.PlayMovie(*movie), std::invalid_argument);
+}
+
+// Test loading rejects anything that is not a complete movie
+TEST(ComponentMovie, LoadErrors)
+{
+    std::stringstream garbage("not a movie");
+    ASSERT_THROW(emulator::component::Movie::Load(garbage), std::runtime_error);
+
+    emulator::component::Movie movie(8, {-1, 300});
+    movie.Record(1000, 0b10);
+    std::stringstream file;
+    movie.Save(file);
+
+    auto loaded = emulator::component::Movie::Load(file);
+    ASSERT_EQ(loaded.GetKeys(), movie.GetKeys());
+    ASSERT_EQ(loaded.GetChanges(), movie.GetChanges());
+
+    // Cut off inside the frame varint of the only record
+    auto bytes = file.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 2));
+    ASSERT_THROW(emulator::component::Movie::Load(truncated), std::runtime_error);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+// Keep only warnings and above, as a release build would with a higher floor
+#define EMULATOR_LOG_LEVEL SPDLOG_LEVEL_WARN
+#include "log.h"
+
+#include <spdlog/sinks/ostream_sink.h>
+
+#include <sstream>
+
+using emulator::log::Subsystem;
+
+class ComponentLog : public ::testing::Test
+{
+protected:
+    std::ostringstream output_;
+    std::shared_ptr<spdlog::logger> previous_;
+
+    virtual void SetUp()
+    {
+        previous_ = spdlog::default_logger();
+        auto logger = std::make_shared<spdlog::logger>("log_test", std::make_shared<spdlog::sinks::ostream_sink_mt>(output_));
+        logger->set_pattern("%v");
+        logger->set_level(spdlog::level::trace);
+        spdlog::set_default_logger(logger);
+    }
+
+    virtual void TearDown()
+    {
+        spdlog::set_default_logger(previous_);
+        for (std::size_t i = 0; i < emulator::log::kSubsystemNames.size(); i++) {
+            emulator::log::SetLevel(Subsystem(i), spdlog::level::trace);
+        }
+    }
+};
+
+// Test levels below the compile-time floor never evaluate their arguments
+TEST_F(ComponentLog, CompiledOut)
+{
+    int evaluated = 0;
+    EMU_TRACE(CPU, "{}", ++evaluated);
+    EMU_DEBUG(CPU, "{}", ++evaluated);
+    EMU_INFO(CPU, "{}", ++evaluated);
+    ASSERT_EQ(evaluated, 0);
+    ASSERT_EQ(output_.str(), "");
+
+    EMU_WARN(CPU, "{}", ++evaluated);
+    ASSERT_EQ(evaluated, 1);
+    ASSERT_EQ(output_.str(), "1\n");
+}
+
+// Test subsystem filters apply before formatting
+TEST_F(ComponentLog, SubsystemFilter)
+{
+    int evaluated = 0;
+    emulator::log::SetLevel(Subsystem::Bus, spdlog::level::off);
+    EMU_ERROR(Bus, "{}", ++evaluated);
+    ASSERT_EQ(evaluated, 0);
+
+    EMU_ERROR(PPU, "ppu");
+    ASSERT_EQ(output_.str(), "ppu\n");
+}
+
+// Test filter strings are parsed per subsystem
+TEST_F(ComponentLog, Configure)
+{
+    ASSERT_TRUE(emulator::log::Configure("bus=off,cpu=debug"));
+    ASSERT_EQ(emulator::log::GetLevel(Subsystem::Bus), spdlog::level::off);
+    ASSERT_EQ(emulator::log::GetLevel(Subsystem::CPU), spdlog::level::debug);
+    ASSERT_EQ(emulator::log::GetLevel(Subsystem::PPU), spdlog::level::trace);
+
+    ASSERT_FALSE(emulator::log::Configure("apu=off,ppu=warn,bogus"));
+    ASSERT_EQ(emulator::log::GetLevel(Subsystem::PPU), spdlog::level::warn);
+}
+
+// Test repeated messages from one call site are limited and counted
+TEST_F(ComponentLog, RateLimited)
+{
+    for (int i = 0; i < 20; i++) {
+        EMU_WARN_LIMITED(PPU, "unhandled");
+    }
+
+    std::string expected;
+    for (std::uint32_t i = 0; i < emulator::log::RateLimiter::kMessagesPerWindow; i++) {
+        expected += "unhandled\n";
+    }
+    ASSERT_EQ(output_.str(), expected);
+
+    std::uint64_t suppressed = 0;
+    emulator::log::RateLimiter limiter;
+    for (std::uint32_t i = 0; i < emulator::log::RateLimiter::kMessagesPerWindow; i++) {
+        ASSERT_TRUE(limiter.Allow(suppressed));
+    }
+    ASSERT_FALSE(limiter.Allow(suppressed));
+    ASSERT_FALSE(limiter.Allow(suppressed));
+}
@@ -57,5 +57,5 @@ TEST(ComponentMemory, AccessReadOnlyMemory)
     auto rom = emulator::component::Memory<emulator::component::MemoryType::ReadOnly>(32);
 
     ASSERT_EQ(rom.ReadUInt8(0x0), 0);
-    ASSERT_THROW(rom.WriteUInt8(0x0, 0x12), std::runtime_error);
+    ASSERT_THROW(rom.WriteUInt8(0x0, 0x12), emulator::component::MemoryReadOnlyViolation);
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "bus.h"
+#include "perfcounters.h"
+
+using emulator::component::PerfCounters;
+
+class CountingComponent : public emulator::component::IComponent
+{
+public:
+    std::uint64_t ticks{0};
+
+    CountingComponent() : IComponent(ComponentType::Other) {}
+
+    void ReceiveTick() override
+    {
+        ++ticks;
+    }
+
+    void PowerOn() noexcept override {}
+    void PowerOff() noexcept override {}
+};
+
+// Test one bus tick in every sample interval is timed per component
+TEST(ComponentPerfCounters, SamplesTicks)
+{
+    auto bus = emulator::component::Bus();
+    auto component = new CountingComponent();
+
+    bus.AddComponent(component);
+    bus.PowerOn();
+
+    for (std::uint64_t i = 0; i < PerfCounters::kSampleInterval * 3 - 1; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(bus.GetPerfCounters().GetTickSamples(component).samples, 2);
+
+    bus.ReceiveTick();
+    ASSERT_EQ(bus.GetPerfCounters().GetTickSamples(component).samples, 3);
+    ASSERT_EQ(component->ticks, PerfCounters::kSampleInterval * 3);
+
+    // Power on starts counting over
+    bus.PowerOn();
+    ASSERT_EQ(bus.GetPerfCounters().GetTickSamples(component).samples, 0);
+}
+
+// Test published rates are taken against the previous snapshot
+TEST(ComponentPerfCounters, PublishRates)
+{
+    PerfCounters counters;
+    auto start = PerfCounters::Clock::now();
+
+    PerfCounters::Snapshot snapshot;
+    snapshot.system = "Test";
+    snapshot.cycles = 1000;
+    snapshot.components = {{"A", 2, 300}, {"B", 1, 100}};
+    counters.Publish(snapshot, 2000, start + std::chrono::seconds(10));
+
+    snapshot.cycles = 3000;
+    snapshot.instructions = 500;
+    snapshot.frames = 4;
+    counters.Publish(snapshot, 2000, start + std::chrono::seconds(11));
+
+    auto published = counters.GetSnapshot();
+    ASSERT_DOUBLE_EQ(published.seconds, 1.0);
+    ASSERT_DOUBLE_EQ(published.cyclesPerSecond, 2000.0);
+    ASSERT_DOUBLE_EQ(published.instructionsPerSecond, 500.0);
+    ASSERT_DOUBLE_EQ(published.framesPerSecond, 4.0);
+    ASSERT_DOUBLE_EQ(published.speed, 1.0);
+
+    ASSERT_EQ(published.components.size(), 2);
+    ASSERT_DOUBLE_EQ(published.components[0].averageTickNanoseconds, 150.0);
+    ASSERT_DOUBLE_EQ(published.components[0].share, 0.75);
+
+    auto json = published.ToJson();
+    ASSERT_NE(json.find("\"system\":\"Test\""), std::string::npos);
+    ASSERT_NE(json.find("\"cycles\":3000"), std::string::npos);
+    ASSERT_NE(json.find("{\"name\":\"B\",\"samples\":1,\"nanoseconds\":100,"), std::string::npos);
+}
+
+// Test time lost to slow emulation is tracked and paid back when running ahead
+TEST(ComponentPerfCounters, BehindRealTime)
+{
+    using std::chrono::milliseconds;
+
+    PerfCounters counters;
+    counters.AddRunTime(milliseconds(30), milliseconds(0), milliseconds(20));
+    counters.AddRunTime(milliseconds(5), milliseconds(10), milliseconds(20));
+    counters.AddRunTime(milliseconds(5), milliseconds(0), milliseconds(20));
+    counters.Publish({}, 1, PerfCounters::Clock::now());
+
+    auto published = counters.GetSnapshot();
+    ASSERT_DOUBLE_EQ(published.workSeconds, 0.040);
+    ASSERT_DOUBLE_EQ(published.sleepSeconds, 0.010);
+    ASSERT_DOUBLE_EQ(published.behindSeconds, 0.0);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "scheduler.h"
+
+// Test events fire at their deadline in order
+TEST(ComponentScheduler, EventsFireInOrder)
+{
+    auto scheduler = emulator::component::Scheduler();
+    std::vector<int> order;
+
+    scheduler.Schedule(3, [&order]() { order.push_back(3); });
+    scheduler.Schedule(1, [&order]() { order.push_back(1); });
+    scheduler.Schedule(3, [&order]() { order.push_back(4); });
+    scheduler.Schedule(2, [&order]() { order.push_back(2); });
+
+    ASSERT_EQ(scheduler.NextEventCycle(), 1);
+
+    scheduler.Tick();
+    ASSERT_EQ(order, std::vector<int>({1}));
+
+    scheduler.Tick();
+    scheduler.Tick();
+    ASSERT_EQ(order, std::vector<int>({1, 2, 3, 4}));
+    ASSERT_FALSE(scheduler.HasPendingEvents());
+}
+
+// Test cancelled events never fire
+TEST(ComponentScheduler, CancelEvent)
+{
+    auto scheduler = emulator::component::Scheduler();
+    bool fired = false;
+
+    auto id = scheduler.Schedule(1, [&fired]() { fired = true; });
+    ASSERT_TRUE(scheduler.Cancel(id));
+    ASSERT_FALSE(scheduler.Cancel(id));
+
+    scheduler.Advance(10);
+    ASSERT_FALSE(fired);
+    ASSERT_EQ(scheduler.NextEventCycle(), emulator::component::Scheduler::kNever);
+}
+
+// Test advancing over several events reports each deadline as current cycle
+TEST(ComponentScheduler, AdvanceObservesDeadlines)
+{
+    auto scheduler = emulator::component::Scheduler();
+    std::vector<emulator::component::Scheduler::Cycle> seen;
+
+    scheduler.Schedule(5, [&]() {
+        seen.push_back(scheduler.Now());
+        scheduler.Schedule(5, [&]() { seen.push_back(scheduler.Now()); });
+    });
+
+    scheduler.Advance(100);
+    ASSERT_EQ(seen, std::vector<emulator::component::Scheduler::Cycle>({5, 10}));
+    ASSERT_EQ(scheduler.Now(), 100);
+}
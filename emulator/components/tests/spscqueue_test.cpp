@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "spscqueue.h"
+
+// Test values come out in order and a full queue refuses more
+TEST(ComponentSPSCQueue, FillAndDrain)
+{
+    emulator::component::SPSCQueue<int, 4> queue;
+
+    int value = 0;
+    ASSERT_FALSE(queue.TryPop(value));
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPush(i));
+    }
+    ASSERT_FALSE(queue.TryPush(4));
+    ASSERT_EQ(queue.Size(), 4);
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_TRUE(queue.Empty());
+
+    queue.TryPush(5);
+    queue.Clear();
+    ASSERT_FALSE(queue.TryPop(value));
+}
+
+// Test every value crosses between threads exactly once, in order
+TEST(ComponentSPSCQueue, Threaded)
+{
+    static constexpr int kValues = 100000;
+    emulator::component::SPSCQueue<int, 64> queue;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < kValues; i++) {
+            while (!queue.TryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < kValues) {
+        int value;
+        if (queue.TryPop(value)) {
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(queue.Empty());
+}
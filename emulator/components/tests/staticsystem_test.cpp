@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "staticsystem.h"
+
+namespace
+{
+
+std::vector<char> tickOrder;
+
+template <char Name>
+class OrderedComponent : public emulator::component::IComponent
+{
+public:
+    std::uint64_t ticks{0};
+
+    OrderedComponent() : IComponent(ComponentType::Other) {}
+
+    void ReceiveTick() override
+    {
+        ++ticks;
+        tickOrder.push_back(Name);
+    }
+
+    void PowerOn() noexcept override {}
+    void PowerOff() noexcept override {}
+};
+
+using ComponentA = OrderedComponent<'A'>;
+using ComponentB = OrderedComponent<'B'>;
+
+}; // namespace
+
+using emulator::component::StaticSystem;
+
+// Test components are ticked in template order through the static loop
+TEST(ComponentStaticSystem, TicksInOrder)
+{
+    auto a = new ComponentA();
+    auto b = new ComponentB();
+    StaticSystem<ComponentB, ComponentA> system("Static", 1000, {{"A", a}, {"B", b}});
+    system.PowerOn();
+    ASSERT_TRUE(system.GetBus().HasTickLoop());
+
+    tickOrder.clear();
+    system.GetBus().ReceiveTick();
+    system.GetBus().ReceiveTick();
+    ASSERT_EQ(tickOrder, (std::vector<char>{'B', 'A', 'B', 'A'}));
+    ASSERT_EQ(a->ticks, 2);
+    ASSERT_EQ(b->ticks, 2);
+
+    system.UseDynamicTick();
+    ASSERT_FALSE(system.GetBus().HasTickLoop());
+    system.GetBus().ReceiveTick();
+    ASSERT_EQ(a->ticks, 3);
+    ASSERT_EQ(b->ticks, 3);
+}
+
+// Test every tickable component has to be named in the template
+TEST(ComponentStaticSystem, RejectsMissingTickable)
+{
+    using System = StaticSystem<ComponentA>;
+    ASSERT_THROW(System("Static", 1000, {{"A", new ComponentA()}, {"B", new ComponentB()}}), std::invalid_argument);
+    ASSERT_THROW(System("Static", 1000, {{"B", new ComponentB()}}), std::invalid_argument);
+}
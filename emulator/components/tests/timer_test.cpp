@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "bus.h"
+#include "timer.h"
+
+// Test counter derived from elapsed bus ticks
+TEST(ComponentTimer, CounterDecrementsPerSample)
+{
+    auto bus = emulator::component::Bus();
+    auto timer = new emulator::component::Timer("Delay", 8);
+
+    bus.AddComponent(timer);
+    bus.PowerOn();
+
+    timer->SetCounter(3);
+    ASSERT_EQ(timer->GetCounter(), 3);
+
+    for (int i = 0; i < 8; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(timer->GetCounter(), 2);
+
+    for (int i = 0; i < 7; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(timer->GetCounter(), 2);
+
+    bus.ReceiveTick();
+    ASSERT_EQ(timer->GetCounter(), 1);
+
+    for (int i = 0; i < 100; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(timer->GetCounter(), 0);
+}
+
+// Test completion callback fires once when counter expires
+TEST(ComponentTimer, CompletionCallback)
+{
+    auto bus = emulator::component::Bus();
+    auto timer = new emulator::component::Timer("Sound", 4);
+
+    int fired = 0;
+    timer->RegisterCompletionCallback([&fired]() { fired++; });
+
+    bus.AddComponent(timer);
+    bus.PowerOn();
+
+    timer->SetCounter(2);
+    for (int i = 0; i < 7; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(fired, 0);
+
+    bus.ReceiveTick();
+    ASSERT_EQ(fired, 1);
+
+    for (int i = 0; i < 32; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(fired, 1);
+}
+
+// Test reloading counter before expiry replaces the pending completion
+TEST(ComponentTimer, ReloadBeforeCompletion)
+{
+    auto bus = emulator::component::Bus();
+    auto timer = new emulator::component::Timer("Delay", 1, 5);
+
+    int fired = 0;
+    timer->RegisterCompletionCallback([&fired]() { fired++; });
+
+    bus.AddComponent(timer);
+    bus.PowerOn();
+    ASSERT_EQ(timer->GetCounter(), 5);
+
+    bus.ReceiveTick();
+    bus.ReceiveTick();
+    timer->SetCounter(4);
+
+    for (int i = 0; i < 3; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(fired, 0);
+    ASSERT_EQ(timer->GetCounter(), 1);
+
+    bus.ReceiveTick();
+    ASSERT_EQ(fired, 1);
+
+    timer->Reset();
+    ASSERT_EQ(timer->GetCounter(), 5);
+}
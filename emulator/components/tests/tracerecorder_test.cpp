@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "tracerecorder.h"
+
+using emulator::component::TraceReader;
+using emulator::component::TraceRecorder;
+
+struct TestRegister {
+    std::string_view name;
+    std::uint64_t value;
+};
+
+class ComponentTraceRecorder : public ::testing::Test
+{
+protected:
+    std::string path_;
+
+    virtual void SetUp()
+    {
+        path_ = (std::filesystem::temp_directory_path() /
+                 std::format("trace_test_{}.bin", ::testing::UnitTest::GetInstance()->current_test_info()->name()))
+                    .string();
+    }
+
+    virtual void TearDown()
+    {
+        std::remove(path_.c_str());
+    }
+};
+
+// Test records decode back to what was recorded, across many buffer wraps
+TEST_F(ComponentTraceRecorder, RoundTrip)
+{
+    std::vector<TestRegister> registers = {{"A", 0}, {"PC", 0}, {"SP", 0xFFFE}};
+    std::vector<TraceReader::Record> expected;
+
+    {
+        TraceRecorder recorder(path_, TraceRecorder::kMinBufferSize);
+        std::uint64_t cycle = 0;
+        for (std::uint64_t i = 0; i < 100000; i++) {
+            std::uint64_t pc = 0x100 + (i % 37) * 3;
+            registers[0].value = i & 0xFF;
+            registers[1].value = pc;
+            if (i % 1000 == 0) {
+                registers[2].value -= 2;
+            }
+            cycle += 4 + (i % 3) * 4;
+
+            recorder.Record(cycle, pc, std::uint32_t(i % 0x1FF), registers);
+            expected.push_back({cycle, pc, std::uint32_t(i % 0x1FF), {registers[0].value, registers[1].value, registers[2].value}});
+        }
+        recorder.Stop();
+
+        ASSERT_EQ(recorder.GetStats().records, expected.size());
+        ASSERT_EQ(recorder.GetStats().bytes, std::filesystem::file_size(path_));
+    }
+
+    std::ifstream file(path_, std::ios::binary);
+    TraceReader reader(file);
+    ASSERT_EQ(reader.RegisterNames(), std::vector<std::string>({"A", "PC", "SP"}));
+
+    TraceReader::Record record;
+    for (auto& want : expected) {
+        ASSERT_TRUE(reader.Next(record));
+        ASSERT_EQ(record.cycle, want.cycle);
+        ASSERT_EQ(record.pc, want.pc);
+        ASSERT_EQ(record.opcode, want.opcode);
+        ASSERT_EQ(record.registers, want.registers);
+    }
+    ASSERT_FALSE(reader.Next(record));
+}
+
+// Test unchanged registers cost nothing beyond the mask
+TEST_F(ComponentTraceRecorder, DeltaEncoding)
+{
+    std::vector<TestRegister> registers = {{"A", 0}, {"B", 0}};
+    TraceRecorder recorder(path_);
+
+    recorder.Record(4, 0x100, 0x00, registers);
+    auto header = recorder.GetStats().bytes;
+
+    // Cycle +4, PC +1, opcode, empty mask
+    recorder.Record(8, 0x101, 0x00, registers);
+    ASSERT_EQ(recorder.GetStats().bytes - header, 4);
+}
+
+// Test files that are not traces are rejected
+TEST(ComponentTraceReader, RejectsBadMagic)
+{
+    std::istringstream in("NOTATRACE");
+    ASSERT_THROW(TraceReader reader(in), std::runtime_error);
+}
@@ -1,12 +1,21 @@
 #pragma once
 
+#include "bus.h"
 #include "component.h"
+#include "scheduler.h"
 
 #include <functional>
 
 namespace emulator::component
 {
 
+/**
+ * Down counter that decrements once every `tickSampling` bus ticks.
+ *
+ * The timer does not take part in the tick loop. It remembers the cycle the
+ * counter was last loaded on and derives the current value from the bus
+ * scheduler when read, while completion is signalled by a scheduled event.
+ */
 class Timer : public IComponent
 {
 public:
@@ -15,66 +24,134 @@ public:
 protected:
     std::string name_;
 
-    std::uint32_t tickCtr_{0};
     std::uint32_t tickSampling_;
 
-    std::uint32_t counter_{0};
+    Scheduler::Cycle startCycle_{0};
+    std::uint32_t startValue_{0};
     std::uint32_t resetValue_{0};
+
+    Scheduler::EventID completionEvent_{Scheduler::kInvalidEvent};
     TriggerCallbackFunc onCompleteCallback_{nullptr};
 
+    Scheduler::Cycle Now() const noexcept
+    {
+        if (bus_ == nullptr) {
+            return startCycle_;
+        }
+        return bus_->GetScheduler().Now();
+    }
+
+    void CancelCompletion() noexcept
+    {
+        if (completionEvent_ != Scheduler::kInvalidEvent && bus_ != nullptr) {
+            bus_->GetScheduler().Cancel(completionEvent_);
+        }
+        completionEvent_ = Scheduler::kInvalidEvent;
+    }
+
+    void ScheduleCompletion()
+    {
+        CancelCompletion();
+        if (!onCompleteCallback_ || bus_ == nullptr) {
+            return;
+        }
+
+        auto deadline = startCycle_ + Scheduler::Cycle(startValue_) * tickSampling_;
+        completionEvent_ = bus_->GetScheduler().ScheduleAt(deadline, [this]() {
+            completionEvent_ = Scheduler::kInvalidEvent;
+            onCompleteCallback_();
+        });
+    }
+
 public:
     Timer(std::string name) : Timer(name, 1, 0) {}
     Timer(std::string name, std::uint32_t tickSampling) : Timer(name, tickSampling, 0) {}
     Timer(std::string name, std::uint32_t tickSampling, std::uint32_t resetValue)
         : IComponent(IComponent::ComponentType::Timer),
-          name_(name), tickSampling_(tickSampling), resetValue_(resetValue) {}
+          name_(name), tickSampling_(tickSampling == 0 ? 1 : tickSampling), resetValue_(resetValue) {}
+
+    ~Timer()
+    {
+        CancelCompletion();
+    }
 
     void RegisterCompletionCallback(TriggerCallbackFunc func) noexcept
     {
         onCompleteCallback_ = func;
+        ScheduleCompletion();
     }
 
     void ReceiveTick() override
     {
-        // Sample the tick counter to enable variable tick rates on system
-        if (tickCtr_ == 0) {
-            tickCtr_ = tickSampling_;
-        } else {
-            tickCtr_--;
-            return;
-        }
+    }
 
-        if (counter_ == 0) {
-            if (onCompleteCallback_) {
-                onCompleteCallback_();
-            }
-        } else {
-            counter_--;
-        }
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
+    void RemoveFromBus() override
+    {
+        CancelCompletion();
+        bus_ = nullptr;
     }
 
     void PowerOn() noexcept override
     {
-        counter_ = resetValue_;
+        SetCounter(resetValue_);
     }
 
     void PowerOff() noexcept override
     {
+        CancelCompletion();
     }
 
     void Reset() noexcept
     {
-        counter_ = resetValue_;
+        SetCounter(resetValue_);
+    }
+
+    // The completion event itself is restored with the scheduler
+    void SaveState(StateWriter& state) const override
+    {
+        state.Write(startCycle_);
+        state.Write(startValue_);
+        state.Write(completionEvent_);
+    }
+
+    void LoadState(StateReader& state) override
+    {
+        state.Read(startCycle_);
+        state.Read(startValue_);
+        state.Read(completionEvent_);
     }
 
     void SetCounter(std::uint32_t value) noexcept
     {
-        counter_ = value;
+        startCycle_ = Now();
+        startValue_ = value;
+        ScheduleCompletion();
     }
 
     std::uint32_t GetCounter() const noexcept
     {
-        return counter_;
+        auto elapsed = (Now() - startCycle_) / tickSampling_;
+        return elapsed >= startValue_ ? 0 : static_cast<std::uint32_t>(startValue_ - elapsed);
+    }
+
+    std::uint32_t GetTickSampling() const noexcept
+    {
+        return tickSampling_;
+    }
+
+    // Bus cycles until the counter next decrements, kNever once expired
+    Scheduler::Cycle CyclesUntilChange() const noexcept
+    {
+        auto elapsed = Now() - startCycle_;
+        if (elapsed / tickSampling_ >= startValue_) {
+            return Scheduler::kNever;
+        }
+        return tickSampling_ - elapsed % tickSampling_;
     }
 
     std::string GetName() const noexcept
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace emulator::component
+{
+
+/**
+ * Compact binary encoding of per-instruction CPU traces.
+ *
+ * A trace starts with a header naming the registers, followed by one record
+ * per instruction. Every field of a record is a LEB128 varint and all but the
+ * opcode are deltas against the previous record:
+ *
+ *   cycle delta, zigzag PC delta, opcode, changed register mask,
+ *   zigzag delta of each changed register (lowest bit first)
+ */
+namespace trace
+{
+
+static constexpr char kMagic[8] = {'E', 'M', 'U', 'T', 'R', 'A', 'C', 'E'};
+static constexpr std::uint8_t kVersion = 1;
+static constexpr std::size_t kMaxRegisters = 64;
+
+// Varint of a 64-bit value is at most 10 bytes
+static constexpr std::size_t kMaxRecordSize = 10 * (4 + kMaxRegisters);
+
+inline std::uint8_t* PutVarint(std::uint8_t* out, std::uint64_t value) noexcept
+{
+    while (value >= 0x80) {
+        *out++ = std::uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = std::uint8_t(value);
+    return out;
+}
+
+constexpr std::uint64_t ZigZag(std::uint64_t delta) noexcept
+{
+    return (delta << 1) ^ (0 - (delta >> 63));
+}
+
+constexpr std::uint64_t UnZigZag(std::uint64_t value) noexcept
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+}; // namespace trace
+
+/**
+ * Records instruction traces to a file without stalling the emulation.
+ *
+ * The emulation thread encodes records into a lock-free single producer,
+ * single consumer ring buffer and a background thread drains it to disk.
+ * When the disk can not keep up the producer waits rather than dropping
+ * records, so a trace is always complete.
+ */
+class TraceRecorder
+{
+public:
+    static constexpr std::size_t kDefaultBufferSize = 16 * 1024 * 1024;
+
+    // Room for the largest header
+    static constexpr std::size_t kMinBufferSize = 64 * 1024;
+
+    struct Stats {
+        std::uint64_t records{0};
+        std::uint64_t bytes{0};
+
+        // Times the producer found the buffer full
+        std::uint64_t stalls{0};
+    };
+
+private:
+    std::ofstream file_;
+
+    std::unique_ptr<std::uint8_t[]> buffer_;
+    std::size_t mask_;
+
+    // Monotonic positions, wrapped with mask_ when indexing
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t cachedTail_{0};
+
+    std::atomic<bool> stopping_{false};
+    std::thread writer_;
+
+    bool headerWritten_{false};
+    std::uint64_t lastCycle_{0};
+    std::uint64_t lastPC_{0};
+    std::vector<std::uint64_t> lastRegisters_;
+
+    Stats stats_;
+
+    void Push(const std::uint8_t* data, std::size_t size)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        while (head + size - cachedTail_ > mask_ + 1) [[unlikely]] {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head + size - cachedTail_ > mask_ + 1) {
+                ++stats_.stalls;
+                std::this_thread::yield();
+            }
+        }
+
+        auto offset = head & mask_;
+        auto first = std::min(size, mask_ + 1 - offset);
+        std::memcpy(&buffer_[offset], data, first);
+        std::memcpy(&buffer_[0], data + first, size - first);
+
+        head_.store(head + size, std::memory_order_release);
+        stats_.bytes += size;
+    }
+
+    void Drain()
+    {
+        while (true) {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            auto head = head_.load(std::memory_order_acquire);
+            if (head == tail) {
+                if (stopping_.load(std::memory_order_acquire) && head == head_.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            auto offset = tail & mask_;
+            auto first = std::min(head - tail, mask_ + 1 - offset);
+            file_.write(reinterpret_cast<const char*>(&buffer_[offset]), first);
+            file_.write(reinterpret_cast<const char*>(&buffer_[0]), head - tail - first);
+
+            tail_.store(head, std::memory_order_release);
+        }
+        file_.flush();
+    }
+
+    template <typename Registers>
+    void WriteHeader(const Registers& registers)
+    {
+        if (registers.size() > trace::kMaxRegisters) {
+            throw std::invalid_argument("Too many registers to trace");
+        }
+
+        std::vector<std::uint8_t> header(std::begin(trace::kMagic), std::end(trace::kMagic));
+        header.push_back(trace::kVersion);
+        header.push_back(std::uint8_t(registers.size()));
+        for (auto& reg : registers) {
+            header.push_back(std::uint8_t(std::min<std::size_t>(reg.name.size(), 0xFF)));
+            header.insert(header.end(), reg.name.begin(), reg.name.begin() + header.back());
+        }
+        Push(header.data(), header.size());
+
+        lastRegisters_.assign(registers.size(), 0);
+        headerWritten_ = true;
+    }
+
+public:
+    TraceRecorder(const std::string& path, std::size_t bufferSize = kDefaultBufferSize)
+        : file_(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!file_) {
+            throw std::runtime_error("Failed to open trace file: " + path);
+        }
+
+        // Power of two so positions wrap with a mask
+        bufferSize = std::bit_ceil(std::max(bufferSize, kMinBufferSize));
+        buffer_ = std::make_unique<std::uint8_t[]>(bufferSize);
+        mask_ = bufferSize - 1;
+
+        writer_ = std::thread([this]() { Drain(); });
+    }
+
+    ~TraceRecorder()
+    {
+        Stop();
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Flush everything recorded so far and close the file, no more records may be added
+    void Stop()
+    {
+        stopping_.store(true, std::memory_order_release);
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        file_.close();
+    }
+
+    const Stats& GetStats() const noexcept
+    {
+        return stats_;
+    }
+
+    // Registers is a range of {name, value}, the names and count must not change between records
+    template <typename Registers>
+    void Record(std::uint64_t cycle, std::uint64_t pc, std::uint32_t opcode, const Registers& registers)
+    {
+        if (!headerWritten_) [[unlikely]] {
+            WriteHeader(registers);
+        }
+
+        std::uint8_t record[trace::kMaxRecordSize];
+        auto out = trace::PutVarint(record, cycle - lastCycle_);
+        out = trace::PutVarint(out, trace::ZigZag(pc - lastPC_));
+        out = trace::PutVarint(out, opcode);
+
+        std::uint64_t changed = 0;
+        std::size_t i = 0;
+        for (auto& reg : registers) {
+            if (reg.value != lastRegisters_[i]) {
+                changed |= std::uint64_t(1) << i;
+            }
+            ++i;
+        }
+        out = trace::PutVarint(out, changed);
+
+        i = 0;
+        for (auto& reg : registers) {
+            if (reg.value != lastRegisters_[i]) {
+                out = trace::PutVarint(out, trace::ZigZag(reg.value - lastRegisters_[i]));
+                lastRegisters_[i] = reg.value;
+            }
+            ++i;
+        }
+
+        Push(record, out - record);
+
+        lastCycle_ = cycle;
+        lastPC_ = pc;
+        ++stats_.records;
+    }
+};
+
+/**
+ * Decodes a trace written by TraceRecorder.
+ */
+class TraceReader
+{
+public:
+    struct Record {
+        std::uint64_t cycle{0};
+        std::uint64_t pc{0};
+        std::uint32_t opcode{0};
+        std::vector<std::uint64_t> registers;
+    };
+
+private:
+    std::istream& in_;
+    std::vector<std::string> names_;
+    Record last_;
+
+    bool ReadVarint(std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = in_.get();
+            if (byte == std::istream::traits_type::eof()) {
+                if (shift != 0) {
+                    throw std::runtime_error("Trace ends mid record");
+                }
+                return false;
+            }
+            value |= std::uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        throw std::runtime_error("Malformed varint in trace");
+    }
+
+    std::uint64_t ReadField()
+    {
+        std::uint64_t value;
+        if (!ReadVarint(value)) {
+            throw std::runtime_error("Trace ends mid record");
+        }
+        return value;
+    }
+
+public:
+    TraceReader(std::istream& in) : in_(in)
+    {
+        char magic[sizeof(trace::kMagic)];
+        if (!in_.read(magic, sizeof(magic)) || std::memcmp(magic, trace::kMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a trace file");
+        }
+
+        auto version = in_.get();
+        if (version != trace::kVersion) {
+            throw std::runtime_error("Unsupported trace version " + std::to_string(version));
+        }
+
+        auto count = in_.get();
+        for (int i = 0; i < count; i++) {
+            std::string name(in_.get(), '\0');
+            in_.read(name.data(), name.size());
+            names_.push_back(std::move(name));
+        }
+        if (!in_) {
+            throw std::runtime_error("Truncated trace header");
+        }
+        last_.registers.assign(names_.size(), 0);
+    }
+
+    const std::vector<std::string>& RegisterNames() const noexcept
+    {
+        return names_;
+    }
+
+    // False at the end of the trace
+    bool Next(Record& record)
+    {
+        std::uint64_t cycleDelta;
+        if (!ReadVarint(cycleDelta)) {
+            return false;
+        }
+
+        last_.cycle += cycleDelta;
+        last_.pc += trace::UnZigZag(ReadField());
+        last_.opcode = std::uint32_t(ReadField());
+
+        auto changed = ReadField();
+        for (std::size_t i = 0; i < last_.registers.size(); i++) {
+            if (changed & (std::uint64_t(1) << i)) {
+                last_.registers[i] += trace::UnZigZag(ReadField());
+            }
+        }
+
+        record = last_;
+        return true;
+    }
+};
+
+}; // namespace emulator::component
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace emulator::component
+{
+
+/**
+ * 16-bit PCM WAV file, written as samples arrive and finished when closed.
+ */
+class WavWriter
+{
+private:
+    std::ofstream file_;
+    std::uint16_t channels_;
+    std::uint32_t dataBytes_{0};
+
+    void Put16(std::uint16_t value)
+    {
+        file_.put(char(value & 0xFF));
+        file_.put(char(value >> 8));
+    }
+
+    void Put32(std::uint32_t value)
+    {
+        Put16(std::uint16_t(value & 0xFFFF));
+        Put16(std::uint16_t(value >> 16));
+    }
+
+public:
+    // Throws std::runtime_error if path can not be written
+    WavWriter(const std::string& path, std::uint32_t sampleRate, std::uint16_t channels = 1)
+        : file_(path, std::ios::binary | std::ios::trunc), channels_(channels)
+    {
+        if (!file_) {
+            throw std::runtime_error("Failed to open WAV file: " + path);
+        }
+
+        // Sizes are patched in once known
+        file_.write("RIFF", 4);
+        Put32(0);
+        file_.write("WAVEfmt ", 8);
+        Put32(16);
+        Put16(1); // PCM
+        Put16(channels_);
+        Put32(sampleRate);
+        Put32(sampleRate * channels_ * sizeof(std::int16_t));
+        Put16(std::uint16_t(channels_ * sizeof(std::int16_t)));
+        Put16(16);
+        file_.write("data", 4);
+        Put32(0);
+    }
+
+    ~WavWriter()
+    {
+        Close();
+    }
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    // Interleaved when there is more than one channel
+    void Write(std::span<const std::int16_t> samples)
+    {
+        for (auto sample : samples) {
+            Put16(std::uint16_t(sample));
+        }
+        dataBytes_ += std::uint32_t(samples.size_bytes());
+    }
+
+    void Close()
+    {
+        if (!file_.is_open()) {
+            return;
+        }
+
+        file_.seekp(4);
+        Put32(36 + dataBytes_);
+        file_.seekp(40);
+        Put32(dataBytes_);
+        file_.close();
+    }
+};
+
+}; // namespace emulator::component
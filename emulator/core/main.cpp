@@ -1,7 +1,9 @@
+#include <cstdlib>
 #include <spdlog/spdlog.h>
 
 #include "emumanager.h"
 
+#include <components/log.h>
 #include <debugger/debugger.h>
 #include <frontend.h>
 
@@ -14,6 +16,13 @@ int main()
     spdlog::set_level(spdlog::level::trace);
     spdlog::set_pattern("[%Y-%m-%d %T.%e] [%^%l%$] %v");
 
+    // Per-subsystem filters, e.g. EMULATOR_LOG="bus=off,cpu=debug"
+    if (auto config = std::getenv("EMULATOR_LOG")) {
+        if (!emulator::log::Configure(config)) {
+            spdlog::warn("Ignoring unrecognised entries in EMULATOR_LOG: {}", config);
+        }
+    }
+
     // Load all emulators
     auto manager = new emulator::core::EmulatorManager();
     for (const auto& emulator : emulators) {
@@ -0,0 +1,468 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace emulator::debugger
+{
+
+/**
+ * Breakpoint condition compiled to a small stack bytecode, so it is checked on the
+ * emulation thread each time the breakpoint is reached instead of stopping for gdb.
+ *
+ * Grammar, loosest binding first:
+ *   expr    := and ('||' and)*
+ *   and     := compare ('&&' compare)*
+ *   compare := term (('==' | '!=' | '<' | '<=' | '>' | '>=') term)?
+ *   term    := unary (('+' | '-' | '&' | '|' | '^') unary)*
+ *   unary   := '!' unary | '[' expr ']' | '(' expr ')' | number | 'hits' | register
+ *
+ * Numbers are decimal or 0x prefixed hex, [addr] reads a byte and hits counts the
+ * times the breakpoint has been reached, including this one.
+ */
+class Condition
+{
+public:
+    // Deepest evaluation stack a condition may need
+    static constexpr std::size_t kMaxStack = 16;
+
+    // Maps a register name to the index passed to ReadRegister, -1 if unknown
+    using RegisterLookup = std::function<int(std::string_view)>;
+
+private:
+    enum class Op : std::uint8_t {
+        Const,
+        Register,
+        Hits,
+        Load,
+        Not,
+        Add,
+        Sub,
+        And,
+        Or,
+        Xor,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        LogicalAnd,
+        LogicalOr,
+    };
+
+    struct Instruction {
+        Op op;
+        std::uint64_t operand;
+    };
+
+    std::vector<Instruction> code_;
+    std::string source_;
+
+    class Compiler
+    {
+    private:
+        std::string_view source_;
+        std::size_t pos_{0};
+        const RegisterLookup& lookup_;
+
+        std::vector<Instruction>& code_;
+        std::size_t depth_{0};
+
+        [[noreturn]] void Fail(std::string_view reason) const
+        {
+            throw std::invalid_argument(std::string(reason) + " at column " + std::to_string(pos_ + 1) +
+                                        " of condition '" + std::string(source_) + "'");
+        }
+
+        void SkipSpace() noexcept
+        {
+            while (pos_ < source_.size() && std::isspace(static_cast<unsigned char>(source_[pos_]))) {
+                pos_++;
+            }
+        }
+
+        // Consume token if it is next, and not just the start of a longer operator
+        bool Accept(std::string_view token) noexcept
+        {
+            SkipSpace();
+            if (!source_.substr(pos_).starts_with(token)) {
+                return false;
+            }
+
+            if (token.size() == 1 && pos_ + 1 < source_.size()) {
+                auto next = source_[pos_ + 1];
+                if ((token[0] == '&' && next == '&') || (token[0] == '|' && next == '|') ||
+                    ((token[0] == '<' || token[0] == '>' || token[0] == '!') && next == '=')) {
+                    return false;
+                }
+            }
+            pos_ += token.size();
+            return true;
+        }
+
+        void Emit(Op op, std::uint64_t operand = 0)
+        {
+            switch (op) {
+            case Op::Const:
+            case Op::Register:
+            case Op::Hits:
+                if (++depth_ > kMaxStack) {
+                    Fail("Too deeply nested");
+                }
+                break;
+            case Op::Load:
+            case Op::Not:
+                break;
+            default:
+                depth_--;
+                break;
+            }
+            code_.push_back({op, operand});
+        }
+
+        void Expression()
+        {
+            And();
+            while (Accept("||")) {
+                And();
+                Emit(Op::LogicalOr);
+            }
+        }
+
+        void And()
+        {
+            Compare();
+            while (Accept("&&")) {
+                Compare();
+                Emit(Op::LogicalAnd);
+            }
+        }
+
+        void Compare()
+        {
+            static constexpr std::pair<std::string_view, Op> kOperators[] = {
+                {"==", Op::Equal},
+                {"!=", Op::NotEqual},
+                {"<=", Op::LessEqual},
+                {">=", Op::GreaterEqual},
+                {"<", Op::Less},
+                {">", Op::Greater},
+            };
+
+            Term();
+            for (const auto& [token, op] : kOperators) {
+                if (Accept(token)) {
+                    Term();
+                    Emit(op);
+                    break;
+                }
+            }
+        }
+
+        void Term()
+        {
+            static constexpr std::pair<std::string_view, Op> kOperators[] = {
+                {"+", Op::Add},
+                {"-", Op::Sub},
+                {"&", Op::And},
+                {"|", Op::Or},
+                {"^", Op::Xor},
+            };
+
+            Unary();
+            for (bool matched = true; matched;) {
+                matched = false;
+                for (const auto& [token, op] : kOperators) {
+                    if (Accept(token)) {
+                        Unary();
+                        Emit(op);
+                        matched = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        void Unary()
+        {
+            if (Accept("!")) {
+                Unary();
+                Emit(Op::Not);
+            } else if (Accept("[")) {
+                Expression();
+                if (!Accept("]")) {
+                    Fail("Expected ']'");
+                }
+                Emit(Op::Load);
+            } else if (Accept("(")) {
+                Expression();
+                if (!Accept(")")) {
+                    Fail("Expected ')'");
+                }
+            } else {
+                Operand();
+            }
+        }
+
+        void Operand()
+        {
+            SkipSpace();
+            auto start = pos_;
+            while (pos_ < source_.size() && (std::isalnum(static_cast<unsigned char>(source_[pos_])) || source_[pos_] == '_')) {
+                pos_++;
+            }
+
+            auto word = source_.substr(start, pos_ - start);
+            if (word.empty()) {
+                Fail("Expected a value");
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(word[0]))) {
+                int base = 10;
+                if (word.size() > 2 && word[0] == '0' && (word[1] == 'x' || word[1] == 'X')) {
+                    word.remove_prefix(2);
+                    base = 16;
+                }
+
+                std::uint64_t value = 0;
+                auto [end, ec] = std::from_chars(word.data(), word.data() + word.size(), value, base);
+                if (ec != std::errc() || end != word.data() + word.size()) {
+                    pos_ = start;
+                    Fail("Invalid number");
+                }
+                Emit(Op::Const, value);
+            } else if (word == "hits") {
+                Emit(Op::Hits);
+            } else {
+                auto index = lookup_ ? lookup_(word) : -1;
+                if (index < 0) {
+                    pos_ = start;
+                    Fail("Unknown register");
+                }
+                Emit(Op::Register, static_cast<std::uint64_t>(index));
+            }
+        }
+
+    public:
+        Compiler(std::string_view source, const RegisterLookup& lookup, std::vector<Instruction>& code)
+            : source_(source), lookup_(lookup), code_(code)
+        {
+        }
+
+        void Compile()
+        {
+            Expression();
+            SkipSpace();
+            if (pos_ != source_.size()) {
+                Fail("Unexpected character");
+            }
+        }
+    };
+
+    static std::uint64_t Apply(Op op, std::uint64_t lhs, std::uint64_t rhs) noexcept
+    {
+        switch (op) {
+        case Op::Add:
+            return lhs + rhs;
+        case Op::Sub:
+            return lhs - rhs;
+        case Op::And:
+            return lhs & rhs;
+        case Op::Or:
+            return lhs | rhs;
+        case Op::Xor:
+            return lhs ^ rhs;
+        case Op::Equal:
+            return lhs == rhs;
+        case Op::NotEqual:
+            return lhs != rhs;
+        case Op::Less:
+            return lhs < rhs;
+        case Op::LessEqual:
+            return lhs <= rhs;
+        case Op::Greater:
+            return lhs > rhs;
+        case Op::GreaterEqual:
+            return lhs >= rhs;
+        case Op::LogicalAnd:
+            return lhs && rhs;
+        case Op::LogicalOr:
+            return lhs || rhs;
+        default:
+            return 0;
+        }
+    }
+
+public:
+    // Always true
+    Condition() = default;
+
+    // Throws std::invalid_argument describing the first error in source
+    static Condition Compile(std::string_view source, const RegisterLookup& lookup)
+    {
+        Condition condition;
+        Compiler(source, lookup, condition.code_).Compile();
+        condition.source_ = source;
+        return condition;
+    }
+
+    bool Empty() const noexcept { return code_.empty(); }
+    const std::string& GetSource() const noexcept { return source_; }
+
+    // Target provides ReadRegister(int) and ReadMemory(address, span), as ISystemDebugger does
+    template <typename Target>
+    bool Evaluate(const Target& target, std::uint64_t hits) const noexcept
+    {
+        if (code_.empty()) {
+            return true;
+        }
+
+        std::array<std::uint64_t, kMaxStack> stack;
+        std::size_t sp = 0;
+        for (const auto& [op, operand] : code_) {
+            switch (op) {
+            case Op::Const:
+                stack[sp++] = operand;
+                break;
+            case Op::Register:
+                stack[sp++] = target.ReadRegister(static_cast<int>(operand));
+                break;
+            case Op::Hits:
+                stack[sp++] = hits;
+                break;
+            case Op::Load: {
+                // Unmapped addresses read as 0
+                std::uint8_t byte = 0;
+                target.ReadMemory(stack[sp - 1], std::span<std::uint8_t>(&byte, 1));
+                stack[sp - 1] = byte;
+                break;
+            }
+            case Op::Not:
+                stack[sp - 1] = !stack[sp - 1];
+                break;
+            default:
+                sp--;
+                stack[sp - 1] = Apply(op, stack[sp - 1], stack[sp]);
+                break;
+            }
+        }
+        return stack[0] != 0;
+    }
+};
+
+/**
+ * Software breakpoints, looked up through a bitmap per 256 byte page so the check
+ * at every instruction fetch is a page lookup and a bit test.
+ */
+class BreakpointTable
+{
+private:
+    static constexpr std::size_t kPageBits = 8;
+    using Page = std::bitset<1 << kPageBits>;
+
+    struct Breakpoint {
+        Condition condition;
+        std::uint64_t hits{0};
+    };
+
+    std::unordered_map<std::uint64_t, Page> pages_;
+    std::unordered_map<std::uint64_t, Breakpoint> breakpoints_;
+
+    // Last page looked up, execution tends to stay within one for a while
+    mutable std::uint64_t cachedPage_{~0ull};
+    mutable const Page* cachedBits_{nullptr};
+
+    void InvalidateCache() noexcept
+    {
+        cachedPage_ = ~0ull;
+        cachedBits_ = nullptr;
+    }
+
+public:
+    // Replaces any breakpoint already at address, resetting its hit count
+    void Add(std::uint64_t address, Condition condition = {})
+    {
+        breakpoints_[address] = {std::move(condition), 0};
+        pages_[address >> kPageBits].set(address & ((1 << kPageBits) - 1));
+        InvalidateCache();
+    }
+
+    bool Remove(std::uint64_t address) noexcept
+    {
+        if (breakpoints_.erase(address) == 0) {
+            return false;
+        }
+
+        auto page = pages_.find(address >> kPageBits);
+        page->second.reset(address & ((1 << kPageBits) - 1));
+        if (page->second.none()) {
+            pages_.erase(page);
+        }
+        InvalidateCache();
+        return true;
+    }
+
+    void Clear() noexcept
+    {
+        breakpoints_.clear();
+        pages_.clear();
+        InvalidateCache();
+    }
+
+    bool Empty() const noexcept { return breakpoints_.empty(); }
+    std::size_t Size() const noexcept { return breakpoints_.size(); }
+
+    bool Contains(std::uint64_t address) const noexcept
+    {
+        auto page = address >> kPageBits;
+        if (page != cachedPage_) {
+            auto it = pages_.find(page);
+            cachedPage_ = page;
+            cachedBits_ = it == pages_.end() ? nullptr : &it->second;
+        }
+        return cachedBits_ != nullptr && cachedBits_->test(address & ((1 << kPageBits) - 1));
+    }
+
+    std::uint64_t GetHits(std::uint64_t address) const noexcept
+    {
+        auto it = breakpoints_.find(address);
+        return it == breakpoints_.end() ? 0 : it->second.hits;
+    }
+
+    // Whether reaching address would stop execution, without counting it as a hit
+    template <typename Target>
+    bool WouldHit(std::uint64_t address, const Target& target) const noexcept
+    {
+        if (breakpoints_.empty() || !Contains(address)) [[likely]] {
+            return false;
+        }
+
+        auto& breakpoint = breakpoints_.find(address)->second;
+        return breakpoint.condition.Evaluate(target, breakpoint.hits + 1);
+    }
+
+    // Count a hit of any breakpoint at address, returns whether execution should stop there
+    template <typename Target>
+    bool Hit(std::uint64_t address, const Target& target) noexcept
+    {
+        if (breakpoints_.empty() || !Contains(address)) [[likely]] {
+            return false;
+        }
+
+        auto& breakpoint = breakpoints_.find(address)->second;
+        return breakpoint.condition.Evaluate(target, ++breakpoint.hits);
+    }
+};
+
+}; // namespace emulator::debugger
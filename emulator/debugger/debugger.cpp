@@ -2,26 +2,29 @@
 #include "gdbserver.h"
 
 #include "socket/client.h"
+#include "socket/poller.h"
 #include "socket/server.h"
 
 #include <chrono>
 
+#include <components/log.h>
+#include <spdlog/spdlog.h>
+
 namespace emulator::debugger
 {
 
 Debugger::Debugger()
-    : runServerThread_(false), currentDebugger_(nullptr)
+    : currentDebugger_(nullptr)
 {
 }
 
 Debugger::~Debugger()
 {
-    if (runServerThread_) {
-        runServerThread_ = false;
+    runServerThread_ = false;
+    Wake();
 
-        if (serverThread_.joinable()) {
-            serverThread_.join();
-        }
+    if (serverThread_.joinable()) {
+        serverThread_.join();
     }
 
     for (int i = 0; i < debuggers_.size(); i++) {
@@ -32,31 +35,145 @@ Debugger::~Debugger()
     }
 }
 
-void Debugger::StartRemote(std::uint16_t port, bool onlyLocalhost)
+std::uint16_t Debugger::StartRemote(std::uint16_t port, bool onlyLocalhost)
+{
+    return AddListener(nullptr, port, onlyLocalhost);
+}
+
+std::uint16_t Debugger::StartRemote(ISystemDebugger* target, std::uint16_t port, bool onlyLocalhost)
+{
+    if (target == nullptr) {
+        throw std::invalid_argument("Remote debugging needs a system debugger");
+    }
+    return AddListener(target, port, onlyLocalhost);
+}
+
+std::uint16_t Debugger::AddListener(ISystemDebugger* target, std::uint16_t port, bool onlyLocalhost)
 {
-    serverThread_ = std::thread{[&, this]() {
-        runServerThread_ = true;
-        socket::DebuggerSocketClient* client = nullptr;
-        auto server = socket::DebuggerSocketServer(port, onlyLocalhost);
-
-        while (runServerThread_) {
-            if (currentDebugger_ == nullptr) {
-                // Prevent doing anything until a system is chosen and debugger loaded
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // Bind here so failures reach the caller rather than the server thread
+    auto server = std::make_unique<socket::DebuggerSocketServer>(port, onlyLocalhost);
+    auto boundPort = server->GetPort();
+
+    {
+        std::lock_guard lock(pendingMutex_);
+        if (poller_ == nullptr) {
+            poller_ = std::make_unique<socket::Poller>();
+        }
+        pendingListeners_.push_back({std::move(server), target});
+    }
+
+    if (!runServerThread_.exchange(true)) {
+        serverThread_ = std::thread{[this]() { Serve(); }};
+    } else {
+        Wake();
+    }
+
+    spdlog::info("[Debugger] Listening for gdb on port {}", boundPort);
+    return boundPort;
+}
+
+void Debugger::Wake() noexcept
+{
+    if (poller_ != nullptr) {
+        poller_->Wake();
+    }
+}
+
+void Debugger::Serve() noexcept
+{
+    // Only a safety net, everything that needs the thread wakes it
+    static constexpr auto kWaitTimeout = std::chrono::seconds(1);
+
+    std::vector<socket::Poller::Event> events;
+    while (runServerThread_) {
+        AddPendingListeners();
+
+        if (!poller_->Wait(events, kWaitTimeout)) {
+            spdlog::critical("[Debugger] Waiting on sockets failed, stopping remote debugging");
+            break;
+        }
+
+        for (const auto& event : events) {
+            auto handle = static_cast<std::uint64_t>(event.socket);
+
+            if (auto listener = listeners_.find(handle); listener != listeners_.end()) {
+                AcceptConnection(listener->second);
                 continue;
             }
 
-            if (client == nullptr) {
-                client = server.Accept();
-            } else {
-                auto gdbserver = GDBServerConnection(this, client);
-                gdbserver.ServeWhile(runServerThread_);
+            auto connection = connections_.find(handle);
+            if (connection == connections_.end()) {
+                continue;
+            }
 
-                delete client;
-                client = nullptr;
+            if (!event.readable || !connection->second->OnReadable()) {
+                CloseConnection(handle);
             }
         }
-    }};
+
+        // Steps finished on emulation threads since the last wait
+        for (auto& [handle, connection] : connections_) {
+            connection->DeliverPendingStop();
+        }
+    }
+
+    connections_.clear();
+    listeners_.clear();
+}
+
+void Debugger::AddPendingListeners() noexcept
+{
+    std::lock_guard lock(pendingMutex_);
+    for (auto& listener : pendingListeners_) {
+        auto handle = static_cast<std::uint64_t>(listener.server->GetSocket());
+        if (!poller_->Add(listener.server->GetSocket())) {
+            spdlog::error("[Debugger] Failed watching listening socket");
+            continue;
+        }
+        listeners_.emplace(handle, std::move(listener));
+    }
+    pendingListeners_.clear();
+}
+
+void Debugger::AcceptConnection(Listener& listener) noexcept
+{
+    socket::DebuggerSocketClient* client = nullptr;
+    try {
+        client = listener.server->Accept();
+    } catch (std::exception& e) {
+        spdlog::error("[Debugger] Failed accepting connection: {}", e.what());
+    }
+    if (client == nullptr) {
+        return;
+    }
+
+    auto target = listener.target != nullptr ? listener.target : currentDebugger_.load();
+    if (target == nullptr) {
+        spdlog::warn("[Debugger] Refusing connection, no system is selected for debugging");
+        delete client;
+        return;
+    }
+
+    auto connection = std::make_unique<GDBServerConnection>(this, target, client);
+    if (!poller_->Add(connection->GetSocket())) {
+        spdlog::error("[Debugger] Failed watching connection");
+        return;
+    }
+
+    EMU_DEBUG(Debugger, "New connection for {}, {} open", target->GetName(), connections_.size() + 1);
+    connections_.emplace(static_cast<std::uint64_t>(connection->GetSocket()), std::move(connection));
+}
+
+void Debugger::CloseConnection(std::uint64_t handle) noexcept
+{
+    auto connection = connections_.find(handle);
+    if (connection == connections_.end()) {
+        return;
+    }
+
+    poller_->Remove(connection->second->GetSocket());
+    connections_.erase(connection);
+    EMU_DEBUG(Debugger, "Connection closed, {} open", connections_.size());
 }
 
 void Debugger::RegisterDebugger(ISystemDebugger* debugger) noexcept
@@ -2,20 +2,58 @@
 
 #include "sysdebugger.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace emulator::debugger
 {
 
+class GDBServerConnection;
+
+namespace socket
+{
+class DebuggerSocketServer;
+class Poller;
+}; // namespace socket
+
+/**
+ * Serves GDB remote connections for any number of systems from a single thread.
+ * Each listening port is either bound to one system's debugger or hands new
+ * connections whichever debugger is selected when they connect.
+ */
 class Debugger
 {
 private:
-    volatile bool runServerThread_;
+    struct Listener {
+        std::unique_ptr<socket::DebuggerSocketServer> server;
+        ISystemDebugger* target; // nullptr for the selected debugger
+    };
+
+    std::atomic<bool> runServerThread_{false};
     std::thread serverThread_;
+    std::unique_ptr<socket::Poller> poller_;
+
+    // Only touched by the server thread, keyed by socket handle
+    std::unordered_map<std::uint64_t, Listener> listeners_;
+    std::unordered_map<std::uint64_t, std::unique_ptr<GDBServerConnection>> connections_;
+
+    // Listeners started from other threads, picked up by the server thread
+    std::mutex pendingMutex_;
+    std::vector<Listener> pendingListeners_;
 
     std::vector<ISystemDebugger*> debuggers_;
-    ISystemDebugger* currentDebugger_;
+    std::atomic<ISystemDebugger*> currentDebugger_;
+
+    void Serve() noexcept;
+    void AddPendingListeners() noexcept;
+    void AcceptConnection(Listener&) noexcept;
+    void CloseConnection(std::uint64_t socket) noexcept;
+
+    std::uint16_t AddListener(ISystemDebugger* target, std::uint16_t port, bool onlyLocalhost);
 
 public:
     Debugger();
@@ -23,7 +61,14 @@ public:
 
     ISystemDebugger* GetCurrentDebugger() const { return currentDebugger_; };
 
-    void StartRemote(std::uint16_t port, bool onlyLocalhost = true);
+    // Listen for connections to whichever debugger is selected, returns the port bound
+    std::uint16_t StartRemote(std::uint16_t port, bool onlyLocalhost = true);
+
+    // Listen for connections to one system, port 0 picks a free port
+    std::uint16_t StartRemote(ISystemDebugger* target, std::uint16_t port, bool onlyLocalhost = true);
+
+    // Interrupt the server thread's wait, safe from any thread
+    void Wake() noexcept;
 
     void RegisterDebugger(ISystemDebugger*) noexcept;
     bool SelectDebugger(std::string name) noexcept;
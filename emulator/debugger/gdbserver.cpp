@@ -1,424 +1,380 @@
 #include "gdbserver.h"
-#include "utils.h"
 
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <limits>
+#include <stdexcept>
 #include <unordered_map>
 
+#include <components/log.h>
 #include <spdlog/spdlog.h>
 
 namespace emulator::debugger
 {
 
-GDBServerConnection::GDBServerConnection(Debugger* debugger, socket::DebuggerSocketClient* client) : debugger_(debugger), client_(client), state_(ConnectionState::PRECONNECT)
+GDBServerConnection::GDBServerConnection(Debugger* debugger, ISystemDebugger* target, socket::DebuggerSocketClient* client)
+    : debugger_(debugger), target_(target), client_(client), state_(ConnectionState::PRECONNECT)
 {
+    if (target_->SupportsReverse()) {
+        target_->EnableHistory(kDefaultHistoryInterval, kDefaultHistoryCheckpoints);
+    }
 }
 
 GDBServerConnection::~GDBServerConnection()
 {
 }
 
-void GDBServerConnection::ServeWhile(volatile bool& check) noexcept
+bool GDBServerConnection::OnReadable() noexcept
 {
-    if (client_ == nullptr) {
-        return;
-    }
-
-    while (check) {
-        switch (state_) {
-        case ConnectionState::PRECONNECT:
-            if (client_->IsReadable()) {
-                state_ = ConnectionState::HANDSHAKE;
-            }
-            break;
-        case ConnectionState::HANDSHAKE:
-            ProcessHandshakeMessage();
-            break;
-        case ConnectionState::RUNNING:
-            ProcessRunningMessage();
+    // Drain the socket, packets split across reads are picked up where they left off
+    while (state_ != ConnectionState::SHUTDOWN && state_ != ConnectionState::FATAL_ERROR) {
+        int n = client_->Read(receiveBuffer_);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
             break;
-        case ConnectionState::SHUTDOWN:
-            return;
-        case ConnectionState::FATAL_ERROR:
-            spdlog::critical("Fatal Error handling GDB connection");
-            return;
+        }
+
+        if (state_ == ConnectionState::PRECONNECT) {
+            state_ = ConnectionState::HANDSHAKE;
+        }
+
+        std::span<const std::uint8_t> input(receiveBuffer_.data(), n);
+        rsp::PacketParser::Event event;
+        while (state_ != ConnectionState::SHUTDOWN && parser_.Next(input, event)) {
+            ProcessEvent(event);
         }
     }
+
+    switch (state_) {
+    case ConnectionState::SHUTDOWN:
+        return false;
+    case ConnectionState::FATAL_ERROR:
+        spdlog::critical("Fatal Error handling GDB connection");
+        return false;
+    default:
+        return true;
+    }
 }
 
-bool GDBServerConnection::SendResponse(std::string& str) noexcept
+void GDBServerConnection::DeliverPendingStop() noexcept
 {
-    return SendResponse(str.c_str(), str.size());
+    if (stopPending_->exchange(false)) {
+        // Going back further than the history reaches stops at its start
+        SendSignal(kSIGTRAP, target_->AtHistoryStart() ? StopReason::REPLAYLOG_BEGIN : StopReason::NONE);
+    }
 }
 
-bool GDBServerConnection::SendResponse(const char* str, std::size_t len) noexcept
+std::function<void(void)> GDBServerConnection::StopCallback() noexcept
 {
-    if (!client_->IsWritable()) {
-        return false;
-    }
+    // Runs on the emulation thread, so only flag the stop and let the server thread reply
+    return [pending = stopPending_, debugger = debugger_]() {
+        pending->store(true);
+        debugger->Wake();
+    };
+}
+
+void GDBServerConnection::StepCPU() noexcept
+{
+    target_->StepCPU(1, StopCallback());
+}
+
+void GDBServerConnection::RunCPU() noexcept
+{
+    target_->RunCPU(StopCallback());
+}
 
+void GDBServerConnection::ReverseStepCPU() noexcept
+{
+    target_->ReverseStep(StopCallback());
+}
+
+void GDBServerConnection::ReverseRunCPU() noexcept
+{
+    target_->ReverseContinue(StopCallback());
+}
+
+bool GDBServerConnection::SendResponse(std::string_view payload) noexcept
+{
     std::uint8_t chksum = 0;
-    for (std::size_t i = 0; i < len; i++) {
-        chksum += str[i];
+    for (auto c : payload) {
+        chksum += static_cast<std::uint8_t>(c);
+    }
+    const char trailer[3] = {'#', rsp::kHexDigits[chksum >> 4], rsp::kHexDigits[chksum & 0xF]};
+
+    // The acknowledgement for the request rides along with its response
+    std::string_view header = ackPending_ ? "+$" : "$";
+    ackPending_ = false;
+
+    if (!QStartNoAckMode_) {
+        // Kept in case gdb asks for it again
+        lastResponse_.assign(payload);
     }
 
-    auto msg = std::format("{}${}#{:02X}", !QStartNoAckMode_ ? "+" : "", str, chksum);
-    return client_->Write(reinterpret_cast<const std::uint8_t*>(msg.c_str()), msg.size()) == msg.size();
+    auto len = header.size() + payload.size() + sizeof(trailer);
+    return client_->WriteV({header, payload, {trailer, sizeof(trailer)}}) == static_cast<int>(len);
 }
 
 bool GDBServerConnection::SendEmptyResponse() noexcept
 {
-    return SendResponse("", 0);
+    return SendResponse("");
 }
 
 bool GDBServerConnection::SendOKResponse() noexcept
 {
-    return SendResponse("OK", 2);
+    return SendResponse("OK");
+}
+
+bool GDBServerConnection::SendAck(bool valid) noexcept
+{
+    ackPending_ = false;
+    return client_->WriteV({valid ? "+" : "-"}) == 1;
 }
 
 bool GDBServerConnection::SendSignal(std::uint8_t signal, StopReason reason) noexcept
 {
-    std::string msg;
+    response_.clear();
 
     switch (reason) {
     case StopReason::NONE:
-        msg = std::format("S{:02X}", signal);
+        response_ += 'S';
+        rsp::AppendHex(response_, signal);
         break;
     case StopReason::HWBREAK:
-        msg = std::format("T{:02X}hwbreak:", kSIGTRAP);
+        response_ += 'T';
+        rsp::AppendHex(response_, kSIGTRAP);
+        response_ += "hwbreak:";
         break;
     case StopReason::WATCH:
-        msg = std::format("T{:02X}watch:{:04X}", kSIGTRAP, 0); // TODO: Get address of watch address
+        response_ += 'T';
+        rsp::AppendHex(response_, kSIGTRAP);
+        response_ += "watch:0000"; // TODO: Get address of watch address
+        break;
+    case StopReason::REPLAYLOG_BEGIN:
+        response_ += 'T';
+        rsp::AppendHex(response_, kSIGTRAP);
+        response_ += "replaylog:begin;";
         break;
     }
 
-    spdlog::debug("{}:{} Sending Signal: {}", __FUNCTION__, __LINE__, signal);
-    debugger_->GetCurrentDebugger()->HandleSignal(signal);
-    return SendResponse(msg);
+    EMU_DEBUG(Debugger, "{}:{} Sending Signal: {}", __FUNCTION__, __LINE__, signal);
+    target_->HandleSignal(signal);
+    return SendResponse(response_);
 }
 
 bool GDBServerConnection::SendTerminate(std::uint8_t signal) noexcept
 {
-    std::string msg = std::format("X{:02X}", signal);
-    return SendResponse(msg);
+    response_ = "X";
+    rsp::AppendHex(response_, signal);
+    return SendResponse(response_);
 }
 
-bool GDBServerConnection::SendDebugMessage(std::string str) noexcept
+bool GDBServerConnection::SendDebugMessage(std::string_view str) noexcept
 {
-    if (!debugger_->GetCurrentDebugger()->IsStopped()) {
+    if (!target_->IsStopped()) {
         return false;
     }
 
-    std::string msg = "O";
-    for (const auto& c : str) {
-        msg += std::format("{:02x}", static_cast<unsigned char>(c));
-    }
-    return SendResponse(msg);
+    response_ = "O";
+    rsp::AppendHex(response_, {reinterpret_cast<const std::uint8_t*>(str.data()), str.size()});
+    return SendResponse(response_);
 }
 
 bool GDBServerConnection::SendError(std::uint8_t code) noexcept
 {
-    auto msg = std::format("E{:02X}", code);
-    return SendResponse(msg);
+    response_ = "E";
+    rsp::AppendHex(response_, code);
+    return SendResponse(response_);
 }
 
-std::size_t GDBServerConnection::ExtractPacket(GDBPacket& pkt, std::uint8_t* buf, std::size_t len) noexcept
+void GDBServerConnection::ProcessEvent(const rsp::PacketParser::Event& event) noexcept
 {
-    // Scan for end of packet
-    std::size_t eop = 0;
-    std::uint8_t chksum = 0;
-    while (eop < len && buf[eop] != '#') {
-        chksum += buf[eop];
-        eop++;
-    }
-
-    if (eop + 2 >= len) {
-        pkt.valid = false;
-        return 0;
-    }
-
-    // Validate Checksum
-    char chksumStr[3] = {
-        char(buf[eop + 1]),
-        char(buf[eop + 2]),
-        '\0'};
-    pkt.chksum = static_cast<std::uint8_t>(std::strtoul(chksumStr, nullptr, 16) & 0xFF);
-    if (chksum != pkt.chksum) {
-        pkt.valid = false;
-        return 0;
-    }
-
-    pkt.data = std::string((char*)buf, eop);
-
-    pkt.valid = true;
-    return eop + 3;
-}
+    using EventType = rsp::PacketParser::EventType;
 
-void GDBServerConnection::ProcessHandshakeMessage() noexcept
-{
-    if (!client_->IsReadable()) {
-        return;
-    }
-
-    std::uint8_t* buf = nullptr;
-    int n = client_->ReadAll(&buf);
-    if (n <= 0 || buf == nullptr) {
-        if (n == -1) {
-            state_ = ConnectionState::SHUTDOWN;
+    switch (event.type) {
+    case EventType::Ack:
+        break;
+    case EventType::Nack:
+        if (!QStartNoAckMode_) {
+            EMU_DEBUG(Debugger, "{}:{} Resending last response", __FUNCTION__, __LINE__);
+            auto response = std::move(lastResponse_);
+            SendResponse(response);
         }
-        return;
-    }
-
-    std::size_t cursor = 0;
-    while (cursor < n && state_ == ConnectionState::HANDSHAKE) {
+        break;
+    case EventType::Interrupt:
+        EMU_TRACE(Debugger, "GDBServerConnection Recv: CTRL+C");
+        SendSignal(kSIGTRAP);
+        break;
+    case EventType::Invalid:
+        EMU_DEBUG(Debugger, "{}:{} Invalid Packet", __FUNCTION__, __LINE__);
         if (!QStartNoAckMode_) {
-            if (buf[cursor] == '+') [[likely]] {
-                cursor++;
-                alreadyProcessedAck_ = true;
-            } else if (!alreadyProcessedAck_) {
-                spdlog::debug("{}:{} Expected Ack Character", __FUNCTION__, __LINE__);
-                state_ = ConnectionState::FATAL_ERROR;
-                break;
-            }
+            SendAck(false);
         }
-
-        GDBPacket packet;
-        if (cursor + 1 < n && buf[cursor] == '$') [[likely]] {
-            // Start of Packet
-            cursor++;
-            cursor += ExtractPacket(packet, buf + cursor, n - cursor);
-        } else if (cursor < n) {
-            spdlog::debug("{}:{} Expected Packet Start", __FUNCTION__, __LINE__);
-            state_ = ConnectionState::FATAL_ERROR;
-            break;
+        break;
+    case EventType::Notification:
+        EMU_TRACE(Debugger, "{}:{} Recv Notification: {}", __FUNCTION__, __LINE__, event.data);
+        break;
+    case EventType::Packet:
+        ackPending_ = !QStartNoAckMode_;
+        if (state_ == ConnectionState::HANDSHAKE) {
+            ProcessHandshakePacket(event.data);
         } else {
-            break;
+            ProcessRunningPacket(event.data);
         }
 
-        if (!packet.valid) {
-            spdlog::debug("{}:{} Invalid Packet", __FUNCTION__, __LINE__);
-            state_ = ConnectionState::FATAL_ERROR;
-            break;
+        // Packets answered later, such as a step, are still acknowledged now
+        if (ackPending_) {
+            SendAck(true);
         }
-
-        if (packet.data == "QStartNoAckMode" ||
-            packet.data == "QThreadSuffixSupported") {
-            SendOKResponse();
-            QStartNoAckMode_ = true;
-        } else if (packet.data == "qHostInfo") {
-            auto msg = std::format("hostname:emulator;vendor:{}",
-                                   debugger_->GetCurrentDebugger()->GetName());
-            SendResponse(msg);
-        } else if (packet.data == "qProcessInfo") {
-            auto debugger = debugger_->GetCurrentDebugger();
-            auto msg = std::format("pid:{};vendor:{}",
-                                   debugger->GetCurrentPID(),
-                                   debugger->GetName());
-
-            SendResponse(msg);
-        } else if (packet.data.starts_with("qGetWorkingDir")) {
-            // Just say root directory
-            SendResponse("2f", 2);
-        } else if (packet.data.starts_with("qSupported")) {
-            // Handle supported options
-            HandleQSupportedPacket(packet);
-        } else if (packet.data == "vCont?") {
-            // Don't support vCont yet
-            SendEmptyResponse();
-        } else if (packet.data == "?") {
-            SendSignal(kSIGTRAP);
-            state_ = ConnectionState::RUNNING;
-        } else if (packet.data == "c") {
-            SendOKResponse();
-            state_ = ConnectionState::RUNNING;
-        } else if (packet.data == "QEnableErrorStrings" || packet.data == "qVAttachOrWaitSupported") {
-            // Ignore These Packets
-            SendEmptyResponse();
-        } else {
-            spdlog::debug("Unknown Handshake Packet: {}", packet.data);
-            SendEmptyResponse();
-        }
-
-        alreadyProcessedAck_ = false;
+        break;
     }
-
-    delete[] buf;
 }
 
-void GDBServerConnection::ProcessRunningMessage() noexcept
+void GDBServerConnection::ProcessHandshakePacket(std::string_view packet) noexcept
 {
-    if (!client_->IsReadable()) {
-        return;
-    }
-
-    std::uint8_t* buf = nullptr;
-    int n = client_->ReadAll(&buf);
-    if (n <= 0 || buf == nullptr) {
-        if (n == -1) {
-            state_ = ConnectionState::SHUTDOWN;
-        }
-        return;
-    }
-
-    std::size_t cursor = 0;
-    while (cursor < n && state_ == ConnectionState::RUNNING) {
-        if (!QStartNoAckMode_) {
-            if (buf[cursor] == '+') [[likely]] {
-                cursor++;
-                alreadyProcessedAck_ = true;
-            } else if (!alreadyProcessedAck_) {
-                spdlog::debug("{}:{} Expected Ack Character", __FUNCTION__, __LINE__);
-                state_ = ConnectionState::FATAL_ERROR;
-                break;
-            }
-        }
-
-        if (cursor + 1 < n && buf[cursor] == '$') [[likely]] {
-            // Start of Packet
-            cursor++;
-            ProcessRunningPacket(buf, n, cursor);
-        } else if (cursor + 1 < n && buf[cursor] == '%') {
-            cursor++;
-            ProcessRunningNotification(buf, n, cursor);
-        } else {
-            // Not a packet so figure out what to do
-            if (!ProcessRunningNonPacket(buf, cursor, n)) {
-                break;
-            }
-        }
-        alreadyProcessedAck_ = false;
+    if (packet == "QStartNoAckMode" ||
+        packet == "QThreadSuffixSupported") {
+        SendOKResponse();
+        QStartNoAckMode_ = true;
+    } else if (packet == "qHostInfo") {
+        response_ = std::format("hostname:emulator;vendor:{}", target_->GetName());
+        SendResponse(response_);
+    } else if (packet == "qProcessInfo") {
+        response_ = std::format("pid:{};vendor:{}", target_->GetCurrentPID(), target_->GetName());
+        SendResponse(response_);
+    } else if (packet.starts_with("qGetWorkingDir")) {
+        // Just say root directory
+        SendResponse("2f");
+    } else if (packet.starts_with("qSupported")) {
+        // Handle supported options
+        HandleQSupportedPacket(packet);
+    } else if (packet == "vCont?") {
+        // Don't support vCont yet
+        SendEmptyResponse();
+    } else if (packet == "?") {
+        SendSignal(kSIGTRAP);
+        state_ = ConnectionState::RUNNING;
+    } else if (packet == "c") {
+        SendOKResponse();
+        state_ = ConnectionState::RUNNING;
+    } else if (packet == "QEnableErrorStrings" || packet == "qVAttachOrWaitSupported") {
+        // Ignore These Packets
+        SendEmptyResponse();
+    } else {
+        // Anything else, such as memory reads, is served the same as once running
+        ProcessRunningPacket(packet);
     }
-
-    delete[] buf;
 }
 
-void GDBServerConnection::ProcessRunningPacket(std::uint8_t* buf, std::size_t n, std::size_t& cursor) noexcept
+void GDBServerConnection::ProcessRunningPacket(std::string_view packet) noexcept
 {
-    GDBPacket packet;
-    cursor += ExtractPacket(packet, buf + cursor, n - cursor);
-
-    if (!packet.valid) {
-        spdlog::debug("{}:{} Invalid Packet", __FUNCTION__, __LINE__);
-        state_ = ConnectionState::FATAL_ERROR;
+    if (packet.empty()) {
+        SendEmptyResponse();
         return;
     }
 
-    if (packet.data == "qProcessInfo") {
-        auto debugger = debugger_->GetCurrentDebugger();
-        auto msg = std::format("pid:{};vendor:{}",
-                               debugger->GetCurrentPID(),
-                               debugger->GetName());
-        SendResponse(msg);
-    } else if (packet.data == "qfThreadInfo") {
-        if (debugger_->GetCurrentDebugger()->IsStopped()) {
-            SendResponse("l", 1);
+    if (packet == "qProcessInfo") {
+        response_ = std::format("pid:{};vendor:{}", target_->GetCurrentPID(), target_->GetName());
+        SendResponse(response_);
+    } else if (packet == "qfThreadInfo") {
+        if (target_->IsStopped()) {
+            SendResponse("l");
         } else {
-            SendResponse("m1", 2);
+            SendResponse("m1");
         }
-    } else if (packet.data == "qsThreadInfo") {
-        SendResponse("l", 1);
-    } else if (packet.data.starts_with("qRegisterInfo")) {
-        auto regNum = std::strtol(packet.data.c_str() + sizeof("qRegisterInfo"), nullptr, 16);
-        auto regInfo = debugger_->GetCurrentDebugger()->GetRegisterInfo(regNum);
+    } else if (packet == "qsThreadInfo") {
+        SendResponse("l");
+    } else if (packet.starts_with("qRegisterInfo")) {
+        auto args = packet.substr(sizeof("qRegisterInfo") - 1);
+        std::uint64_t regNum = 0;
+        rsp::ParseHex(args, regNum);
+
+        auto regInfo = target_->GetRegisterInfo(regNum);
         if (regInfo == nullptr) {
             SendError(1);
         } else {
-            auto regStr = regInfo->ToString();
-            SendResponse(regStr);
+            response_ = regInfo->ToString();
+            SendResponse(response_);
         }
-    } else if (packet.data == "qC") {
-        std::string msg = std::format("QC {}", debugger_->GetCurrentDebugger()->GetCurrentPID());
-        SendResponse(msg);
-    } else if (packet.data == "?") {
+    } else if (packet == "qC") {
+        response_ = std::format("QC {}", target_->GetCurrentPID());
+        SendResponse(response_);
+    } else if (packet == "?") {
         SendSignal(kSIGTRAP);
-    } else if (packet.data == "k") {
+    } else if (packet == "k") {
         state_ = ConnectionState::SHUTDOWN;
         SendEmptyResponse();
-    } else if (packet.data == "c") {
-        debugger_->GetCurrentDebugger()->RunCPU();
-        SendOKResponse();
-    } else if (packet.data == "s") {
-        debugger_->GetCurrentDebugger()->StepCPU(1, [this]() {
-            this->SendSignal(kSIGTRAP);
-        });
-    } else if (packet.data.starts_with("vCont")) {
+    } else if (packet == "c") {
+        RunCPU();
+    } else if (packet == "s") {
+        StepCPU();
+    } else if (packet == "bs" || packet == "bc") {
+        if (!target_->SupportsReverse()) {
+            SendEmptyResponse();
+        } else if (packet == "bs") {
+            ReverseStepCPU();
+        } else {
+            ReverseRunCPU();
+        }
+    } else if (packet.starts_with("vCont")) {
         HandleVCont(packet);
-    } else if (packet.data[0] == 'm' || packet.data[0] == 'x') {
+    } else if (packet[0] == 'm' || packet[0] == 'x') {
         // Memory inspect
         HandleMemoryInspect(packet);
+    } else if (packet[0] == 'M' || packet[0] == 'X') {
+        HandleMemoryWrite(packet);
+    } else if (packet.starts_with("qXfer:memory-map:read::")) {
+        HandleMemoryMapRead(packet.substr(sizeof("qXfer:memory-map:read::") - 1));
+    } else if (packet.starts_with("qMemoryRegionInfo:")) {
+        HandleMemoryRegionInfo(packet.substr(sizeof("qMemoryRegionInfo:") - 1));
+    } else if (packet[0] == 'Z' || packet[0] == 'z') {
+        HandleBreakpoint(packet);
+    } else if (packet.starts_with("qRcmd,")) {
+        HandleMonitorCommand(packet.substr(sizeof("qRcmd,") - 1));
     } else {
-        spdlog::debug("Unknown MainLoop Packet: {}", packet.data);
+        EMU_DEBUG(Debugger, "Unknown MainLoop Packet: {}", packet);
         SendEmptyResponse();
     }
 }
 
-void GDBServerConnection::ProcessRunningNotification(std::uint8_t* buf, std::size_t n, std::size_t& cursor) noexcept
-{
-    GDBPacket packet;
-    cursor += ExtractPacket(packet, buf + cursor, n - cursor);
-
-    if (!packet.valid) {
-        spdlog::debug("{}:{} Invalid Packet", __FUNCTION__, __LINE__);
-        state_ = ConnectionState::FATAL_ERROR;
-        return;
-    }
-
-    spdlog::trace("{}:{} Recv Notification: {}", __FUNCTION__, __LINE__, packet.data);
-}
-
-bool GDBServerConnection::ProcessRunningNonPacket(std::uint8_t* buf, std::size_t& cursor, std::size_t len) noexcept
-{
-    if ((int)buf[cursor] == 0x03) {
-        spdlog::trace("GDBServerConnection Recv: CTRL+C");
-        cursor++;
-        return SendSignal(kSIGTRAP);
-    }
-
-    return false;
-}
-
-void GDBServerConnection::HandleQSupportedPacket(GDBPacket& pkt) noexcept
+void GDBServerConnection::HandleQSupportedPacket(std::string_view packet) noexcept
 {
     // Request: qSupported [:gdbfeature [;gdbfeature]...]
-    std::unordered_map<std::string, std::string> kv;
-
-    char *dup, *tmp, *token;
-    dup = tmp = new char[pkt.data.size() + 1];
-    memcpy(dup, pkt.data.c_str(), pkt.data.size());
-    dup[pkt.data.size()] = '\0';
-
-    while (*tmp != '\0' && *tmp != ':')
-        tmp++;
-    if (*tmp == '\0') {
+    auto options = packet.find(':');
+    if (options == std::string_view::npos) {
         // No Options
-        spdlog::debug("qSupported Packet contains no options");
-        delete[] dup;
+        EMU_DEBUG(Debugger, "qSupported Packet contains no options");
         return;
     }
-    tmp++; // Move past ':'
 
-    while ((token = emulator::Strsep(&tmp, ';')) != nullptr) {
-        // Get value
-        char* valStart = token;
-        while (*valStart != '=' && *valStart != '+' && *valStart != '-' && *valStart != '?' && *valStart != '\0') {
-            valStart++;
-        }
-
-        if (*valStart == '=') {
-            // We have a KV pair
-            *valStart = '\0';
-            valStart++;
-            kv[std::string(token)] = std::string(valStart);
-        } else if (*valStart == '+' || *valStart == '-' || *valStart == '?') {
-            char c = *valStart;
-            *valStart = '\0';
-            kv[std::string(token)] = std::to_string(c);
+    std::unordered_map<std::string_view, std::string_view> kv;
+    auto rest = packet.substr(options + 1);
+    while (!rest.empty()) {
+        auto end = rest.find(';');
+        auto token = rest.substr(0, end);
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+        // Either name=value or name followed by '+', '-' or '?'
+        // Feature names may themselves contain '-', so only the last character is a suffix
+        auto valStart = token.find('=');
+        if (valStart != std::string_view::npos) {
+            kv[token.substr(0, valStart)] = token.substr(valStart + 1);
+        } else if (!token.empty() && std::string_view("+-?").find(token.back()) != std::string_view::npos) {
+            kv[token.substr(0, token.size() - 1)] = token.substr(token.size() - 1);
         } else {
-            // No KV V=pair
-            kv[std::string(token)] = "";
+            kv[token] = "";
         }
     }
 
-    static std::unordered_map<std::string, bool> supportedFeatures = {
+    // Only gdb announces it, and with it expects x replies to start with 'b'
+    auto binaryUpload = kv.find("binary-upload");
+    binaryUpload_ = binaryUpload != kv.end() && binaryUpload->second == "+";
+
+    static std::unordered_map<std::string_view, bool> supportedFeatures = {
         {"QStartNoAckMode", true},
+        {"binary-upload", true},
         {"hwbreak", true},
         {"qXfer:memory-map:read", true},
         {"qXfer:osdata:read", true},
@@ -428,91 +384,278 @@ void GDBServerConnection::HandleQSupportedPacket(GDBPacket& pkt) noexcept
         {"vfork", false},
         {"multiprocess", false}};
 
-    std::string response = "";
+    response_.clear();
+    if (target_->SupportsReverse()) {
+        response_ += "ReverseStep+;ReverseContinue+;";
+    }
     for (const auto& opt : kv) {
-        spdlog::trace("GDBServerConnection::HandleQSupportedPacket Requested Options: {} = {}", opt.first, opt.second);
+        EMU_TRACE(Debugger, "GDBServerConnection::HandleQSupportedPacket Requested Options: {} = {}", opt.first, opt.second);
 
+        // Don't support if not in list
         auto it = supportedFeatures.find(opt.first);
-        if (it != supportedFeatures.end()) {
-            response += opt.first + (it->second ? "+" : "-");
-        } else {
-            // Don't support if not in list
-            response += opt.first + "-";
-        }
+        response_ += opt.first;
+        response_ += it != supportedFeatures.end() && it->second ? "+;" : "-;";
     }
 
     // Can lead to duplicates, but IDC for now
     for (const auto& opt : supportedFeatures) {
-        response += opt.first + (opt.second ? "+" : "-");
+        response_ += opt.first;
+        response_ += opt.second ? "+;" : "-;";
     }
 
-    // Send response
-    SendResponse(response);
+    // Largest packet the parser accepts, so gdb splits large writes to fit
+    response_ += std::format("PacketSize={:x}", rsp::PacketParser::kMaxPacketSize);
 
-    delete[] dup;
+    SendResponse(response_);
 }
 
-void GDBServerConnection::HandleVCont(GDBPacket& pkt) noexcept
+void GDBServerConnection::HandleVCont(std::string_view packet) noexcept
 {
-    auto cmd = pkt.data.find_first_of(";");
-    if (cmd == std::string::npos) {
-        spdlog::debug("{}:{} Missing ';'", __FUNCTION__, __LINE__);
+    auto cmd = packet.find(';');
+    if (cmd == std::string_view::npos) {
+        EMU_DEBUG(Debugger, "{}:{} Missing ';'", __FUNCTION__, __LINE__);
         state_ = ConnectionState::FATAL_ERROR;
         return;
     }
 
-    std::stringstream actionStr(pkt.data.substr(cmd));
-    std::string action;
-    std::vector<std::string> actions;
-    while (std::getline(actionStr, action, ';')) {
-        if (action.empty()) {
-            continue;
+    // Only support 1 thread for now, so only the first action matters
+    auto actions = packet.substr(cmd + 1);
+    auto action = actions.substr(0, actions.find(';'));
+    EMU_TRACE(Debugger, "{}:{} Received Control Action: {}", __FUNCTION__, __LINE__, action);
+
+    if (action.empty() || action.starts_with("c")) {
+        RunCPU();
+    } else if (action.starts_with("s")) {
+        // Single step CPU
+        StepCPU();
+    } else if (action.starts_with("t")) {
+        SendSignal(kSIGTRAP);
+    }
+}
+
+// Parse "addr,length" leaving args at what follows
+static bool ParseAddressLength(std::string_view& args, std::uint64_t& addr, std::uint64_t& length) noexcept
+{
+    if (!rsp::ParseHex(args, addr) || !args.starts_with(',')) {
+        return false;
+    }
+    args.remove_prefix(1);
+    return rsp::ParseHex(args, length);
+}
+
+void GDBServerConnection::HandleMemoryInspect(std::string_view packet) noexcept
+{
+    bool binary = packet[0] == 'x';
+
+    // m addr,length or x addr,length
+    auto args = packet.substr(1);
+    std::uint64_t addr = 0, length = 0;
+    if (!ParseAddressLength(args, addr, length)) {
+        SendError(1);
+        return;
+    }
+
+    // Zero length x is how lldb probes for binary reads
+    if (binary && length == 0 && !binaryUpload_) {
+        SendOKResponse();
+        return;
+    }
+
+    // Short reads are allowed, so oversized requests are simply truncated
+    length = std::min<std::uint64_t>(length, kMaxMemoryRead);
+
+    memoryBuffer_.resize(length);
+    auto read = target_->ReadMemory(addr, memoryBuffer_);
+    if (read == 0 && length != 0) {
+        SendError(1);
+        return;
+    }
+
+    response_.clear();
+    if (binary) {
+        if (binaryUpload_) {
+            response_ += 'b';
         }
+        rsp::AppendEscaped(response_, {memoryBuffer_.data(), read});
+    } else {
+        rsp::AppendHex(response_, {memoryBuffer_.data(), read});
+    }
+    SendResponse(response_);
+}
 
-        spdlog::trace("{}:{} Received Control Action: {}", __FUNCTION__, __LINE__, action);
-        actions.push_back(action);
+void GDBServerConnection::HandleMemoryWrite(std::string_view packet) noexcept
+{
+    bool binary = packet[0] == 'X';
+
+    // M addr,length:hex or X addr,length:binary, the parser has already unescaped binary data
+    auto args = packet.substr(1);
+    std::uint64_t addr = 0, length = 0;
+    if (!ParseAddressLength(args, addr, length) || !args.starts_with(':')) {
+        SendError(1);
+        return;
     }
+    args.remove_prefix(1);
 
-    // Only support 1 thread for now
-    if (actions.size() < 1) {
-        // Just resume
-        debugger_->GetCurrentDebugger()->RunCPU();
+    std::span<const std::uint8_t> data;
+    if (binary) {
+        data = {reinterpret_cast<const std::uint8_t*>(args.data()), args.size()};
+    } else {
+        memoryBuffer_.resize(args.size() / 2);
+        data = std::span(memoryBuffer_).first(rsp::DecodeHex(args, memoryBuffer_));
+    }
+
+    if (data.size() != length) {
+        SendError(1);
+        return;
+    }
+
+    // Zero length X is how gdb probes for binary writes
+    if (length == 0 || target_->WriteMemory(addr, data)) {
         SendOKResponse();
     } else {
-        if (actions[0].starts_with("c")) {
-            debugger_->GetCurrentDebugger()->RunCPU();
-            SendOKResponse();
-        } else if (actions[0].starts_with("s")) {
-            // Single step CPU
-            debugger_->GetCurrentDebugger()->StepCPU(1, [this]() {
-                this->SendSignal(kSIGTRAP);
-            });
-        } else if (actions[0].starts_with("t")) {
-            SendSignal(kSIGTRAP);
+        SendError(1);
+    }
+}
+
+void GDBServerConnection::HandleMemoryMapRead(std::string_view args) noexcept
+{
+    std::uint64_t offset = 0, length = 0;
+    if (!ParseAddressLength(args, offset, length)) {
+        SendError(0);
+        return;
+    }
+
+    if (offset == 0 || memoryMap_.empty()) {
+        memoryMap_ = "<?xml version=\"1.0\"?>\n"
+                     "<!DOCTYPE memory-map PUBLIC \"+//IDN gnu.org//DTD GDB Memory Map V1.0//EN\" "
+                     "\"http://sourceware.org/gdb/gdb-memory-map.dtd\">\n"
+                     "<memory-map>\n";
+        for (const auto& region : target_->GetMemoryMap()) {
+            memoryMap_ += std::format("  <memory type=\"{}\" start=\"0x{:x}\" length=\"0x{:x}\"/>\n",
+                                      region.type == MemoryRegion::Type::ROM ? "rom" : "ram",
+                                      region.start, region.length);
         }
+        memoryMap_ += "</memory-map>\n";
     }
+
+    // 'm' when there is more to read, 'l' for the last piece
+    offset = std::min<std::uint64_t>(offset, memoryMap_.size());
+    length = std::min<std::uint64_t>(length, memoryMap_.size() - offset);
+    response_ = offset + length < memoryMap_.size() ? "m" : "l";
+    rsp::AppendEscaped(response_, {reinterpret_cast<const std::uint8_t*>(memoryMap_.data()) + offset, length});
+    SendResponse(response_);
 }
 
-void GDBServerConnection::HandleMemoryInspect(GDBPacket& pkt) noexcept
+void GDBServerConnection::HandleMemoryRegionInfo(std::string_view args) noexcept
 {
-    char* endptr = nullptr;
-    auto addr = std::strtoll(pkt.data.c_str() + 1, &endptr, 16);
-    std::size_t length = std::strtoll(endptr + 1, nullptr, 16);
-
-    // Read memory from system
-    auto memory = debugger_->GetCurrentDebugger()->ReadMemory(addr, length);
-    if (memory == nullptr) {
-        if (pkt.data[0] == 'x')
-            SendError(1);
-        else
-            SendEmptyResponse();
+    std::uint64_t addr = 0;
+    if (!rsp::ParseHex(args, addr)) {
+        SendError(1);
+        return;
     }
 
-    std::string hexStr = pkt.data[0] == 'm' ? "" : "b ";
-    for (std::size_t i = 0; i < length; i++) {
-        hexStr += std::format("{:02x}", memory[i]);
+    // Unmapped addresses report the gap up to the next region, without permissions
+    std::uint64_t end = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& region : target_->GetMemoryMap()) {
+        if (addr >= region.start && addr < region.start + region.length) {
+            response_ = std::format("start:{:x};size:{:x};permissions:{};",
+                                    region.start, region.length,
+                                    region.type == MemoryRegion::Type::ROM ? "rx" : "rwx");
+            SendResponse(response_);
+            return;
+        }
+        if (region.start > addr) {
+            end = std::min<std::uint64_t>(end, region.start);
+        }
     }
-    SendResponse(hexStr);
+
+    response_ = std::format("start:{:x};size:{:x};", addr, end - addr);
+    SendResponse(response_);
+}
+
+void GDBServerConnection::HandleBreakpoint(std::string_view packet) noexcept
+{
+    // Z0,addr,kind or Z1,addr,kind, both served by software breakpoints
+    bool insert = packet[0] == 'Z';
+    if (packet.size() < 3 || (packet[1] != '0' && packet[1] != '1') || packet[2] != ',') {
+        // Watchpoints are not supported
+        SendEmptyResponse();
+        return;
+    }
+
+    auto args = packet.substr(3);
+    std::uint64_t addr = 0;
+    if (!rsp::ParseHex(args, addr)) {
+        SendError(1);
+        return;
+    }
+
+    if (insert) {
+        target_->AddBreakpoint(addr);
+    } else {
+        target_->RemoveBreakpoint(addr);
+    }
+    SendOKResponse();
+}
+
+void GDBServerConnection::HandleMonitorCommand(std::string_view args) noexcept
+{
+    // monitor break <addr> [if <condition>], monitor delete <addr> or monitor history <interval> [checkpoints]
+    std::string command(args.size() / 2, '\0');
+    command.resize(rsp::DecodeHex(args, {reinterpret_cast<std::uint8_t*>(command.data()), command.size()}));
+    std::string_view text = command;
+
+    auto word = text.substr(0, text.find(' '));
+    text.remove_prefix(word.size());
+    text.remove_prefix(std::min(text.find_first_not_of(' '), text.size()));
+
+    // History takes decimal counts rather than an address
+    std::uint64_t counts[2] = {0, kDefaultHistoryCheckpoints};
+    std::size_t parsed = 0;
+    for (auto rest = text; parsed < std::size(counts) && !rest.empty(); parsed++) {
+        auto [end, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), counts[parsed]);
+        if (ec != std::errc()) {
+            break;
+        }
+        rest.remove_prefix(end - rest.data());
+        rest.remove_prefix(std::min(rest.find_first_not_of(' '), rest.size()));
+    }
+
+    std::uint64_t addr = 0;
+    if (text.starts_with("0x")) {
+        text.remove_prefix(2);
+    }
+    bool hasAddress = rsp::ParseHex(text, addr);
+
+    std::string output;
+    if (word == "break" && hasAddress) {
+        text.remove_prefix(std::min(text.find_first_not_of(' '), text.size()));
+        if (!text.empty() && !text.starts_with("if ")) {
+            output = "Expected 'if <condition>' after the address\n";
+        } else {
+            auto condition = text.empty() ? text : text.substr(3);
+            try {
+                target_->AddBreakpoint(addr, condition);
+                output = condition.empty() ? std::format("Breakpoint at 0x{:x}\n", addr)
+                                           : std::format("Breakpoint at 0x{:x} if {}\n", addr, condition);
+            } catch (const std::invalid_argument& e) {
+                output = std::format("{}\n", e.what());
+            }
+        }
+    } else if (word == "delete" && hasAddress) {
+        target_->RemoveBreakpoint(addr);
+        output = std::format("Deleted breakpoint at 0x{:x}\n", addr);
+    } else if (word == "history" && parsed > 0 && target_->SupportsReverse()) {
+        target_->EnableHistory(counts[0], counts[1]);
+        output = counts[0] == 0 ? std::string("History off\n")
+                                : std::format("Checkpoint every {} instructions, keeping {}\n", counts[0], counts[1]);
+    } else {
+        output = "Usage: monitor break <addr> [if <condition>] | monitor delete <addr> | monitor history <interval> [checkpoints]\n";
+    }
+
+    // Console output goes first, then the command's own reply
+    SendDebugMessage(output);
+    SendOKResponse();
 }
 
 }; // namespace emulator::debugger
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "debugger.h"
+#include "rsp.h"
 #include "socket/client.h"
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace emulator::debugger
 {
@@ -11,13 +18,6 @@ namespace emulator::debugger
 class GDBServerConnection
 {
 private:
-    struct GDBPacket {
-        bool valid;
-        std::uint8_t chksum;
-
-        std::string data;
-    };
-
     enum class ConnectionState {
         PRECONNECT,
         HANDSHAKE,
@@ -27,42 +27,83 @@ private:
     } state_;
 
     Debugger* debugger_;
-    socket::DebuggerSocketClient* client_;
+    ISystemDebugger* target_;
+    std::unique_ptr<socket::DebuggerSocketClient> client_;
+
+    // Fixed and reused buffers, so serving requests does not allocate once warmed up
+    std::array<std::uint8_t, 4096> receiveBuffer_;
+    rsp::PacketParser parser_;
+    std::string response_;
+    std::string lastResponse_;
+    std::vector<std::uint8_t> memoryBuffer_;
+
+    // Largest single memory read, anything above is returned short
+    static constexpr std::size_t kMaxMemoryRead = 0x10000;
+
+    // History kept for reverse execution until changed with monitor history
+    static constexpr std::uint64_t kDefaultHistoryInterval = 100000;
+    static constexpr std::size_t kDefaultHistoryCheckpoints = 64;
+
+    // Set from the emulation thread when a step or breakpoint stops it, reported by the server thread
+    std::shared_ptr<std::atomic<bool>> stopPending_{std::make_shared<std::atomic<bool>>(false)};
+
+    // Built on the first qXfer:memory-map:read, later reads are slices of it
+    std::string memoryMap_;
 
     bool QStartNoAckMode_{false};
-    bool alreadyProcessedAck_{false};
+    bool ackPending_{false};
+
+    // gdb prefixes binary x replies with 'b', lldb does not
+    bool binaryUpload_{false};
 
-    bool SendResponse(std::string&) noexcept;
-    bool SendResponse(const char*, std::size_t) noexcept;
+    bool SendResponse(std::string_view) noexcept;
     bool SendEmptyResponse() noexcept;
     bool SendOKResponse() noexcept;
+    bool SendAck(bool valid) noexcept;
 
     enum class StopReason {
         NONE,
         WATCH,
-        HWBREAK
+        HWBREAK,
+        REPLAYLOG_BEGIN
     };
     bool SendSignal(std::uint8_t signal, StopReason = StopReason::NONE) noexcept;
     bool SendTerminate(std::uint8_t signal) noexcept;
-    bool SendDebugMessage(std::string) noexcept;
+    bool SendDebugMessage(std::string_view) noexcept;
     bool SendError(std::uint8_t) noexcept;
 
-    std::size_t ExtractPacket(GDBPacket&, std::uint8_t*, std::size_t) noexcept;
-    void ProcessHandshakeMessage() noexcept;
-    void ProcessRunningMessage() noexcept;
-    void ProcessRunningPacket(std::uint8_t*, std::size_t, std::size_t&) noexcept;
-    void ProcessRunningNotification(std::uint8_t*, std::size_t, std::size_t&) noexcept;
-    bool ProcessRunningNonPacket(std::uint8_t*, std::size_t&, std::size_t) noexcept;
+    void ProcessEvent(const rsp::PacketParser::Event&) noexcept;
+    void ProcessHandshakePacket(std::string_view) noexcept;
+    void ProcessRunningPacket(std::string_view) noexcept;
 
-    void HandleQSupportedPacket(GDBPacket&) noexcept;
-    void HandleVCont(GDBPacket&) noexcept;
-    void HandleMemoryInspect(GDBPacket&) noexcept;
+    void HandleQSupportedPacket(std::string_view) noexcept;
+    void HandleVCont(std::string_view) noexcept;
+    void HandleMemoryInspect(std::string_view) noexcept;
+    void HandleMemoryWrite(std::string_view) noexcept;
+    void HandleMemoryMapRead(std::string_view) noexcept;
+    void HandleMemoryRegionInfo(std::string_view) noexcept;
+    void HandleBreakpoint(std::string_view) noexcept;
+    void HandleMonitorCommand(std::string_view) noexcept;
+
+    // Resumes the target, the stop reply is sent once it stops again
+    void StepCPU() noexcept;
+    void RunCPU() noexcept;
+    void ReverseStepCPU() noexcept;
+    void ReverseRunCPU() noexcept;
+    std::function<void(void)> StopCallback() noexcept;
 
 public:
-    GDBServerConnection(Debugger* debugger, socket::DebuggerSocketClient* client);
+    // Takes ownership of client, every request is served by target
+    GDBServerConnection(Debugger* debugger, ISystemDebugger* target, socket::DebuggerSocketClient* client);
     ~GDBServerConnection();
 
-    void ServeWhile(volatile bool&) noexcept;
+    SOCKET GetSocket() const noexcept { return client_->GetSocket(); }
+
+    // Process what has arrived on the socket, returns false once the connection should be closed
+    bool OnReadable() noexcept;
+
+    // Send the stop reply for a step or breakpoint that stopped the target since the last call
+    void DeliverPendingStop() noexcept;
 };
 
 }; // namespace emulator::debugger
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace emulator::debugger
+{
+
+// Opaque machine state saved by a system, only restored into the system that saved it
+class ICheckpoint
+{
+public:
+    virtual ~ICheckpoint() = default;
+};
+
+/**
+ * Checkpoints taken every interval instructions for reverse execution.
+ *
+ * Going back restores the closest checkpoint before the target and re-executes
+ * from there, so a shorter interval costs memory and a longer one seek time.
+ * Once capacity is reached the oldest checkpoint is dropped, which is as far
+ * back as execution can go.
+ */
+class History
+{
+public:
+    struct Checkpoint {
+        // Instructions started before the one the checkpoint was taken at, and its address
+        std::uint64_t position;
+        std::uint64_t pc;
+        std::unique_ptr<ICheckpoint> state;
+    };
+
+private:
+    std::deque<Checkpoint> checkpoints_;
+    std::uint64_t interval_{0};
+    std::size_t capacity_{0};
+
+public:
+    // An interval of 0 disables recording and drops everything recorded
+    void Configure(std::uint64_t interval, std::size_t capacity)
+    {
+        interval_ = interval;
+        capacity_ = capacity;
+        if (interval_ == 0 || capacity_ == 0) {
+            checkpoints_.clear();
+        }
+        while (checkpoints_.size() > capacity_) {
+            checkpoints_.pop_front();
+        }
+    }
+
+    bool Enabled() const noexcept { return interval_ != 0 && capacity_ != 0; }
+
+    bool Due(std::uint64_t position) const noexcept
+    {
+        return Enabled() && (checkpoints_.empty() || position >= checkpoints_.back().position + interval_);
+    }
+
+    void Record(std::uint64_t position, std::uint64_t pc, std::unique_ptr<ICheckpoint> state)
+    {
+        if (state == nullptr) {
+            return;
+        }
+        checkpoints_.push_back({position, pc, std::move(state)});
+        if (checkpoints_.size() > capacity_) {
+            checkpoints_.pop_front();
+        }
+    }
+
+    // Drop checkpoints from position on, e.g. once the debugger changed state the future no longer follows
+    void Truncate(std::uint64_t position) noexcept
+    {
+        while (!checkpoints_.empty() && checkpoints_.back().position >= position) {
+            checkpoints_.pop_back();
+        }
+    }
+
+    std::size_t Size() const noexcept { return checkpoints_.size(); }
+    const Checkpoint& operator[](std::size_t index) const noexcept { return checkpoints_[index]; }
+
+    // Index of the last checkpoint at or before position, -1 if there is none
+    std::ptrdiff_t Find(std::uint64_t position) const noexcept
+    {
+        for (auto i = static_cast<std::ptrdiff_t>(checkpoints_.size()) - 1; i >= 0; i--) {
+            if (checkpoints_[i].position <= position) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+}; // namespace emulator::debugger
@@ -0,0 +1,88 @@
+#include "rsp.h"
+
+namespace emulator::debugger::rsp
+{
+
+void PacketParser::Append(char c) noexcept
+{
+    if (length_ < kMaxPacketSize) {
+        buffer_[length_++] = c;
+    } else {
+        overflow_ = true;
+    }
+}
+
+bool PacketParser::Next(std::span<const std::uint8_t>& input, Event& event) noexcept
+{
+    while (!input.empty()) {
+        char c = static_cast<char>(input.front());
+        input = input.subspan(1);
+
+        switch (state_) {
+        case State::Idle:
+            if (c == '$' || c == '%') {
+                state_ = State::Data;
+                notification_ = c == '%';
+                length_ = 0;
+                overflow_ = false;
+                checksum_ = 0;
+            } else if (c == '+') {
+                event = {EventType::Ack, {}};
+                return true;
+            } else if (c == '-') {
+                event = {EventType::Nack, {}};
+                return true;
+            } else if (c == 0x03) {
+                event = {EventType::Interrupt, {}};
+                return true;
+            }
+            // Anything else between packets is line noise
+            break;
+        case State::Data:
+            if (c == '#') {
+                state_ = State::ChecksumHigh;
+            } else if (c == '$') {
+                // Start of a new packet, the previous one was cut short
+                length_ = 0;
+                overflow_ = false;
+                checksum_ = 0;
+                notification_ = false;
+            } else {
+                checksum_ += static_cast<std::uint8_t>(c);
+                if (c == '}') {
+                    state_ = State::Escape;
+                } else {
+                    Append(c);
+                }
+            }
+            break;
+        case State::Escape:
+            checksum_ += static_cast<std::uint8_t>(c);
+            Append(c ^ 0x20);
+            state_ = State::Data;
+            break;
+        case State::ChecksumHigh:
+            if (HexValue(c) < 0) {
+                state_ = State::Idle;
+                event = {EventType::Invalid, {}};
+                return true;
+            }
+            expectedChecksum_ = HexValue(c) << 4;
+            state_ = State::ChecksumLow;
+            break;
+        case State::ChecksumLow:
+            state_ = State::Idle;
+            if (HexValue(c) < 0 || (expectedChecksum_ | HexValue(c)) != checksum_ || overflow_) {
+                event = {EventType::Invalid, {}};
+                return true;
+            }
+
+            buffer_[length_] = '\0';
+            event = {notification_ ? EventType::Notification : EventType::Packet, {buffer_.data(), length_}};
+            return true;
+        }
+    }
+    return false;
+}
+
+}; // namespace emulator::debugger::rsp
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace emulator::debugger::rsp
+{
+
+static constexpr char kHexDigits[] = "0123456789abcdef";
+
+// Value of each character as a hex digit, -1 if it is not one
+static constexpr auto kHexValues = []() {
+    std::array<std::int8_t, 256> values{};
+    values.fill(-1);
+    for (int i = 0; i < 10; i++) {
+        values['0' + i] = static_cast<std::int8_t>(i);
+    }
+    for (int i = 0; i < 6; i++) {
+        values['a' + i] = static_cast<std::int8_t>(10 + i);
+        values['A' + i] = static_cast<std::int8_t>(10 + i);
+    }
+    return values;
+}();
+
+inline int HexValue(char c) noexcept
+{
+    return kHexValues[static_cast<std::uint8_t>(c)];
+}
+
+inline void AppendHex(std::string& out, std::uint8_t byte)
+{
+    out += kHexDigits[byte >> 4];
+    out += kHexDigits[byte & 0xF];
+}
+
+// Two hex digits per byte, written in place after a single resize
+inline void AppendHex(std::string& out, std::span<const std::uint8_t> data)
+{
+    auto offset = out.size();
+    out.resize(offset + data.size() * 2);
+
+    auto dst = out.data() + offset;
+    for (auto byte : data) {
+        *dst++ = kHexDigits[byte >> 4];
+        *dst++ = kHexDigits[byte & 0xF];
+    }
+}
+
+// Binary data with the characters that frame packets escaped as '}' followed by the byte ^ 0x20
+inline void AppendEscaped(std::string& out, std::span<const std::uint8_t> data)
+{
+    out.reserve(out.size() + data.size());
+    for (auto byte : data) {
+        if (byte == '$' || byte == '#' || byte == '}' || byte == '*') [[unlikely]] {
+            out += '}';
+            out += static_cast<char>(byte ^ 0x20);
+        } else {
+            out += static_cast<char>(byte);
+        }
+    }
+}
+
+// Consume leading hex digits of in into value, returns false if there were none
+inline bool ParseHex(std::string_view& in, std::uint64_t& value) noexcept
+{
+    std::size_t i = 0;
+    value = 0;
+    for (; i < in.size() && HexValue(in[i]) >= 0; i++) {
+        value = (value << 4) | HexValue(in[i]);
+    }
+    in.remove_prefix(i);
+    return i > 0;
+}
+
+// Decode pairs of hex digits into out, returns the number of bytes written
+inline std::size_t DecodeHex(std::string_view in, std::span<std::uint8_t> out) noexcept
+{
+    std::size_t n = 0;
+    for (; n < out.size() && n * 2 + 1 < in.size(); n++) {
+        auto high = HexValue(in[n * 2]);
+        auto low = HexValue(in[n * 2 + 1]);
+        if (high < 0 || low < 0) {
+            break;
+        }
+        out[n] = static_cast<std::uint8_t>((high << 4) | low);
+    }
+    return n;
+}
+
+/**
+ * Incremental parser for the GDB remote serial protocol.
+ *
+ * Input can be split anywhere between calls, packet bodies are unescaped
+ * into a fixed buffer so steady-state parsing never allocates.
+ */
+class PacketParser
+{
+public:
+    // Largest packet body accepted, advertised to gdb as PacketSize
+    static constexpr std::size_t kMaxPacketSize = 0x4000;
+
+    enum class EventType {
+        Ack,          // '+'
+        Nack,         // '-', the last response should be sent again
+        Interrupt,    // Ctrl+C
+        Packet,       // $data#xx
+        Notification, // %data#xx
+        Invalid,      // Bad checksum or too large, the packet is dropped
+    };
+
+    struct Event {
+        EventType type;
+
+        // Valid until the next call to Next, NUL terminated
+        std::string_view data;
+    };
+
+private:
+    enum class State {
+        Idle,
+        Data,
+        Escape,
+        ChecksumHigh,
+        ChecksumLow,
+    } state_{State::Idle};
+
+    std::array<char, kMaxPacketSize + 1> buffer_;
+    std::size_t length_{0};
+    bool overflow_{false};
+    bool notification_{false};
+
+    std::uint8_t checksum_{0};
+    int expectedChecksum_{0};
+
+    void Append(char c) noexcept;
+
+public:
+    // Consume input until an event completes, returns false once input runs out first
+    bool Next(std::span<const std::uint8_t>& input, Event& event) noexcept;
+
+    void Reset() noexcept
+    {
+        state_ = State::Idle;
+        length_ = 0;
+    }
+};
+
+}; // namespace emulator::debugger::rsp
@@ -1,11 +1,19 @@
 #include "client.h"
 
+#include <components/log.h>
 #include <spdlog/spdlog.h>
 #include <vector>
 
 namespace emulator::debugger::socket
 {
 
+// A client going away must not take the whole emulator down with SIGPIPE
+#ifdef MSG_NOSIGNAL
+static constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+static constexpr int kSendFlags = 0;
+#endif
+
 DebuggerSocketClient::DebuggerSocketClient(SOCKET client) : client_(client)
 {
     timeout_.tv_sec = 1;
@@ -19,27 +27,6 @@ DebuggerSocketClient::~DebuggerSocketClient()
     }
 }
 
-bool DebuggerSocketClient::IsReadable() noexcept
-{
-    if (client_ == INVALID_SOCKET) {
-        return false;
-    }
-
-    fd_set fdset;
-    FD_ZERO(&fdset);
-    FD_SET(client_, &fdset);
-
-#if defined(_WIN32) || defined(_WIN64)
-    // First argument ignore on Windows
-    if (select(1, &fdset, nullptr, nullptr, &timeout_) < 0) {
-#else
-    if (select(client_ + 1, &fdset, nullptr, nullptr, &timeout_) < 0) {
-#endif
-        return false;
-    }
-    return FD_ISSET(client_, &fdset);
-}
-
 bool DebuggerSocketClient::IsWritable() noexcept
 {
     if (client_ == INVALID_SOCKET) {
@@ -61,55 +48,27 @@ bool DebuggerSocketClient::IsWritable() noexcept
     return FD_ISSET(client_, &fdset);
 }
 
-int DebuggerSocketClient::ReadAll(std::uint8_t** data) noexcept
+int DebuggerSocketClient::Read(std::span<std::uint8_t> buffer) noexcept
 {
-    if (data == nullptr) {
-        return -1;
-    }
-    *data = nullptr;
-
     if (client_ == INVALID_SOCKET) {
         return -1;
     }
 
-    int bufLen = 0;
-    int bufCap = 4096;
-    std::uint8_t* buf = new std::uint8_t[bufCap + 1];
-
-    while (IsReadable()) {
-        auto n = recv(client_, reinterpret_cast<char*>(buf), bufCap, 0);
-        if (n < 0) {
-            delete[] buf;
-            return -1;
-        }
-
-        bufLen += n;
-
-        // Could not fill buffer, so end of the stream
-        if (bufLen < bufCap || n == 0) {
-            break;
-        }
-
-        // Resize for more data
-        bufCap += 4096;
-        auto bufNew = new std::uint8_t[bufCap + 1];
-        std::memcpy(bufNew, buf, bufLen);
-        buf = bufNew;
-    };
-
-    if (bufLen > 0) {
-        buf[bufLen + 1] = 0x00;
-        *data = buf;
-    } else {
-        delete[] buf;
+    auto n = recv(client_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+    if (n < 0) {
+        return internal::WouldBlock() ? 0 : -1;
+    }
+    if (n == 0) {
+        // Peer closed the connection
+        return -1;
     }
 
-    if (*data && spdlog::get_level() <= spdlog::level::trace) {
-        std::string msg((char*)*data);
-        spdlog::trace("GDBStubClient <- {}", msg);
+    if (EMU_LOG_ENABLED(Debugger, TRACE)) {
+        std::string msg(reinterpret_cast<char*>(buffer.data()), n);
+        EMU_TRACE(Debugger, "GDBStubClient <- {}", msg);
     }
 
-    return bufLen;
+    return static_cast<int>(n);
 }
 
 int DebuggerSocketClient::Write(const std::uint8_t* data, std::size_t len) noexcept
@@ -122,15 +81,19 @@ int DebuggerSocketClient::Write(const std::uint8_t* data, std::size_t len) noexc
         return -1;
     }
 
-    if (data && spdlog::get_level() <= spdlog::level::trace) {
-        std::string msg((char*)data);
-        spdlog::trace("GDBStubClient -> {}", msg);
+    if (data && EMU_LOG_ENABLED(Debugger, TRACE)) {
+        std::string msg((char*)data, len);
+        EMU_TRACE(Debugger, "GDBStubClient -> {}", msg);
     }
 
     int offset = 0;
     do {
-        auto n = send(client_, reinterpret_cast<const char*>(data) + offset, static_cast<int>(len) - offset, 0);
+        auto n = send(client_, reinterpret_cast<const char*>(data) + offset, static_cast<int>(len) - offset, kSendFlags);
         if (n < 0) {
+            // Non-blocking socket is full, wait for the peer to catch up
+            if (internal::WouldBlock() && IsWritable()) {
+                continue;
+            }
             return -1;
         }
         if (n == 0) {
@@ -143,4 +106,76 @@ int DebuggerSocketClient::Write(const std::uint8_t* data, std::size_t len) noexc
     return offset;
 }
 
+int DebuggerSocketClient::WriteV(std::initializer_list<std::string_view> parts) noexcept
+{
+    if (client_ == INVALID_SOCKET) {
+        return -1;
+    }
+
+    if (EMU_LOG_ENABLED(Debugger, TRACE)) {
+        std::string msg;
+        for (auto part : parts) {
+            msg += part;
+        }
+        EMU_TRACE(Debugger, "GDBStubClient -> {}", msg);
+    }
+
+    static constexpr std::size_t kMaxParts = 8;
+    std::size_t total = 0;
+    std::size_t count = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+    WSABUF buffers[kMaxParts];
+    for (auto part : parts) {
+        if (count == kMaxParts) {
+            return -1;
+        }
+        buffers[count].buf = const_cast<char*>(part.data());
+        buffers[count++].len = static_cast<ULONG>(part.size());
+        total += part.size();
+    }
+
+    DWORD sent = 0;
+    long n = WSASend(client_, buffers, static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == 0 ? sent : -1;
+#else
+    struct iovec buffers[kMaxParts];
+    for (auto part : parts) {
+        if (count == kMaxParts) {
+            return -1;
+        }
+        buffers[count].iov_base = const_cast<char*>(part.data());
+        buffers[count++].iov_len = part.size();
+        total += part.size();
+    }
+
+    struct msghdr msg{};
+    msg.msg_iov = buffers;
+    msg.msg_iovlen = count;
+    auto n = sendmsg(client_, &msg, kSendFlags);
+#endif
+    if (n < 0) {
+        if (!internal::WouldBlock()) {
+            return -1;
+        }
+        n = 0;
+    }
+
+    // The socket took part of it, send the rest piece by piece
+    std::size_t skip = n;
+    for (auto part : parts) {
+        if (skip >= part.size()) {
+            skip -= part.size();
+            continue;
+        }
+
+        auto remaining = part.substr(skip);
+        skip = 0;
+        if (Write(reinterpret_cast<const std::uint8_t*>(remaining.data()), remaining.size()) != static_cast<int>(remaining.size())) {
+            return -1;
+        }
+    }
+
+    return static_cast<int>(total);
+}
+
 }; // namespace emulator::debugger::socket
@@ -2,6 +2,9 @@
 
 #include "socket_internal.h"
 #include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <string_view>
 
 namespace emulator::debugger::socket
 {
@@ -16,11 +19,16 @@ public:
     DebuggerSocketClient(SOCKET);
     ~DebuggerSocketClient();
 
-    bool IsReadable() noexcept;
+    SOCKET GetSocket() const noexcept { return client_; }
+
     bool IsWritable() noexcept;
 
-    int ReadAll(std::uint8_t**) noexcept;
+    // Read what has arrived without blocking, 0 when nothing has and -1 once the peer has gone
+    int Read(std::span<std::uint8_t>) noexcept;
     int Write(const std::uint8_t*, std::size_t) noexcept;
+
+    // Send the parts as one message without first joining them
+    int WriteV(std::initializer_list<std::string_view> parts) noexcept;
 };
 
 }; // namespace emulator::debugger::socket
@@ -0,0 +1,179 @@
+#include "poller.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef EMULATOR_DEBUGGER_USE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#endif
+
+namespace emulator::debugger::socket
+{
+
+#ifdef EMULATOR_DEBUGGER_USE_EPOLL
+Poller::Poller()
+{
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeEvent_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_ < 0 || wakeEvent_ < 0 || !Add(wakeEvent_)) {
+        Close();
+        throw std::runtime_error("Failed creating epoll instance");
+    }
+}
+
+Poller::~Poller()
+{
+    Close();
+}
+
+void Poller::Close() noexcept
+{
+    if (wakeEvent_ >= 0) {
+        close(wakeEvent_);
+        wakeEvent_ = -1;
+    }
+    if (epoll_ >= 0) {
+        close(epoll_);
+        epoll_ = -1;
+    }
+}
+
+bool Poller::Add(SOCKET socket) noexcept
+{
+    struct epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = socket;
+    return epoll_ctl(epoll_, EPOLL_CTL_ADD, socket, &event) == 0;
+}
+
+void Poller::Remove(SOCKET socket) noexcept
+{
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, socket, nullptr);
+}
+
+bool Poller::Wait(std::vector<Event>& events, std::chrono::milliseconds timeout) noexcept
+{
+    static constexpr int kMaxEvents = 64;
+    struct epoll_event ready[kMaxEvents];
+
+    events.clear();
+    int n = epoll_wait(epoll_, ready, kMaxEvents, static_cast<int>(timeout.count()));
+    if (n < 0) {
+        return errno == EINTR;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (ready[i].data.fd == wakeEvent_) {
+            DrainWake();
+            continue;
+        }
+
+        events.push_back({
+            .socket = ready[i].data.fd,
+            .readable = (ready[i].events & EPOLLIN) != 0,
+            .hangup = (ready[i].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR)) != 0,
+        });
+    }
+    return true;
+}
+
+void Poller::Wake() noexcept
+{
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto n = write(wakeEvent_, &one, sizeof(one));
+}
+
+void Poller::DrainWake() noexcept
+{
+    std::uint64_t count;
+    [[maybe_unused]] auto n = read(wakeEvent_, &count, sizeof(count));
+}
+#else
+Poller::Poller()
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    // Windows cannot poll a pipe, so there Wait relies on its timeout instead
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("Failed creating poller wake pipe");
+    }
+    wakeRead_ = fds[0];
+    wakeWrite_ = fds[1];
+    fcntl(wakeRead_, F_SETFL, fcntl(wakeRead_, F_GETFL) | O_NONBLOCK);
+    fcntl(wakeWrite_, F_SETFL, fcntl(wakeWrite_, F_GETFL) | O_NONBLOCK);
+    Add(wakeRead_);
+#endif
+}
+
+Poller::~Poller()
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    close(wakeRead_);
+    close(wakeWrite_);
+#endif
+}
+
+bool Poller::Add(SOCKET socket) noexcept
+{
+    fds_.push_back({.fd = socket, .events = POLLIN});
+    return true;
+}
+
+void Poller::Remove(SOCKET socket) noexcept
+{
+    std::erase_if(fds_, [socket](const struct pollfd& fd) { return fd.fd == socket; });
+}
+
+bool Poller::Wait(std::vector<Event>& events, std::chrono::milliseconds timeout) noexcept
+{
+    events.clear();
+#if defined(_WIN32) || defined(_WIN64)
+    int n = WSAPoll(fds_.data(), static_cast<ULONG>(fds_.size()), static_cast<INT>(timeout.count()));
+#else
+    int n = poll(fds_.data(), fds_.size(), static_cast<int>(timeout.count()));
+#endif
+    if (n < 0) {
+        return false;
+    }
+
+    for (auto& fd : fds_) {
+        if (fd.revents == 0) {
+            continue;
+        }
+
+        if (fd.fd == wakeRead_) {
+            DrainWake();
+        } else {
+            events.push_back({
+                .socket = fd.fd,
+                .readable = (fd.revents & POLLIN) != 0,
+                .hangup = (fd.revents & (POLLHUP | POLLERR)) != 0,
+            });
+        }
+        fd.revents = 0;
+    }
+    return true;
+}
+
+void Poller::Wake() noexcept
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    char one = 1;
+    [[maybe_unused]] auto n = write(wakeWrite_, &one, sizeof(one));
+#endif
+}
+
+void Poller::DrainWake() noexcept
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    char buf[64];
+    while (read(wakeRead_, buf, sizeof(buf)) > 0) {
+    }
+#endif
+}
+#endif
+
+}; // namespace emulator::debugger::socket
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "socket_internal.h"
+
+#include <chrono>
+#include <vector>
+
+#if defined(__linux__) && !defined(EMULATOR_DEBUGGER_USE_POLL)
+#define EMULATOR_DEBUGGER_USE_EPOLL 1
+#endif
+
+#if !defined(EMULATOR_DEBUGGER_USE_EPOLL) && !defined(_WIN32) && !defined(_WIN64)
+#include <poll.h>
+#endif
+
+namespace emulator::debugger::socket
+{
+
+/**
+ * Waits for readiness on many sockets at once, epoll on Linux and poll elsewhere.
+ * Wake can be called from any thread to return early from Wait.
+ */
+class Poller
+{
+public:
+    struct Event {
+        SOCKET socket;
+        bool readable;
+        bool hangup;
+    };
+
+private:
+#ifdef EMULATOR_DEBUGGER_USE_EPOLL
+    int epoll_{-1};
+    int wakeEvent_{-1};
+
+    void Close() noexcept;
+#else
+    std::vector<struct pollfd> fds_;
+    SOCKET wakeRead_{INVALID_SOCKET};
+    SOCKET wakeWrite_{INVALID_SOCKET};
+#endif
+
+    void DrainWake() noexcept;
+
+public:
+    Poller();
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    bool Add(SOCKET) noexcept;
+    void Remove(SOCKET) noexcept;
+
+    // Fills events with the sockets that are ready, returns false if waiting failed
+    bool Wait(std::vector<Event>& events, std::chrono::milliseconds timeout) noexcept;
+    void Wake() noexcept;
+};
+
+}; // namespace emulator::debugger::socket
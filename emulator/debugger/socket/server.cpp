@@ -36,6 +36,17 @@ void DebuggerSocketServer::SetTimeout(float seconds) noexcept
     timeout_.tv_usec = static_cast<long>(usecs * 1000000); // usecs in second
 }
 
+std::uint16_t DebuggerSocketServer::GetPort() const noexcept
+{
+    struct sockaddr_in sa;
+    std::memset(&sa, 0, sizeof(sa));
+    socklen_t len = sizeof(sa);
+    if (getsockname(server_, (struct sockaddr*)&sa, &len) != 0) {
+        return 0;
+    }
+    return ntohs(sa.sin_port);
+}
+
 DebuggerSocketClient* DebuggerSocketServer::Accept()
 {
     if (server_ == INVALID_SOCKET) {
@@ -65,6 +76,10 @@ DebuggerSocketClient* DebuggerSocketServer::Accept()
         std::memset(&sa, 0, sizeof(sa));
         socklen_t client_len = sizeof(sa);
         SOCKET client = accept(server_, (struct sockaddr*)&sa, &client_len);
+        if (client == INVALID_SOCKET) {
+            return nullptr;
+        }
+        socket::internal::SetNonBlocking(client);
 
         if (spdlog::get_level() <= spdlog::level::info) {
             char s[INET_ADDRSTRLEN];
@@ -18,7 +18,14 @@ public:
     DebuggerSocketServer(std::uint16_t port, bool onlyLocalhost);
     ~DebuggerSocketServer();
 
+    SOCKET GetSocket() const noexcept { return server_; }
+
+    // Port actually bound, for servers asked to listen on port 0
+    std::uint16_t GetPort() const noexcept;
+
     void SetTimeout(float seconds) noexcept;
+
+    // Returned clients are non-blocking, for use with a Poller
     DebuggerSocketClient* Accept();
 };
 
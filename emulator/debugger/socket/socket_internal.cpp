@@ -84,4 +84,24 @@ SOCKET CreateServerSocket(std::uint16_t port, bool localhost, int listenConns) n
     return sock;
 }
 
+bool SetNonBlocking(SOCKET sock) noexcept
+{
+#if defined(_WIN32) || defined(_WIN64)
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    return flags >= 0 && fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool WouldBlock() noexcept
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
 }; // namespace emulator::debugger::socket::internal
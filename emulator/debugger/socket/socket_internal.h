@@ -12,10 +12,13 @@
 #include <ws2tcpip.h>
 #else
 #include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
 #include <netdb.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 using SOCKET = int;
@@ -34,4 +37,9 @@ void DeinitNetworking() noexcept;
 
 SOCKET CreateServerSocket(std::uint16_t port, bool localhost = false, int listenConns = 5) noexcept;
 
+bool SetNonBlocking(SOCKET) noexcept;
+
+// Whether the last failed call on a non-blocking socket only needs to be retried later
+bool WouldBlock() noexcept;
+
 }; // namespace emulator::debugger::socket::internal
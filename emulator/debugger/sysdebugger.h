@@ -1,9 +1,21 @@
 #pragma once
 
+#include "breakpoints.h"
+#include "history.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <format>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace emulator::debugger
 {
@@ -133,6 +145,17 @@ struct RegisterInfo {
     }
 };
 
+struct MemoryRegion {
+    enum class Type {
+        RAM,
+        ROM,
+    };
+
+    Address start;
+    std::size_t length;
+    Type type;
+};
+
 enum class NotificationType {
     CPU_STEP,
 };
@@ -144,9 +167,66 @@ protected:
 
     bool stepMode_{false}; // Determine if the CPU should step or not
     std::size_t stepCount_{0};
-    std::function<void(void)> stepCompleteCallback_{nullptr};
 
-    mutable bool stopped_{true};
+    // Called on the emulation thread when a step or breakpoint stops the CPU
+    std::function<void(void)> stopCallback_{nullptr};
+
+    // Only touched by the emulation thread, other threads queue changes for it to apply
+    BreakpointTable breakpoints_;
+    bool resuming_{false};
+
+    struct BreakpointChange {
+        bool add;
+        Address address;
+        Condition condition;
+    };
+    std::mutex breakpointMutex_;
+    std::vector<BreakpointChange> pendingBreakpoints_;
+    std::atomic<bool> breakpointsChanged_{false};
+
+    // Reverse execution, history_ and replay_ are only touched by the emulation thread
+    History history_;
+    std::atomic<std::uint64_t> historyInterval_{0};
+    std::atomic<std::size_t> historyCapacity_{0};
+    std::atomic<bool> historyConfigured_{false};
+    std::atomic<bool> historyInvalidated_{false};
+
+    enum class ReverseMode : std::uint8_t {
+        None,
+        Step,
+        Continue,
+    };
+    std::atomic<ReverseMode> reverseRequest_{ReverseMode::None};
+
+    struct Replay {
+        ReverseMode mode{ReverseMode::None};
+        // Step: position to stop at, Continue: end of the window being searched
+        std::uint64_t target{0};
+        // Continue: checkpoint the window starts at, and the last breakpoint found in it
+        std::size_t checkpoint{0};
+        bool found{false};
+        std::uint64_t hit{0};
+    } replay_;
+    std::atomic<bool> replaying_{false};
+    std::atomic<bool> atHistoryStart_{false};
+
+    // Written by the debugger thread, read by the emulation thread every instruction
+    mutable std::atomic<bool> stopped_{true};
+    mutable std::mutex stopMutex_;
+    mutable std::condition_variable resumed_;
+
+    // Let the emulation thread go again, waking it if parked in WaitWhileStopped
+    void Resume() noexcept
+    {
+        // The instruction stopped at runs first, even if it has a breakpoint
+        resuming_ = true;
+        atHistoryStart_ = false;
+        {
+            std::lock_guard lock(stopMutex_);
+            stopped_ = false;
+        }
+        resumed_.notify_all();
+    }
 
 public:
     ISystemDebugger(std::string name) : name_(name)
@@ -156,7 +236,14 @@ public:
     virtual ~ISystemDebugger() = default;
 
     std::string GetName() const noexcept { return name_; }
-    bool IsStopped() const noexcept { return stopped_; };
+    bool IsStopped() const noexcept { return stopped_.load(std::memory_order_relaxed); };
+
+    // Park the emulation thread while stopped, returns whether it is still stopped after timeout
+    bool WaitWhileStopped(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock lock(stopMutex_);
+        return !resumed_.wait_for(lock, timeout, [this]() { return !stopped_.load(); });
+    }
 
     virtual std::uint32_t GetCurrentPID() const noexcept { return 1; }
 
@@ -169,30 +256,262 @@ public:
     virtual bool GetRegister(std::string name, std::uint64_t&) const noexcept = 0;
     virtual bool SetRegister(std::string name, std::uint64_t) noexcept = 0;
 
-    virtual std::uint8_t* ReadMemory(Address, std::size_t&) const noexcept = 0;
-    virtual bool WriteMemory(Address, void*, std::size_t) noexcept = 0;
+    // Numbered register access for compiled breakpoint conditions, -1 if name is unknown
+    virtual int RegisterIndex(std::string_view name) const noexcept { return -1; }
+    virtual std::uint64_t ReadRegister(int index) const noexcept { return 0; }
+
+    // Fills as much of data as is readable from address, returns the bytes read
+    virtual std::size_t ReadMemory(Address, std::span<std::uint8_t> data) const noexcept = 0;
+    // Writes all of data or nothing, returns whether it was written
+    virtual bool WriteMemory(Address, std::span<const std::uint8_t> data) noexcept = 0;
+
+    // Mapped regions in address order, without overlaps
+    virtual std::vector<MemoryRegion> GetMemoryMap() const { return {}; }
+
+    // Systems that can save and restore themselves support reverse execution.
+    // A checkpoint is taken as an instruction starts, counted by GetInstructionCount().
+    virtual bool SupportsReverse() const noexcept { return false; }
+    virtual std::unique_ptr<ICheckpoint> SaveCheckpoint() const { return nullptr; }
+    virtual void RestoreCheckpoint(const ICheckpoint&) {}
+    virtual std::uint64_t GetInstructionCount() const noexcept { return 0; }
+
+    // Checkpoint every interval instructions, keeping the latest ones, an interval of 0 turns history off
+    void EnableHistory(std::uint64_t interval, std::size_t checkpoints) noexcept
+    {
+        historyInterval_ = interval;
+        historyCapacity_ = checkpoints;
+        historyConfigured_.store(true, std::memory_order_release);
+    }
+
+    // Re-executing from a checkpoint, the system should not be paced to real time
+    bool IsReplaying() const noexcept { return replaying_.load(std::memory_order_relaxed); }
+
+    // Whether the last reverse request stopped at the oldest checkpoint instead of its target
+    bool AtHistoryStart() const noexcept { return atHistoryStart_.load(std::memory_order_relaxed); }
+
+    // Throws std::invalid_argument if condition does not compile, an empty one always stops
+    void AddBreakpoint(Address address, std::string_view condition = {})
+    {
+        Condition compiled;
+        if (!condition.empty()) {
+            compiled = Condition::Compile(condition, [this](std::string_view name) { return RegisterIndex(name); });
+        }
+
+        std::lock_guard lock(breakpointMutex_);
+        pendingBreakpoints_.push_back({true, address, std::move(compiled)});
+        breakpointsChanged_ = true;
+    }
+
+    void RemoveBreakpoint(Address address)
+    {
+        std::lock_guard lock(breakpointMutex_);
+        pendingBreakpoints_.push_back({false, address, {}});
+        breakpointsChanged_ = true;
+    }
 
     virtual void StepCPU(std::size_t instructions, std::function<void(void)> callback = nullptr) noexcept
     {
-        stepCompleteCallback_ = callback;
+        stopCallback_ = callback;
         stepCount_ = instructions;
         stepMode_ = true;
-        stopped_ = false;
+        Resume();
     }
 
-    virtual void RunCPU() noexcept
+    // callback is called once a breakpoint stops the CPU again
+    virtual void RunCPU(std::function<void(void)> callback = nullptr) noexcept
     {
+        stopCallback_ = callback;
         stepCount_ = 0;
         stepMode_ = false;
-        stopped_ = false;
+        Resume();
+    }
+
+    // Go back one instruction, callback is called once stopped there
+    void ReverseStep(std::function<void(void)> callback = nullptr) noexcept
+    {
+        Reverse(ReverseMode::Step, std::move(callback));
+    }
+
+    // Go back to the last breakpoint hit before the current instruction
+    void ReverseContinue(std::function<void(void)> callback = nullptr) noexcept
+    {
+        Reverse(ReverseMode::Continue, std::move(callback));
     }
 
     virtual void ShutdownCPU() noexcept
     {
     }
 
-    // Function that the emulator systems can call to alert of state changes
-    virtual void Notify(NotificationType type, void*) noexcept {};
+    // Function that the emulator systems can call to alert of state changes,
+    // CPU_STEP is sent as each instruction starts with data pointing at its Address
+    virtual void Notify(NotificationType type, void* data) noexcept
+    {
+        if (type != NotificationType::CPU_STEP) {
+            return;
+        }
+
+        if (breakpointsChanged_.load(std::memory_order_acquire)) [[unlikely]] {
+            ApplyBreakpointChanges();
+        }
+
+        auto address = data != nullptr ? *static_cast<const Address*>(data) : 0;
+        if (historyConfigured_.load(std::memory_order_acquire) || historyInvalidated_.load(std::memory_order_acquire)) [[unlikely]] {
+            ApplyHistoryChanges();
+        }
+        if (replay_.mode != ReverseMode::None || reverseRequest_.load(std::memory_order_acquire) != ReverseMode::None) [[unlikely]] {
+            Replay(address);
+            return;
+        }
+        if (history_.Enabled()) [[unlikely]] {
+            auto position = GetInstructionCount();
+            if (history_.Due(position)) {
+                history_.Record(position, address, SaveCheckpoint());
+            }
+        }
+
+        auto resuming = std::exchange(resuming_, false);
+        if (!resuming && data != nullptr && breakpoints_.Hit(address, *this)) {
+            Stop();
+            return;
+        }
+
+        if (!stepMode_) {
+            return;
+        }
+
+        // Stop once the requested instructions have run
+        if (stepCount_ > 0) {
+            --stepCount_;
+            return;
+        }
+        Stop();
+    }
+
+protected:
+    // The debugger changed registers or memory, so checkpoints ahead of here no longer follow from it
+    void InvalidateFutureHistory() noexcept
+    {
+        historyInvalidated_.store(true, std::memory_order_release);
+    }
+
+private:
+    void Reverse(ReverseMode mode, std::function<void(void)> callback) noexcept
+    {
+        stopCallback_ = std::move(callback);
+        stepCount_ = 0;
+        stepMode_ = false;
+        reverseRequest_.store(mode, std::memory_order_release);
+        Resume();
+    }
+
+    void ApplyHistoryChanges() noexcept
+    {
+        if (historyConfigured_.exchange(false)) {
+            history_.Configure(historyInterval_, historyCapacity_);
+        }
+        if (historyInvalidated_.exchange(false)) {
+            history_.Truncate(GetInstructionCount());
+        }
+    }
+
+    void Restore(std::size_t index, std::uint64_t& position, Address& address) noexcept
+    {
+        const auto& checkpoint = history_[index];
+        RestoreCheckpoint(*checkpoint.state);
+        position = checkpoint.position;
+        address = checkpoint.pc;
+    }
+
+    // Reached the oldest checkpoint without finding the target
+    void StopAtHistoryStart() noexcept
+    {
+        replay_.mode = ReverseMode::None;
+        replaying_ = false;
+        atHistoryStart_ = true;
+        Stop();
+    }
+
+    // Restore the closest checkpoint before target and run forward to it
+    void Seek(std::uint64_t target, std::uint64_t& position, Address& address) noexcept
+    {
+        Restore(history_.Find(target), position, address);
+        replay_.mode = ReverseMode::Step;
+        replay_.target = target;
+    }
+
+    // Drive a reverse request, started and then called as each replayed instruction starts
+    void Replay(Address address) noexcept
+    {
+        auto position = GetInstructionCount();
+
+        auto request = reverseRequest_.exchange(ReverseMode::None);
+        if (request != ReverseMode::None) {
+            resuming_ = false;
+            replaying_ = true;
+
+            // Nothing recorded before this instruction, it is as far back as history goes
+            if (position == 0 || history_.Find(position - 1) < 0) {
+                StopAtHistoryStart();
+                return;
+            }
+
+            if (request == ReverseMode::Step) {
+                Seek(position - 1, position, address);
+            } else {
+                // Search back one checkpoint interval at a time for the latest breakpoint hit
+                replay_ = {ReverseMode::Continue, position, static_cast<std::size_t>(history_.Find(position - 1)), false, 0};
+                Restore(replay_.checkpoint, position, address);
+            }
+        }
+
+        while (replay_.mode == ReverseMode::Continue && position >= replay_.target) {
+            if (replay_.found) {
+                Seek(replay_.hit, position, address);
+            } else if (replay_.checkpoint == 0) {
+                Restore(0, position, address);
+                StopAtHistoryStart();
+                return;
+            } else {
+                replay_.target = history_[replay_.checkpoint].position;
+                replay_.found = false;
+                Restore(--replay_.checkpoint, position, address);
+            }
+        }
+
+        if (replay_.mode == ReverseMode::Continue) {
+            if (breakpoints_.WouldHit(address, *this)) {
+                replay_.found = true;
+                replay_.hit = position;
+            }
+        } else if (position >= replay_.target) {
+            replay_.mode = ReverseMode::None;
+            replaying_ = false;
+            Stop();
+        }
+    }
+
+    void ApplyBreakpointChanges() noexcept
+    {
+        std::lock_guard lock(breakpointMutex_);
+        for (auto& change : pendingBreakpoints_) {
+            if (change.add) {
+                breakpoints_.Add(change.address, std::move(change.condition));
+            } else {
+                breakpoints_.Remove(change.address);
+            }
+        }
+        pendingBreakpoints_.clear();
+        breakpointsChanged_ = false;
+    }
+
+    void Stop() noexcept
+    {
+        stepMode_ = false;
+        stopped_ = true;
+        if (stopCallback_) {
+            std::exchange(stopCallback_, nullptr)();
+        }
+    }
 };
 
 }; // namespace emulator::debugger
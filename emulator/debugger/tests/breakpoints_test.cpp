@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <debugger/breakpoints.h>
+
+#include <array>
+#include <span>
+#include <string_view>
+
+using emulator::debugger::BreakpointTable;
+using emulator::debugger::Condition;
+
+// Registers r0-r3 and a page of memory holding the low byte of each address
+struct FakeTarget {
+    std::array<std::uint64_t, 4> registers{};
+
+    std::uint64_t ReadRegister(int index) const noexcept { return registers[index]; }
+
+    std::size_t ReadMemory(std::uint64_t address, std::span<std::uint8_t> data) const noexcept
+    {
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<std::uint8_t>(address + i);
+        }
+        return data.size();
+    }
+};
+
+static int Lookup(std::string_view name)
+{
+    if (name.size() == 2 && name[0] == 'r' && name[1] >= '0' && name[1] <= '3') {
+        return name[1] - '0';
+    }
+    return -1;
+}
+
+static bool Evaluate(std::string_view source, const FakeTarget& target, std::uint64_t hits = 1)
+{
+    return Condition::Compile(source, Lookup).Evaluate(target, hits);
+}
+
+// Test operators, precedence and operands
+TEST(BreakpointCondition, Evaluate)
+{
+    FakeTarget target;
+    target.registers = {0x10, 3, 0x80, 0};
+
+    ASSERT_TRUE(Condition().Evaluate(target, 0));
+    ASSERT_TRUE(Evaluate("r0 == 16", target));
+    ASSERT_TRUE(Evaluate("r0 == 0x10 && r1 != 2", target));
+    ASSERT_FALSE(Evaluate("r0 == 0x10 && r1 == 2", target));
+    ASSERT_TRUE(Evaluate("r3 || r1 >= 3", target));
+    ASSERT_TRUE(Evaluate("(r2 & 0x80) != 0", target));
+    ASSERT_TRUE(Evaluate("r0 + r1 - 1 == 0x12", target));
+    ASSERT_TRUE(Evaluate("!r3 && !(r1 < 3)", target));
+    ASSERT_TRUE(Evaluate("[0xff44] == 0x44", target));
+    ASSERT_TRUE(Evaluate("[r0 + 1] == 0x11", target));
+    ASSERT_TRUE(Evaluate("r1|r3^4 == 7", target));
+
+    ASSERT_FALSE(Evaluate("hits > 100", target, 100));
+    ASSERT_TRUE(Evaluate("hits > 100", target, 101));
+}
+
+// Test malformed conditions are rejected when compiled
+TEST(BreakpointCondition, Errors)
+{
+    for (auto source : {"", "r0 ==", "r9 == 1", "(r0", "[r0", "0x == 1", "r0 = 1", "r0 == 1 garbage"}) {
+        ASSERT_THROW(Condition::Compile(source, Lookup), std::invalid_argument) << source;
+    }
+
+    std::string deep(Condition::kMaxStack, '(');
+    for (std::size_t i = 0; i < Condition::kMaxStack; i++) {
+        deep += "1+(";
+    }
+    ASSERT_THROW(Condition::Compile(deep, Lookup), std::invalid_argument);
+}
+
+// Test lookups across pages and hit counting
+TEST(BreakpointTable, Hits)
+{
+    FakeTarget target;
+    BreakpointTable table;
+    ASSERT_FALSE(table.Hit(0x100, target));
+
+    table.Add(0x100);
+    table.Add(0x1FF, Condition::Compile("hits == 3", Lookup));
+    table.Add(0x10000);
+
+    ASSERT_TRUE(table.Hit(0x100, target));
+    ASSERT_FALSE(table.Hit(0x101, target));
+    ASSERT_FALSE(table.Hit(0x200, target));
+    ASSERT_TRUE(table.Hit(0x10000, target));
+
+    ASSERT_FALSE(table.Hit(0x1FF, target));
+    ASSERT_FALSE(table.Hit(0x1FF, target));
+    ASSERT_TRUE(table.Hit(0x1FF, target));
+    ASSERT_EQ(table.GetHits(0x1FF), 3);
+
+    ASSERT_TRUE(table.Remove(0x100));
+    ASSERT_FALSE(table.Remove(0x100));
+    ASSERT_FALSE(table.Hit(0x100, target));
+    ASSERT_TRUE(table.Contains(0x1FF));
+    ASSERT_EQ(table.Size(), 2);
+}
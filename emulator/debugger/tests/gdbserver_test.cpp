@@ -0,0 +1,396 @@
+#include <gtest/gtest.h>
+
+#include <debugger/debugger.h>
+#include <debugger/socket/socket_internal.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <string>
+#include <vector>
+
+using emulator::debugger::Debugger;
+using emulator::debugger::ISystemDebugger;
+
+class FakeDebugger : public ISystemDebugger
+{
+public:
+    FakeDebugger(std::string name) : ISystemDebugger(name)
+    {
+    }
+
+    constexpr std::uint32_t GetPtrSize() const noexcept override { return 2; }
+    const emulator::debugger::RegisterInfo* GetRegisterInfo(std::size_t) const noexcept override { return nullptr; }
+    void HandleSignal(std::uint8_t) const noexcept override { stopped_ = true; }
+    bool GetRegister(std::string, std::uint64_t&) const noexcept override { return false; }
+    bool SetRegister(std::string, std::uint64_t) noexcept override { return false; }
+
+    std::array<std::uint8_t, 0x10> ram{};
+
+    // RAM sits at 0xC000, everything else is read only
+    bool WriteMemory(emulator::debugger::Address address, std::span<const std::uint8_t> data) noexcept override
+    {
+        if (address < 0xC000 || address + data.size() > 0xC000 + ram.size()) {
+            return false;
+        }
+        std::copy(data.begin(), data.end(), ram.begin() + (address - 0xC000));
+        return true;
+    }
+
+    std::vector<emulator::debugger::MemoryRegion> GetMemoryMap() const override
+    {
+        return {{0x0000, 0x8000, emulator::debugger::MemoryRegion::Type::ROM},
+                {0xC000, 0x10, emulator::debugger::MemoryRegion::Type::RAM}};
+    }
+
+    // Memory holds the low byte of its address up to 0x10000, apart from RAM
+    std::size_t ReadMemory(emulator::debugger::Address address, std::span<std::uint8_t> data) const noexcept override
+    {
+        auto n = address < 0x10000 ? std::min<std::size_t>(data.size(), 0x10000 - address) : 0;
+        for (std::size_t i = 0; i < n; i++) {
+            auto current = address + i;
+            data[i] = current >= 0xC000 && current < 0xC000 + ram.size() ? ram[current - 0xC000]
+                                                                         : static_cast<std::uint8_t>(current);
+        }
+        return n;
+    }
+};
+
+// Minimal blocking gdb client
+class GDBClient
+{
+private:
+    SOCKET socket_{INVALID_SOCKET};
+
+public:
+    GDBClient(std::uint16_t port)
+    {
+        socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        struct timeval timeout{.tv_sec = 5, .tv_usec = 0};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+        struct sockaddr_in sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+        if (connect(socket_, (struct sockaddr*)&sa, sizeof(sa)) != 0) {
+            closesocket(socket_);
+            socket_ = INVALID_SOCKET;
+        }
+    }
+
+    ~GDBClient()
+    {
+        if (socket_ != INVALID_SOCKET) {
+            closesocket(socket_);
+        }
+    }
+
+    bool Connected() const noexcept
+    {
+        return socket_ != INVALID_SOCKET;
+    }
+
+    static std::string Frame(std::string data)
+    {
+        std::uint8_t chksum = 0;
+        for (auto c : data) {
+            chksum += c;
+        }
+        return std::format("+${}#{:02x}", data, chksum);
+    }
+
+    void SendRaw(std::string_view data)
+    {
+        send(socket_, data.data(), static_cast<int>(data.size()), 0);
+    }
+
+    void Send(std::string data)
+    {
+        SendRaw(Frame(data));
+    }
+
+    // Payload of the next response packet, empty on timeout
+    std::string Receive()
+    {
+        std::string buffer;
+        char c;
+        while (recv(socket_, &c, 1, 0) == 1) {
+            buffer += c;
+
+            auto end = buffer.find('#');
+            if (end != std::string::npos && buffer.size() == end + 3) {
+                auto start = buffer.find('$');
+                return buffer.substr(start + 1, end - start - 1);
+            }
+        }
+        return "";
+    }
+};
+
+// Test each port serves the system it was bound to, with several clients connected at once
+TEST(GDBServer, ConcurrentSessions)
+{
+    Debugger debugger;
+    auto first = new FakeDebugger("First");
+    auto second = new FakeDebugger("Second");
+    debugger.RegisterDebugger(first);
+    debugger.RegisterDebugger(second);
+
+    auto firstPort = debugger.StartRemote(first, 0);
+    auto secondPort = debugger.StartRemote(second, 0);
+    ASSERT_NE(firstPort, 0);
+    ASSERT_NE(secondPort, 0);
+    ASSERT_NE(firstPort, secondPort);
+
+    GDBClient a(firstPort), b(secondPort), c(firstPort);
+    ASSERT_TRUE(a.Connected());
+    ASSERT_TRUE(b.Connected());
+    ASSERT_TRUE(c.Connected());
+
+    b.Send("qHostInfo");
+    a.Send("qHostInfo");
+    c.Send("qHostInfo");
+    ASSERT_EQ(a.Receive(), "hostname:emulator;vendor:First");
+    ASSERT_EQ(b.Receive(), "hostname:emulator;vendor:Second");
+    ASSERT_EQ(c.Receive(), "hostname:emulator;vendor:First");
+}
+
+// Test connections to the shared port are served by the debugger selected when they connect
+TEST(GDBServer, SelectedDebugger)
+{
+    Debugger debugger;
+    debugger.RegisterDebugger(new FakeDebugger("First"));
+    debugger.RegisterDebugger(new FakeDebugger("Second"));
+
+    auto port = debugger.StartRemote(0);
+
+    ASSERT_TRUE(debugger.SelectDebugger("Second"));
+    GDBClient client(port);
+    client.Send("qHostInfo");
+    ASSERT_EQ(client.Receive(), "hostname:emulator;vendor:Second");
+}
+
+// Test a step finishing on another thread sends its stop reply
+TEST(GDBServer, StepReply)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    client.Send("s");
+
+    // Wait for the step to be requested, as the emulation thread would
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (target->IsStopped() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    ASSERT_FALSE(target->IsStopped());
+
+    // Start of the stepped instruction, then the next
+    target->Notify(emulator::debugger::NotificationType::CPU_STEP, nullptr);
+    target->Notify(emulator::debugger::NotificationType::CPU_STEP, nullptr);
+    ASSERT_TRUE(target->IsStopped());
+    ASSERT_EQ(client.Receive(), "S05");
+}
+
+// Test a full address space dump, requested by a packet that arrives in pieces
+TEST(GDBServer, MemoryRead)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    auto packet = GDBClient::Frame("m0,10000");
+    client.SendRaw(packet.substr(0, 5));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    client.SendRaw(packet.substr(5));
+
+    auto response = client.Receive();
+    ASSERT_EQ(response.size(), 0x20000);
+    ASSERT_EQ(response.substr(0, 8), "00010203");
+    ASSERT_EQ(response.substr(0x1FE * 2, 4), "feff");
+
+    // Reads running off the end are short
+    client.Send("mfffe,10");
+    ASSERT_EQ(client.Receive(), "feff");
+}
+
+// Test binary reads escape framing characters, and only gdb gets the 'b' prefix
+TEST(GDBServer, BinaryRead)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    // '#' and '$' follow each other at 0x23 and 0x24
+    client.Send("x0,0");
+    ASSERT_EQ(client.Receive(), "OK");
+    client.Send("x22,3");
+    ASSERT_EQ(client.Receive(), "\"}\x03}\x04");
+
+    GDBClient gdb(debugger.StartRemote(target, 0));
+    gdb.Send("qSupported:binary-upload+");
+    ASSERT_NE(gdb.Receive().find("binary-upload+"), std::string::npos);
+    gdb.Send("x0,0");
+    ASSERT_EQ(gdb.Receive(), "b");
+    gdb.Send("x7d,1");
+    ASSERT_EQ(gdb.Receive(), "b}]");
+}
+
+// Test hex and binary writes land in memory, and writes outside RAM fail
+TEST(GDBServer, MemoryWrite)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    client.Send("Mc000,2:beef");
+    ASSERT_EQ(client.Receive(), "OK");
+    client.Send("Xc002,2:}\x03*");
+    ASSERT_EQ(client.Receive(), "OK");
+    client.Send("mc000,4");
+    ASSERT_EQ(client.Receive(), "beef232a");
+
+    client.Send("X0,0:");
+    ASSERT_EQ(client.Receive(), "OK");
+    client.Send("X100,1:a");
+    ASSERT_EQ(client.Receive(), "E01");
+    client.Send("Xc000,2:a");
+    ASSERT_EQ(client.Receive(), "E01");
+}
+
+// Test the memory map is generated from the target and can be read in pieces
+TEST(GDBServer, MemoryMap)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    std::string map;
+    for (int i = 0; i < 100; i++) {
+        client.Send(std::format("qXfer:memory-map:read::{:x},20", map.size()));
+        auto response = client.Receive();
+        ASSERT_FALSE(response.empty());
+        map += response.substr(1);
+        if (response[0] == 'l') {
+            break;
+        }
+        ASSERT_EQ(response[0], 'm');
+    }
+
+    ASSERT_NE(map.find("<memory type=\"rom\" start=\"0x0\" length=\"0x8000\"/>"), std::string::npos);
+    ASSERT_NE(map.find("<memory type=\"ram\" start=\"0xc000\" length=\"0x10\"/>"), std::string::npos);
+    ASSERT_TRUE(map.ends_with("</memory-map>\n"));
+
+    client.Send("qMemoryRegionInfo:c008");
+    ASSERT_EQ(client.Receive(), "start:c000;size:10;permissions:rwx;");
+    client.Send("qMemoryRegionInfo:8000");
+    ASSERT_EQ(client.Receive(), "start:8000;size:4000;");
+}
+
+// Test a continue is answered when the target reaches a breakpoint, conditional ones set with monitor
+TEST(GDBServer, Breakpoints)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+
+    client.Send("Z0,150,1");
+    ASSERT_EQ(client.Receive(), "OK");
+
+    // monitor break 0x160 if [0xc000] == 7
+    std::string command = "break 0x160 if [0xc000] == 7";
+    auto hex = [](std::string_view text) {
+        std::string out;
+        for (auto c : text) {
+            out += std::format("{:02x}", static_cast<std::uint8_t>(c));
+        }
+        return out;
+    };
+    client.Send("qRcmd," + hex(command));
+    ASSERT_TRUE(client.Receive().starts_with("O" + hex("Breakpoint at 0x160 if")));
+    ASSERT_EQ(client.Receive(), "OK");
+
+    auto resume = [&]() {
+        client.Send("c");
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (target->IsStopped() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        ASSERT_FALSE(target->IsStopped());
+    };
+    auto execute = [&](emulator::debugger::Address pc) {
+        target->Notify(emulator::debugger::NotificationType::CPU_STEP, &pc);
+    };
+
+    resume();
+    execute(0x100);
+    execute(0x160);
+    ASSERT_FALSE(target->IsStopped());
+    execute(0x150);
+    ASSERT_TRUE(target->IsStopped());
+    ASSERT_EQ(client.Receive(), "S05");
+
+    // Resuming runs the instruction stopped at before breakpoints apply again
+    resume();
+    execute(0x150);
+    target->ram[0] = 7;
+    execute(0x160);
+    ASSERT_TRUE(target->IsStopped());
+    ASSERT_EQ(client.Receive(), "S05");
+
+    client.Send("z0,150,1");
+    ASSERT_EQ(client.Receive(), "OK");
+    resume();
+    execute(0x160);
+    execute(0x150);
+    ASSERT_FALSE(target->IsStopped());
+}
+
+// Test reverse execution is refused by targets that cannot restore themselves
+TEST(GDBServer, ReverseUnsupported)
+{
+    Debugger debugger;
+    auto target = new FakeDebugger("Target");
+    debugger.RegisterDebugger(target);
+
+    GDBClient client(debugger.StartRemote(target, 0));
+    client.Send("qSupported:multiprocess+");
+    ASSERT_EQ(client.Receive().find("ReverseStep+"), std::string::npos);
+
+    client.Send("?");
+    ASSERT_EQ(client.Receive(), "S05");
+    client.Send("bs");
+    ASSERT_EQ(client.Receive(), "");
+    client.Send("bc");
+    ASSERT_EQ(client.Receive(), "");
+    ASSERT_TRUE(target->IsStopped());
+}
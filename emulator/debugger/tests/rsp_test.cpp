@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <debugger/rsp.h>
+
+#include <string>
+#include <vector>
+
+using emulator::debugger::rsp::PacketParser;
+
+// Feed the whole input, collecting each event as "type:data"
+static std::vector<std::string> Parse(PacketParser& parser, std::string_view input)
+{
+    static const char* kNames[] = {"ack", "nack", "interrupt", "packet", "notification", "invalid"};
+
+    std::vector<std::string> events;
+    std::span<const std::uint8_t> bytes(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+    PacketParser::Event event;
+    while (parser.Next(bytes, event)) {
+        events.push_back(std::string(kNames[static_cast<int>(event.type)]) + ":" + std::string(event.data));
+    }
+    return events;
+}
+
+// Test complete packets and the single character messages between them
+TEST(RSPParser, Packets)
+{
+    PacketParser parser;
+    auto events = Parse(parser, "+$qC#b4-\x03%Stop:T05#99");
+    ASSERT_EQ(events, (std::vector<std::string>{"ack:", "packet:qC", "nack:", "interrupt:", "notification:Stop:T05"}));
+}
+
+// Test a packet split across reads at every position
+TEST(RSPParser, SplitPackets)
+{
+    std::string_view packet = "$m8000,10#c2";
+    for (std::size_t split = 0; split <= packet.size(); split++) {
+        PacketParser parser;
+        auto first = Parse(parser, packet.substr(0, split));
+        auto second = Parse(parser, packet.substr(split));
+
+        first.insert(first.end(), second.begin(), second.end());
+        ASSERT_EQ(first, (std::vector<std::string>{"packet:m8000,10"})) << "split at " << split;
+    }
+}
+
+// Test escaped bytes are decoded and count towards the checksum as sent
+TEST(RSPParser, Escapes)
+{
+    PacketParser parser;
+    auto events = Parse(parser, "$X0,1:}\x03#9f");
+    ASSERT_EQ(events, (std::vector<std::string>{"packet:X0,1:#"}));
+}
+
+// Test bad checksums and oversized packets are reported and parsing recovers
+TEST(RSPParser, Invalid)
+{
+    PacketParser parser;
+    ASSERT_EQ(Parse(parser, "$qC#00$qC#b4"), (std::vector<std::string>{"invalid:", "packet:qC"}));
+    ASSERT_EQ(Parse(parser, "$qC#zz"), (std::vector<std::string>{"invalid:"}));
+
+    std::string big = "$" + std::string(PacketParser::kMaxPacketSize + 1, '0') + "#00";
+    ASSERT_EQ(Parse(parser, big), (std::vector<std::string>{"invalid:"}));
+    ASSERT_EQ(Parse(parser, "$qC#B4"), (std::vector<std::string>{"packet:qC"}));
+}
+
+// Test hex encoding and decoding
+TEST(RSPParser, Hex)
+{
+    std::string out = "b ";
+    std::uint8_t data[] = {0x00, 0x9A, 0xFF};
+    emulator::debugger::rsp::AppendHex(out, data);
+    ASSERT_EQ(out, "b 009aff");
+
+    std::uint8_t decoded[3] = {};
+    ASSERT_EQ(emulator::debugger::rsp::DecodeHex("009AfF", decoded), 3);
+    ASSERT_EQ(decoded[1], 0x9A);
+    ASSERT_EQ(decoded[2], 0xFF);
+
+    std::string_view args = "C0DE,8";
+    std::uint64_t value = 0;
+    ASSERT_TRUE(emulator::debugger::rsp::ParseHex(args, value));
+    ASSERT_EQ(value, 0xC0DE);
+    ASSERT_EQ(args, ",8");
+    ASSERT_FALSE(emulator::debugger::rsp::ParseHex(args, value));
+}
@@ -7,6 +7,7 @@
 
 #include "emumanager.h"
 
+#include <components/audio.h>
 #include <components/display.h>
 #include <components/input.h>
 #include <components/system.h>
@@ -54,6 +55,7 @@ protected:
 
     emulator::component::Display* display_{nullptr};
     std::vector<emulator::component::Input*> inputs_;
+    emulator::component::Audio* audio_{nullptr};
 
     std::size_t width_{1280}, height_{720};
 
@@ -75,6 +77,7 @@ protected:
                 system_->Run(systemStatus_);
                 system_->PowerOff();
                 spdlog::info("Emulator {} exited", system_->Name());
+                spdlog::info("[Perf] {}", system_->GetPerfSnapshot().ToJson());
             } catch (const std::exception& e) {
                 spdlog::error("Emulator {} exited with exception: {}", system_->Name(), e.what());
                 system_->LogStacktrace();
@@ -124,6 +127,7 @@ protected:
             throw std::runtime_error("Failed to load display component");
         }
         LoadInputs();
+        LoadAudio();
     }
 
     bool LoadDisplay() noexcept
@@ -146,6 +150,12 @@ protected:
                        });
     }
 
+    // Systems without sound leave audio_ null
+    void LoadAudio() noexcept
+    {
+        audio_ = system_->GetFirstComponentByType<emulator::component::Audio>(emulator::component::IComponent::ComponentType::Sound);
+    }
+
 private:
     emulator::component::System* GetSystem(const std::string& name,
                                            bool enableDebugger) const noexcept
@@ -6,6 +6,11 @@
 #include "imgui_impl_sdl3.h"
 #include "imgui_impl_sdlrenderer3.h"
 
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <span>
+
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_surface.h>
 #if defined(IMGUI_IMPL_OPENGL_ES2)
@@ -31,7 +36,7 @@ ImGuiFrontend::ImGuiFrontend(emulator::core::EmulatorManager* manager) : emulato
 bool ImGuiFrontend::Initialize() noexcept
 {
     // Setup SDL
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD)) {
+    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMEPAD)) {
         return false;
     }
 
@@ -139,7 +144,10 @@ void ImGuiFrontend::Run()
             if (ImGui::BeginMenu("Emulator")) {
                 for (const auto& emulatorName : manager_->GetLoadedEmulators()) {
                     if (ImGui::MenuItem(emulatorName.c_str())) {
+                        // The audio device reads from the system being replaced
+                        CloseAudio();
                         LoadSystem(emulatorName);
+                        OpenAudio();
                         ScaleSystemDisplay(5);
                     }
                 }
@@ -168,6 +176,85 @@ void ImGuiFrontend::Run()
                         RunSystem();
                     }
 
+                    ImGui::MenuItem("Performance", nullptr, &showPerformance_);
+
+                    auto& profiler = system_->GetProfiler();
+                    if (ImGui::MenuItem("Profiler", nullptr, profiler.Enabled())) {
+                        profiler.SetEnabled(!profiler.Enabled());
+                    }
+                    if (ImGui::MenuItem("Save Profile", nullptr, false, profiler.GetSampleCount() != 0)) {
+                        SaveProfile();
+                    }
+
+                    // Traces start from power on so they can be compared between runs
+                    if (!system_->Tracing() && ImGui::MenuItem("Record Trace")) {
+                        frontendInterface_.RestartSystem([this]() {
+                            try {
+                                system_->StartTrace(system_->Name() + ".trace");
+                            } catch (const std::exception& e) {
+                                spdlog::error("Failed to start trace: {}", e.what());
+                            }
+                        });
+                    } else if (system_->Tracing() && ImGui::MenuItem("Stop Trace")) {
+                        StopSystem();
+                        system_->StopTrace();
+                    }
+
+                    // Movies also start from power on, keys are replayed by frame
+                    if (!inputs_.empty()) {
+                        auto input = inputs_.front();
+                        if (input->RecordingMovie() && ImGui::MenuItem("Stop Movie")) {
+                            StopSystem();
+                            auto movie = input->StopMovie();
+                            std::ofstream file(system_->Name() + ".movie", std::ios::binary);
+                            try {
+                                movie->Save(file);
+                            } catch (const std::exception& e) {
+                                spdlog::error("Failed to save movie: {}", e.what());
+                            }
+                        } else if (input->PlayingMovie() && ImGui::MenuItem("Stop Movie")) {
+                            input->StopMovie();
+                        } else if (!input->RecordingMovie() && !input->PlayingMovie()) {
+                            if (ImGui::MenuItem("Record Movie")) {
+                                frontendInterface_.RestartSystem([input]() { input->RecordMovie(); });
+                            }
+                            if (ImGui::MenuItem("Play Movie")) {
+                                auto path = FileDialog("", {{"Movie", {"movie"}}, {"All Files", {"*"}}}).Open();
+                                if (!path.empty()) {
+                                    frontendInterface_.RestartSystem([input, path]() {
+                                        try {
+                                            std::ifstream file(path, std::ios::binary);
+                                            input->PlayMovie(emulator::component::Movie::Load(file));
+                                        } catch (const std::exception& e) {
+                                            spdlog::error("Failed to play movie: {}", e.what());
+                                        }
+                                    });
+                                }
+                            }
+                        }
+                    }
+
+                    if (audio_ != nullptr && !audio_->WritingWav() && ImGui::MenuItem("Record Audio")) {
+                        StopSystem();
+                        try {
+                            audio_->StartWav(system_->Name() + ".wav");
+                        } catch (const std::exception& e) {
+                            spdlog::error("Failed to record audio: {}", e.what());
+                        }
+                        RunSystem();
+                    } else if (audio_ != nullptr && audio_->WritingWav() && ImGui::MenuItem("Stop Audio")) {
+                        StopSystem();
+                        audio_->StopWav();
+                        RunSystem();
+                    }
+
+                    if (audioStream_ != nullptr) {
+                        bool audioSync = system_->AudioSync();
+                        if (ImGui::MenuItem("Sync to Audio", nullptr, &audioSync)) {
+                            system_->SetAudioSync(audioSync);
+                        }
+                    }
+
                     // Custom system functions
                     for (const auto& [name, function] : system_->GetFrontendFunctions()) {
                         if (ImGui::MenuItem(name.c_str())) {
@@ -185,6 +272,10 @@ void ImGuiFrontend::Run()
             ImGui::EndMainMenuBar();
         }
 
+        if (showPerformance_ && system_ != nullptr) {
+            DrawPerformanceOverlay();
+        }
+
         // Render system display into current window
         static ImVec2 topLeft = ImVec2(0.0f, menuBarHeight_);
 
@@ -219,9 +310,10 @@ void ImGuiFrontend::Run()
             SDL_DestroyTexture(texture);
         }
 
-        // Sleep until next tick
+        // Sleep until next tick, unless the audio is pacing the system and vsync the drawing
         auto endTick = SDL_GetTicks();
-        if (endTick - startTick < 1000 / targetFPS_) {
+        auto audioSync = system_ != nullptr && audioStream_ != nullptr && system_->AudioSync();
+        if (!audioSync && endTick - startTick < 1000 / targetFPS_) {
             SDL_Delay((1000 / targetFPS_) - (endTick - startTick));
         }
     }
@@ -230,11 +322,115 @@ void ImGuiFrontend::Run()
     StopSystem();
 }
 
+// Runs on SDL's audio thread, the only consumer of the component's ring buffer
+static void SDLCALL AudioCallback(void* userdata, SDL_AudioStream* stream, int additional, int total)
+{
+    using Sample = emulator::component::Audio::Sample;
+
+    auto audio = static_cast<emulator::component::Audio*>(userdata);
+    std::array<Sample, 1024> samples;
+
+    auto wanted = std::size_t(additional) / sizeof(Sample);
+    while (wanted > 0) {
+        auto count = std::min(wanted, samples.size());
+        auto read = audio->ReadSamples(std::span(samples).first(count));
+
+        // Falling behind plays silence instead of stalling the device
+        std::fill(samples.begin() + read, samples.begin() + count, Sample(0));
+        SDL_PutAudioStreamData(stream, samples.data(), int(count * sizeof(Sample)));
+        wanted -= count;
+    }
+}
+
+void ImGuiFrontend::OpenAudio()
+{
+    if (audio_ == nullptr) {
+        return;
+    }
+
+    SDL_AudioSpec spec{SDL_AUDIO_S16, 1, int(audio_->GetSampleRate())};
+    auto stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, AudioCallback, audio_);
+    if (stream == nullptr) {
+        spdlog::error("Failed to open audio device: {}", SDL_GetError());
+        return;
+    }
+    SDL_ResumeAudioStreamDevice(stream);
+    audioStream_ = stream;
+
+    // The device drains the ring at the host rate, a steadier clock than sleeping per tick
+    system_->SetAudioSync(true);
+}
+
+void ImGuiFrontend::CloseAudio() noexcept
+{
+    if (audioStream_ != nullptr) {
+        SDL_DestroyAudioStream((SDL_AudioStream*)audioStream_);
+        audioStream_ = nullptr;
+        if (system_ != nullptr) {
+            system_->SetAudioSync(false);
+        }
+    }
+}
+
+void ImGuiFrontend::SaveProfile()
+{
+    auto& profiler = system_->GetProfiler();
+    auto name = system_->Name();
+
+    // Flat listing for reading, collapsed stacks for flamegraph tools
+    std::ofstream(name + ".profile.txt") << profiler.ExportFlat();
+    std::ofstream(name + ".profile.folded") << profiler.ExportCollapsed(name);
+    spdlog::info("[Profiler] Saved {} samples to {}.profile.txt", profiler.GetSampleCount(), name);
+}
+
+void ImGuiFrontend::DrawPerformanceOverlay()
+{
+    auto snapshot = system_->GetPerfSnapshot();
+
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    if (!ImGui::Begin("Performance", &showPerformance_, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Speed:        %.1f%%", snapshot.speed * 100.0);
+    ImGui::Text("Cycles/s:     %.0f", snapshot.cyclesPerSecond);
+    ImGui::Text("Instrs/s:     %.0f", snapshot.instructionsPerSecond);
+    ImGui::Text("Frames/s:     %.1f", snapshot.framesPerSecond);
+    ImGui::Separator();
+    ImGui::Text("Work / Sleep: %.2fs / %.2fs", snapshot.workSeconds, snapshot.sleepSeconds);
+    ImGui::Text("Behind:       %.3fs", snapshot.behindSeconds);
+
+    if (!snapshot.components.empty() && ImGui::BeginTable("Components", 3, ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Component");
+        ImGui::TableSetupColumn("ns/tick");
+        ImGui::TableSetupColumn("Share");
+        ImGui::TableHeadersRow();
+        for (const auto& component : snapshot.components) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(component.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", component.averageTickNanoseconds);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", component.share * 100.0);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Copy JSON")) {
+        ImGui::SetClipboardText(snapshot.ToJson().c_str());
+    }
+    ImGui::End();
+}
+
 void ImGuiFrontend::Shutdown() noexcept
 {
     SDL_Window* window = (SDL_Window*)window_;
     SDL_Renderer* renderer = SDL_GetRenderer(window);
 
+    CloseAudio();
+
     // Cleanup
     ImGui_ImplSDLRenderer3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
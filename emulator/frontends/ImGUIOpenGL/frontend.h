@@ -9,10 +9,20 @@ class ImGuiFrontend : public emulator::frontend::IFrontend
 {
 private:
     void* window_;
+    void* audioStream_{nullptr};
     std::size_t menuBarHeight_{0};
 
     std::uint64_t targetFPS_{60};
 
+    bool showPerformance_{false};
+
+    void DrawPerformanceOverlay();
+    void SaveProfile();
+
+    // Plays the system's Audio component on the default device, if it has one
+    void OpenAudio();
+    void CloseAudio() noexcept;
+
 public:
     ImGuiFrontend(emulator::core::EmulatorManager* manager);
 
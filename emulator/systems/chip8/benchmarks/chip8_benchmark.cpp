@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+
+// Register heavy loop with a memory store, args(0) enables the dynarec
+static void BM_Chip8Instructions(benchmark::State& state)
+{
+    if (state.range(0) && !emulator::chip8::Dynarec::Available()) {
+        state.SkipWithError("Dynarec not supported on this host");
+        return;
+    }
+
+    const std::uint8_t program[] = {
+        0x70, 0x01, // ADD V0, 1
+        0x81, 0x04, // ADD V1, V0
+        0x82, 0x15, // SUB V2, V1
+        0x83, 0x26, // SHR V3, V2
+        0x84, 0x31, // OR V4, V3
+        0xA3, 0x00, // LD I, 0x300
+        0xF4, 0x1E, // ADD I, V4
+        0xF0, 0x55, // LD [I], V0
+        0x12, 0x00, // JP 0x200
+    };
+
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"));
+    auto& bus = system->GetBus();
+
+    bus.PowerOn();
+    for (std::size_t i = 0; i < sizeof(program); i++) {
+        bus.Write<std::uint8_t>(0x200 + i, program[i]);
+    }
+    cpu->SetDynarecEnabled(state.range(0));
+
+    auto instructions = cpu->GetInstructionCount();
+    for (auto _ : state) {
+        bus.ReceiveTick();
+    }
+
+    state.SetItemsProcessed(cpu->GetInstructionCount() - instructions);
+    delete system;
+}
+BENCHMARK(BM_Chip8Instructions)->ArgName("dynarec")->Arg(0)->Arg(1);
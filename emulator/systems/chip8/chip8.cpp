@@ -31,44 +31,47 @@ static const std::uint8_t fontset[] =
 
 emulator::component::System* CreateSystem()
 {
+    constexpr static std::size_t kBusSpeed = 60 * 8;
+
     auto interpreter = new emulator::component::Memory<emulator::component::MemoryType::ReadOnly>(0, 0x200);
     auto memory = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0x200, 0xE00);
 
     interpreter->LoadData((const char*)fontset, sizeof(fontset), emulator::chip8::CPU::kFontSetBaseAddress);
 
-    auto input = new emulator::component::Input();
+    // Keys change at most once per 60Hz frame
+    auto input = new emulator::component::Input(kBusSpeed / 60);
     auto cpu = new emulator::chip8::CPU();
 
+
     /*
     1 2 3 C          1 2 3 4
     4 5 6 D   ---\   Q W E R
     7 8 9 E   ---/   A S D F
     A 0 B F          Z X C V
      */
+    // Indexed by Chip8 key, registered in order so each key's slot is its value
     constexpr static std::uint8_t kKeycodes[] = {
-        0x31,
-        0x32,
-        0x33,
-        0x34,
-        0x71,
-        0x77,
-        0x65,
-        0x72,
-        0x61,
-        0x73,
-        0x64,
-        0x66,
-        0x7A,
-        0x78,
-        0x63,
-        0x76,
+        0x78, // 0: X
+        0x31, // 1: 1
+        0x32, // 2: 2
+        0x33, // 3: 3
+        0x71, // 4: Q
+        0x77, // 5: W
+        0x65, // 6: E
+        0x61, // 7: A
+        0x73, // 8: S
+        0x64, // 9: D
+        0x7A, // A: Z
+        0x63, // B: C
+        0x34, // C: 4
+        0x72, // D: R
+        0x66, // E: F
+        0x76, // F: V
     };
     for (int i = 0; i < sizeof(kKeycodes); i++) {
         input->RegisterKey(kKeycodes[i]);
     }
-    cpu->LoadKeymap(kKeycodes);
 
-    constexpr static std::size_t kBusSpeed = 60 * 8;
     auto system = new emulator::component::System(
         "Chip8",
         kBusSpeed,
@@ -82,6 +85,9 @@ emulator::component::System* CreateSystem()
             {"Input", input},
         });
 
+    // Programs writing over the interpreter area or past the end of RAM are logged, not fatal
+    system->GetBus().SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::LogOnce, 0x00);
+
     system->RegisterFrontendFunction("Load ROM", [memory](emulator::component::FrontendInterface& frontend) {
         auto selectedFile = frontend.OpenFileDialog();
         if (selectedFile.empty()) {
@@ -102,5 +108,15 @@ emulator::component::System* CreateSystem()
         frontend.Log("Loaded ROM");
     });
 
+    system->RegisterFrontendFunction("Toggle Dynarec", [cpu](emulator::component::FrontendInterface& frontend) {
+        if (!emulator::chip8::Dynarec::Available()) {
+            frontend.Log("Dynarec not supported on this host");
+            return;
+        }
+
+        cpu->SetDynarecEnabled(!cpu->DynarecEnabled());
+        frontend.Log(cpu->DynarecEnabled() ? "Dynarec enabled" : "Dynarec disabled");
+    });
+
     return system;
 }
@@ -1,12 +1,17 @@
 #include <spdlog/spdlog.h>
 
 #include <components/input.h>
+#include <components/log.h>
 #include <components/timer.h>
 
 #include "cpu.h"
 
 #include <utils.h>
 
+#include <algorithm>
+#include <bit>
+#include <limits>
+
 // TODO: Fix failing Not Released case
 
 namespace emulator::chip8
@@ -25,22 +30,122 @@ CPU::CPU(const CPU& other)
     pc_ = other.pc_;
     sp_ = other.sp_;
     stack_ = other.stack_;
+    dynarecEnabled_ = other.dynarecEnabled_;
+    dynarecVerify_ = other.dynarecVerify_;
 }
 
 CPU::~CPU()
 {
 }
 
+void CPU::AttachToBus(emulator::component::Bus* bus)
+{
+    bus_ = bus;
+
+    // Self-modifying code drops compiled blocks
+    bus->AddWriteObserver(this, {0, Dynarec::kAddressSpace - 1}, [this](std::size_t address, std::size_t size) {
+        dynarec_.Invalidate(address, size);
+    });
+}
+
 void CPU::ReceiveTick()
 {
+    idleLoopSkip_ = false;
+    if (dynarecStall_ > 0) {
+        if (--dynarecStall_ > 0) {
+            bus_->RequestIdleSkip();
+        }
+        return;
+    }
+
     if (waitingForKeyChange_) {
+        CheckKeyRelease();
+        return;
+    }
+
+    if (idleLoop_.checked && (pc_ < idleLoop_.head || pc_ > idleLoop_.tail)) {
+        idleLoop_.checked = false;
+    }
+
+    // Compiled blocks run several instructions at once, traces need each one
+    if (dynarecEnabled_ && !Tracing() && ExecuteCompiled()) {
+        return;
+    }
+
+    Step();
+}
+
+void CPU::CheckKeyRelease() noexcept
+{
+    // Key changes only arrive when polled, a press and release within one frame is not seen
+    waitingKeyboard_->Poll();
+    auto pressed = PressedKeys(waitingKeyboard_);
+
+    std::uint16_t released = waitPressedKeys_ & ~pressed;
+    if (released != 0) {
+        registers_[waitRegister_] = static_cast<std::uint8_t>(std::countr_zero(released));
+        waitingForKeyChange_ = false;
         return;
     }
 
+    waitIgnoredKeys_ &= pressed;
+    waitPressedKeys_ = pressed & ~waitIgnoredKeys_;
+}
+
+bool CPU::ExecuteCompiled()
+{
+    auto block = dynarec_.Lookup(pc_, *bus_);
+    if (block == nullptr) {
+        return false;
+    }
+
+    auto& stats = dynarec_.GetStats();
+    if (dynarecVerify_) [[unlikely]] {
+        // Compiled code runs on copies, the interpreter result is kept as the reference
+        auto registers = registers_;
+        auto I = I_;
+        auto pc = pc_;
+        block->function(registers.data(), &I);
+
+        for (std::size_t i = 0; i < block->instructions; i++) {
+            Step();
+        }
+
+        if (registers != registers_ || I != I_ || pc_ != pc + 2 * block->instructions) {
+            ++stats.divergences;
+            spdlog::error("[Dynarec] Block 0x{:04X} diverged from the interpreter, disabling dynarec", pc);
+            dynarecEnabled_ = false;
+        }
+    } else {
+        block->function(registers_.data(), &I_);
+        pc_ += 2 * block->instructions;
+        instructionCount_ += block->instructions;
+    }
+
+    ++stats.blocksExecuted;
+    stats.instructionsExecuted += block->instructions;
+
+    // Keep one instruction per tick, the bus can skip the rest
+    dynarecStall_ = block->instructions - 1;
+    if (dynarecStall_ > 0) {
+        bus_->RequestIdleSkip();
+    }
+    return true;
+}
+
+void CPU::Step()
+{
+    ++instructionCount_;
+
     // Read Big Endian not Little Endian
+    auto instructionPC = pc_;
     std::uint16_t opcode = std::uint16_t(bus_->Read<std::uint8_t>(pc_) << 8) | bus_->Read<std::uint8_t>(pc_ + 1);
     pc_ += sizeof(opcode);
 
+    if (Tracing()) [[unlikely]] {
+        TraceInstruction(instructionPC, opcode);
+    }
+
     std::uint8_t reg = 0;
     std::uint8_t reg2 = 0;
 
@@ -55,6 +160,7 @@ void CPU::ReceiveTick()
                 throw std::runtime_error("Display component not found");
             }
             display->ClearScreen();
+            display->CompleteFrame();
             break;
         }
         case 0xEE:
@@ -79,6 +185,11 @@ void CPU::ReceiveTick()
     case 0x1:
         // Jump to address nnn
         pc_ = opcode & 0x0FFF;
+
+        // Jumped backwards a short distance, may be a busy-wait loop
+        if (pc_ <= instructionPC && instructionPC - pc_ < kMaxIdleLoopLength) [[unlikely]] {
+            CheckIdleLoop(pc_, instructionPC);
+        }
         break;
     case 0x2:
         // Call subroutine at nnn
@@ -193,7 +304,8 @@ void CPU::ReceiveTick()
                 throw std::runtime_error("Keyboard component not found");
             }
 
-            if (key->IsPressed(keymap_[registers_[reg]])) {
+            key->Poll();
+            if (registers_[reg] < 16 && ((PressedKeys(key) >> registers_[reg]) & 1)) {
                 pc_ += 2;
             }
         } break;
@@ -210,7 +322,8 @@ void CPU::ReceiveTick()
                 throw std::runtime_error("Keyboard component not found");
             }
 
-            if (!key->IsPressed(keymap_[registers_[reg]])) {
+            key->Poll();
+            if (registers_[reg] >= 16 || !((PressedKeys(key) >> registers_[reg]) & 1)) {
                 pc_ += 2;
             }
         } break;
@@ -357,34 +470,13 @@ void CPU::DecodeFOpcodes(std::uint16_t opcode)
             throw std::runtime_error("Keyboard component not found");
         }
 
-        std::vector<std::uint8_t> currentlyPressedKeys;
-        for (auto& [k, v] : keymap_) {
-            if (keyboard->IsPressed(v)) {
-                currentlyPressedKeys.push_back(k);
-            }
-        }
-
-        keyboard->SetKeyPressHandlers(
-            nullptr,
-            [this, currentlyPressedKeys, opcode, keyboard](std::uint8_t key) {
-                for (auto& [k, v] : keymap_) {
-                    bool consider = true;
-                    for (auto& c : currentlyPressedKeys) {
-                        if (c == k) {
-                            consider = false;
-                            break;
-                        }
-                    }
-
-                    if (consider && v == key) {
-                        registers_[(opcode & 0x0F00) >> 8] = k;
-                        waitingForKeyChange_ = false;
-                        keyboard->SetKeyPressHandlers(nullptr, nullptr);
-                        break;
-                    }
-                }
-            });
+        // Keys already held do not count until they are released
+        keyboard->Poll();
+        waitIgnoredKeys_ = PressedKeys(keyboard);
+        waitPressedKeys_ = 0;
+        waitRegister_ = (opcode & 0x0F00) >> 8;
         waitingForKeyChange_ = true;
+        waitingKeyboard_ = keyboard;
 
     } break;
     case 0x15: {
@@ -424,15 +516,11 @@ void CPU::DecodeFOpcodes(std::uint16_t opcode)
         break;
     case 0x55:
         // Store registers V0 through Vx in memory starting at location I
-        for (std::size_t i = 0; i <= ((opcode & 0x0F00) >> 8); i++) {
-            bus_->Write(I_ + i, registers_[i]);
-        }
+        bus_->WriteBlock(I_, std::span(registers_).first(((opcode & 0x0F00) >> 8) + 1));
         break;
     case 0x65:
         // Read registers V0 through Vx from memory starting at location I
-        for (std::size_t i = 0; i <= ((opcode & 0x0F00) >> 8); i++) {
-            registers_[i] = bus_->Read<std::uint8_t>(I_ + i);
-        }
+        bus_->ReadBlock(I_, std::span(registers_).first(((opcode & 0x0F00) >> 8) + 1));
         break;
     default:
         spdlog::critical("Unknown Opcode 0x{:04X} @ 0x{:04X}", opcode, pc_ - sizeof(pc_));
@@ -440,17 +528,131 @@ void CPU::DecodeFOpcodes(std::uint16_t opcode)
     }
 }
 
+std::uint64_t CPU::IdleCycles() const noexcept
+{
+    if (dynarecStall_ > 0) {
+        return dynarecStall_;
+    } else if (!idleLoopSkip_) {
+        return 0;
+    }
+
+    // Nothing the loop reads changes before the delay timer does
+    if (idleLoopTimer_ == nullptr) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    auto cycles = idleLoopTimer_->CyclesUntilChange();
+    return cycles != emulator::component::Scheduler::kNever ? cycles : idleLoopTimer_->GetTickSampling();
+}
+
+void CPU::SkipCycles(std::uint64_t cycles) noexcept
+{
+    if (dynarecStall_ > 0) {
+        dynarecStall_ -= std::min<std::uint64_t>(cycles, dynarecStall_);
+        return;
+    }
+    idleStats_.idleLoopCycles += cycles;
+}
+
+void CPU::CheckIdleLoop(std::uint16_t head, std::uint16_t tail)
+{
+    if (!idleLoop_.checked || idleLoop_.head != head || idleLoop_.tail != tail) {
+        idleLoop_.head = head;
+        idleLoop_.tail = tail;
+        idleLoop_.checked = true;
+        idleLoop_.idle = IsIdleLoop(head, tail);
+
+        if (idleLoop_.idle) {
+            ++idleStats_.idleLoopsDetected;
+            EMU_TRACE(CPU, "[CPU] Idle loop 0x{:04X}-0x{:04X}", head, tail);
+        }
+    }
+
+    if (!idleLoop_.idle) {
+        return;
+    }
+
+    if (idleLoopTimer_ == nullptr) {
+        auto timers = bus_->GetBoundSystem()->GetComponentsByType<emulator::component::Timer>(emulator::component::IComponent::ComponentType::Timer);
+        for (auto& t : timers) {
+            if (t->GetName() == "Delay") {
+                idleLoopTimer_ = t;
+                break;
+            }
+        }
+    }
+
+    idleLoopSkip_ = true;
+    bus_->RequestIdleSkip();
+}
+
+// Loop body may only contain instructions whose result is the same every iteration while the
+// delay timer is unchanged, and must end in a jump back to the head
+bool CPU::IsIdleLoop(std::uint16_t head, std::uint16_t tail)
+{
+    for (auto pc = head; pc <= tail; pc += 2) {
+        std::uint16_t opcode = std::uint16_t(bus_->Read<std::uint8_t>(pc) << 8) | bus_->Read<std::uint8_t>(pc + 1);
+
+        switch (opcode >> 12) {
+        case 0x1:
+            // Jump, only the last instruction may jump and it must target the head
+            if (pc == tail) {
+                return (opcode & 0x0FFF) == head;
+            }
+            break;
+        case 0x3: // Skip if Vx == kk
+        case 0x4: // Skip if Vx != kk
+        case 0x6: // Set Vx = kk
+            break;
+        case 0x5: // Skip if Vx == Vy
+        case 0x9: // Skip if Vx != Vy
+            if ((opcode & 0x000F) != 0) {
+                return false;
+            }
+            break;
+        case 0xF:
+            // Set Vx = delay timer value
+            if ((opcode & 0x00FF) != 0x07) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+void CPU::GetRegisterFile(RegisterFile& registers) const
+{
+    static constexpr const char* kNames[] = {"V0", "V1", "V2", "V3", "V4", "V5", "V6", "V7",
+                                             "V8", "V9", "VA", "VB", "VC", "VD", "VE", "VF"};
+
+    registers.clear();
+    for (std::size_t i = 0; i < registers_.size(); i++) {
+        registers.push_back({kNames[i], registers_[i]});
+    }
+    registers.push_back({"I", I_});
+    registers.push_back({"PC", pc_});
+    registers.push_back({"SP", sp_});
+}
+
 void CPU::LogStacktrace() noexcept
 {
-    spdlog::debug("[CPU] V0: {:02X}   V1: {:02X}   V2: {:02X}   V3: {:02X}",
+    EMU_DEBUG(CPU, "[CPU] V0: {:02X}   V1: {:02X}   V2: {:02X}   V3: {:02X}",
                   registers_[0], registers_[1], registers_[2], registers_[3]);
-    spdlog::debug("[CPU] V4: {:02X}   V5: {:02X}   V6: {:02X}   V7: {:02X}",
+    EMU_DEBUG(CPU, "[CPU] V4: {:02X}   V5: {:02X}   V6: {:02X}   V7: {:02X}",
                   registers_[4], registers_[5], registers_[6], registers_[7]);
-    spdlog::debug("[CPU] V8: {:02X}   V9: {:02X}   VA: {:02X}   VB: {:02X}",
+    EMU_DEBUG(CPU, "[CPU] V8: {:02X}   V9: {:02X}   VA: {:02X}   VB: {:02X}",
                   registers_[8], registers_[9], registers_[10], registers_[11]);
-    spdlog::debug("[CPU] VC: {:02X}   VD: {:02X}   VE: {:02X}   VF: {:02X}",
+    EMU_DEBUG(CPU, "[CPU] VC: {:02X}   VD: {:02X}   VE: {:02X}   VF: {:02X}",
                   registers_[12], registers_[13], registers_[14], registers_[15]);
-    spdlog::debug("[CPU] PC: {:04X}   SP: {:02X}", pc_, sp_);
+    EMU_DEBUG(CPU, "[CPU] PC: {:04X}   SP: {:02X}", pc_, sp_);
+    EMU_DEBUG(CPU, "[CPU] Skipped {} idle loop cycles ({} loops)", idleStats_.idleLoopCycles, idleStats_.idleLoopsDetected);
+
+    auto& stats = dynarec_.GetStats();
+    EMU_DEBUG(CPU, "[CPU] Dynarec {}: {} blocks compiled, {} instructions in {} blocks executed, {} invalidations",
+                  dynarecEnabled_ ? "on" : "off", stats.blocksCompiled, stats.instructionsExecuted,
+                  stats.blocksExecuted, stats.invalidations);
 }
 
 void CPU::DisplaySprite(std::uint16_t opcode)
@@ -473,8 +675,11 @@ void CPU::DisplaySprite(std::uint16_t opcode)
     auto y = registers_[reg2];
     registers_[0xF] = 0;
 
+    std::array<std::uint8_t, 0x10> sprite;
+    bus_->ReadBlock(I_, std::span(sprite).first(opcode & 0x000F));
+
     for (std::size_t row = 0; row < (opcode & 0x000F); ++row) {
-        auto sprite_byte = bus_->Read<std::uint8_t>(I_ + row);
+        auto sprite_byte = sprite[row];
 
         for (std::size_t j = 0; j < 8; ++j) {
             auto b = (sprite_byte & 0x80) >> 7;
@@ -492,6 +697,9 @@ void CPU::DisplaySprite(std::uint16_t opcode)
             sprite_byte <<= 1;
         }
     }
+
+    // Chip8 has no vertical refresh, every draw is a new frame
+    display->CompleteFrame();
 }
 
 }; // namespace emulator::chip8
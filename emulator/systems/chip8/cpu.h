@@ -8,6 +8,10 @@
 #include <components/bus.h>
 #include <components/cpu.h>
 #include <components/display.h>
+#include <components/input.h>
+#include <components/timer.h>
+
+#include "dynarec.h"
 
 namespace emulator::chip8
 {
@@ -24,18 +28,51 @@ public:
     emulator::component::Display::Pixel pixelOff_;
 
 private:
-    std::unordered_map<std::uint8_t, std::uint8_t> keymap_;
-
     std::array<std::uint8_t, 16> registers_;
     std::uint16_t I_;
     std::uint16_t pc_;
     std::uint8_t sp_;
     std::array<std::uint16_t, 16> stack_;
 
+    // Chip8 key N is slot N of the Input, FX0A waits for a key outside ignored to be released
     bool waitingForKeyChange_{false};
+    emulator::component::Input* waitingKeyboard_{nullptr};
+    std::uint16_t waitIgnoredKeys_{0};
+    std::uint16_t waitPressedKeys_{0};
+    std::uint8_t waitRegister_{0};
+
+    static std::uint16_t PressedKeys(const emulator::component::Input* keyboard) noexcept
+    {
+        return static_cast<std::uint16_t>(keyboard->GetPressed());
+    }
+
+    void CheckKeyRelease() noexcept;
 
     bool enableSysAddrOpcode_{kDefaultEnableSysAddrOpcode}; // 0x0NNN
 
+    // Self-jumps and delay timer polling loops are skipped until the delay timer changes
+    static constexpr std::uint16_t kMaxIdleLoopLength = 16;
+    struct {
+        std::uint16_t head{0};
+        std::uint16_t tail{0};
+        bool checked{false};
+        bool idle{false};
+    } idleLoop_;
+    emulator::component::Timer* idleLoopTimer_{nullptr};
+    bool idleLoopSkip_{false};
+
+    void CheckIdleLoop(std::uint16_t head, std::uint16_t tail);
+    bool IsIdleLoop(std::uint16_t head, std::uint16_t tail);
+
+    // Compiled blocks run all their instructions in one tick, the remaining ticks are stalled
+    Dynarec dynarec_;
+    bool dynarecEnabled_{false};
+    bool dynarecVerify_{false};
+    std::uint16_t dynarecStall_{0};
+
+    bool ExecuteCompiled();
+
+    void Step();
     void Decode8Opcodes(std::uint16_t opcode);
     void DecodeFOpcodes(std::uint16_t opcode);
     void DisplaySprite(std::uint16_t opcode);
@@ -48,6 +85,57 @@ public:
 
     void ReceiveTick() override;
 
+    std::uint64_t IdleCycles() const noexcept override;
+    void SkipCycles(std::uint64_t cycles) noexcept override;
+
+    std::uint16_t GetProgramCounter() const noexcept
+    {
+        return pc_;
+    }
+
+    std::uint8_t GetRegister(std::size_t reg) const noexcept
+    {
+        return registers_[reg];
+    }
+
+    std::uint16_t GetIndexRegister() const noexcept
+    {
+        return I_;
+    }
+
+    // Returns whether the dynarec is in use, it is never available on hosts other than x86-64
+    bool SetDynarecEnabled(bool enabled) noexcept
+    {
+        dynarecEnabled_ = enabled && Dynarec::Available();
+        return dynarecEnabled_;
+    }
+
+    bool DynarecEnabled() const noexcept
+    {
+        return dynarecEnabled_;
+    }
+
+    // Re-run every compiled block through the interpreter and fall back to it on divergence
+    void SetDynarecVerify(bool verify) noexcept
+    {
+        dynarecVerify_ = verify;
+    }
+
+    const Dynarec::Stats& GetDynarecStats() const noexcept
+    {
+        return dynarec_.GetStats();
+    }
+
+    void AttachToBus(emulator::component::Bus* bus) override;
+
+    void GetRegisterFile(RegisterFile& registers) const override;
+
+    // Instructions complete within a tick, so this is the next one to run
+    ProgramLocation GetProgramLocation() const noexcept override
+    {
+        return {pc_, 0};
+    }
+
     void PowerOn() noexcept override {};
     void PowerOff() noexcept override
     {
@@ -58,30 +146,14 @@ public:
         stack_.fill(0);
         waitingForKeyChange_ = false;
         enableSysAddrOpcode_ = kDefaultEnableSysAddrOpcode;
+        idleLoop_ = {};
+        idleLoopSkip_ = false;
+        dynarec_.Clear();
+        dynarecStall_ = 0;
+        instructionCount_ = 0;
     };
 
     void LogStacktrace() noexcept override;
-
-    // Map Chip8 keycodes to the real keyoard keycodes
-    void LoadKeymap(const std::uint8_t keycodes[])
-    {
-        keymap_[0x1] = keycodes[0];
-        keymap_[0x2] = keycodes[1];
-        keymap_[0x3] = keycodes[2];
-        keymap_[0xC] = keycodes[3];
-        keymap_[0x4] = keycodes[4];
-        keymap_[0x5] = keycodes[5];
-        keymap_[0x6] = keycodes[6];
-        keymap_[0xD] = keycodes[7];
-        keymap_[0x7] = keycodes[8];
-        keymap_[0x8] = keycodes[9];
-        keymap_[0x9] = keycodes[10];
-        keymap_[0xE] = keycodes[11];
-        keymap_[0xA] = keycodes[12];
-        keymap_[0x0] = keycodes[13];
-        keymap_[0xB] = keycodes[14];
-        keymap_[0xF] = keycodes[15];
-    }
 };
 
 }; // namespace emulator::chip8
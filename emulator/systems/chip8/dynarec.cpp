@@ -0,0 +1,268 @@
+#include "dynarec.h"
+#include "cpu.h"
+
+#include <components/log.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) && !defined(_WIN32) && !defined(CHIP8_NO_DYNAREC)
+#define CHIP8_DYNAREC_X86_64 1
+#include <sys/mman.h>
+#endif
+
+namespace emulator::chip8
+{
+
+static constexpr std::size_t kCodeSize = 64 * 1024;
+static constexpr std::size_t kBlockAlignment = 16;
+
+Dynarec::~Dynarec()
+{
+    ReleaseCode();
+}
+
+bool Dynarec::Available() noexcept
+{
+#ifdef CHIP8_DYNAREC_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Dynarec::AllocateCode()
+{
+#ifdef CHIP8_DYNAREC_X86_64
+    auto code = mmap(nullptr, kCodeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        spdlog::warn("[Dynarec] Failed to allocate code buffer, falling back to the interpreter");
+        return false;
+    }
+    code_ = static_cast<std::uint8_t*>(code);
+    codeSize_ = kCodeSize;
+    codeUsed_ = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Dynarec::ReleaseCode() noexcept
+{
+#ifdef CHIP8_DYNAREC_X86_64
+    if (code_ != nullptr) {
+        munmap(code_, codeSize_);
+    }
+#endif
+    code_ = nullptr;
+    codeSize_ = 0;
+    codeUsed_ = 0;
+}
+
+bool Dynarec::IsCompilable(std::uint16_t opcode) noexcept
+{
+    switch (opcode >> 12) {
+    case 0x6: // Set Vx = kk
+    case 0x7: // Set Vx = Vx + kk
+    case 0xA: // Set I = nnn
+        return true;
+    case 0x8:
+        switch (opcode & 0x000F) {
+        case 0x0:
+        case 0x1:
+        case 0x2:
+        case 0x3:
+        case 0x4:
+        case 0x5:
+        case 0x6:
+        case 0x7:
+        case 0xE:
+            return true;
+        }
+        return false;
+    case 0xF:
+        // Set I = I + Vx, set I = location of sprite for digit Vx
+        return (opcode & 0x00FF) == 0x1E || (opcode & 0x00FF) == 0x29;
+    default:
+        return false;
+    }
+}
+
+// Emits the System V x86-64 translation, V0-VF are addressed through rdi and I through rsi.
+// Matches the interpreter exactly, including VF being written before Vx/Vy are re-read.
+void Dynarec::EmitInstruction(std::vector<std::uint8_t>& code, std::uint16_t opcode)
+{
+    std::uint8_t x = (opcode & 0x0F00) >> 8;
+    std::uint8_t y = (opcode & 0x00F0) >> 4;
+    std::uint8_t kk = opcode & 0x00FF;
+    std::uint16_t nnn = opcode & 0x0FFF;
+
+    auto emit = [&code](std::initializer_list<std::uint8_t> bytes) {
+        code.insert(code.end(), bytes);
+    };
+
+    // ModRM for [rdi + disp8] with al (0x47) or cl (0x4F)
+    constexpr std::uint8_t AL = 0x47;
+    constexpr std::uint8_t CL = 0x4F;
+    constexpr std::uint8_t VF = 0xF;
+
+    auto loadAL = [&](std::uint8_t reg) { emit({0x8A, AL, reg}); };
+    auto storeAL = [&](std::uint8_t reg) { emit({0x88, AL, reg}); };
+    auto storeCL = [&](std::uint8_t reg) { emit({0x88, CL, reg}); };
+
+    // VF = a > b, then Vx = a - b with both re-read
+    auto subtract = [&](std::uint8_t a, std::uint8_t b) {
+        loadAL(a);
+        emit({0x3A, AL, b});       // cmp al, [rdi + b]
+        emit({0x0F, 0x97, 0xC1}); // seta cl
+        storeCL(VF);
+        loadAL(a);
+        emit({0x2A, AL, b}); // sub al, [rdi + b]
+        storeAL(x);
+    };
+
+    switch (opcode >> 12) {
+    case 0x6:
+        emit({0xC6, AL, x, kk}); // mov byte [rdi + x], kk
+        break;
+    case 0x7:
+        emit({0x80, AL, x, kk}); // add byte [rdi + x], kk
+        break;
+    case 0xA:
+        emit({0x66, 0xC7, 0x06, static_cast<std::uint8_t>(nnn & 0xFF), static_cast<std::uint8_t>(nnn >> 8)}); // mov word [rsi], nnn
+        break;
+    case 0x8:
+        switch (opcode & 0x000F) {
+        case 0x0:
+            loadAL(y);
+            storeAL(x);
+            break;
+        case 0x1:
+            loadAL(y);
+            emit({0x08, AL, x}); // or [rdi + x], al
+            break;
+        case 0x2:
+            loadAL(y);
+            emit({0x20, AL, x}); // and [rdi + x], al
+            break;
+        case 0x3:
+            loadAL(y);
+            emit({0x30, AL, x}); // xor [rdi + x], al
+            break;
+        case 0x4:
+            loadAL(x);
+            emit({0x02, AL, y});       // add al, [rdi + y]
+            emit({0x0F, 0x92, 0xC1}); // setc cl
+            storeCL(VF);
+            storeAL(x);
+            break;
+        case 0x5:
+            subtract(x, y);
+            break;
+        case 0x6:
+            loadAL(x);
+            emit({0x24, 0x01}); // and al, 1
+            storeAL(VF);
+            emit({0xD0, 0x6F, x}); // shr byte [rdi + x], 1
+            break;
+        case 0x7:
+            subtract(y, x);
+            break;
+        case 0xE:
+            loadAL(x);
+            emit({0x24, 0x80}); // and al, 0x80
+            storeAL(VF);
+            emit({0xD0, 0x67, x}); // shl byte [rdi + x], 1
+            break;
+        }
+        break;
+    case 0xF:
+        emit({0x0F, 0xB6, AL, x}); // movzx eax, byte [rdi + x]
+        if ((opcode & 0x00FF) == 0x1E) {
+            emit({0x66, 0x01, 0x06}); // add [rsi], ax
+        } else {
+            static_assert(CPU::kSpriteLength < 0x80 && CPU::kFontSetBaseAddress < 0x80);
+            emit({0x6B, 0xC0, CPU::kSpriteLength});       // imul eax, eax, kSpriteLength
+            emit({0x83, 0xC0, CPU::kFontSetBaseAddress}); // add eax, kFontSetBaseAddress
+            emit({0x66, 0x89, 0x06});                     // mov [rsi], ax
+        }
+        break;
+    }
+}
+
+const Dynarec::Block* Dynarec::Lookup(std::uint16_t pc, emulator::component::Bus& bus)
+{
+    auto& block = blocks_[pc % kAddressSpace];
+    if (block.function != nullptr) [[likely]] {
+        return &block;
+    } else if (block.interpret || !Available()) {
+        return nullptr;
+    }
+
+    std::vector<std::uint8_t> code;
+    std::uint16_t instructions = 0;
+    for (std::size_t address = pc; instructions < kMaxBlockLength && address + 1 < kAddressSpace; address += 2) {
+        std::uint16_t opcode = std::uint16_t(bus.Read<std::uint8_t>(address) << 8) | bus.Read<std::uint8_t>(address + 1);
+        if (!IsCompilable(opcode)) {
+            break;
+        }
+        EmitInstruction(code, opcode);
+        ++instructions;
+    }
+
+    // Remember the decision until the code is written to
+    for (std::size_t address = pc; address < pc + 2 * std::max<std::size_t>(instructions, 1); ++address) {
+        codeBytes_.set(address % kAddressSpace);
+    }
+
+    if (instructions == 0 || (code_ == nullptr && !AllocateCode())) {
+        block.interpret = true;
+        return nullptr;
+    }
+    code.push_back(0xC3); // ret
+
+    if (codeUsed_ + code.size() > codeSize_) {
+        EMU_DEBUG(CPU, "[Dynarec] Code buffer full, dropping all blocks");
+        Clear();
+        for (std::size_t address = pc; address < pc + 2 * instructions; ++address) {
+            codeBytes_.set(address % kAddressSpace);
+        }
+    }
+
+#ifdef CHIP8_DYNAREC_X86_64
+    // Never writable and executable at once
+    mprotect(code_, codeSize_, PROT_READ | PROT_WRITE);
+    std::memcpy(code_ + codeUsed_, code.data(), code.size());
+    mprotect(code_, codeSize_, PROT_READ | PROT_EXEC);
+#endif
+
+    block.function = reinterpret_cast<BlockFunction>(code_ + codeUsed_);
+    block.instructions = instructions;
+    codeUsed_ = (codeUsed_ + code.size() + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+
+    ++stats_.blocksCompiled;
+    EMU_TRACE(CPU, "[Dynarec] Compiled {} instructions @ 0x{:04X}", instructions, pc);
+    return &block;
+}
+
+void Dynarec::Invalidate(std::size_t address, std::size_t size) noexcept
+{
+    for (std::size_t i = address; i < address + size && i < kAddressSpace; ++i) {
+        if (codeBytes_.test(i)) {
+            Clear();
+            ++stats_.invalidations;
+            return;
+        }
+    }
+}
+
+void Dynarec::Clear() noexcept
+{
+    blocks_.fill({});
+    codeBytes_.reset();
+    codeUsed_ = 0;
+}
+
+}; // namespace emulator::chip8
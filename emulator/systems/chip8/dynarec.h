@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <components/bus.h>
+
+namespace emulator::chip8
+{
+
+/**
+ * Translates runs of register-only Chip8 instructions into host machine code.
+ *
+ * Only instructions that touch nothing but V0-VF and I are compiled: loads,
+ * ALU operations and I arithmetic. Blocks end at the first instruction that
+ * reads memory, branches or talks to another component, and the interpreter
+ * executes that one. Only x86-64 System V hosts are supported, elsewhere
+ * Available() is false and nothing is compiled.
+ */
+class Dynarec
+{
+public:
+    // Called with V0-VF and I
+    using BlockFunction = void (*)(std::uint8_t* registers, std::uint16_t* I);
+
+    static constexpr std::size_t kMaxBlockLength = 32;
+    static constexpr std::size_t kAddressSpace = 0x1000;
+
+    struct Block {
+        BlockFunction function{nullptr};
+        std::uint16_t instructions{0};
+
+        // Instruction at the start address can not be compiled, use the interpreter
+        bool interpret{false};
+    };
+
+    struct Stats {
+        std::uint64_t blocksCompiled{0};
+        std::uint64_t blocksExecuted{0};
+        std::uint64_t instructionsExecuted{0};
+        std::uint64_t invalidations{0};
+        std::uint64_t divergences{0};
+    };
+
+private:
+    std::array<Block, kAddressSpace> blocks_{};
+    std::bitset<kAddressSpace> codeBytes_;
+
+    std::uint8_t* code_{nullptr};
+    std::size_t codeSize_{0};
+    std::size_t codeUsed_{0};
+
+    Stats stats_;
+
+    static bool IsCompilable(std::uint16_t opcode) noexcept;
+    static void EmitInstruction(std::vector<std::uint8_t>& code, std::uint16_t opcode);
+
+    bool AllocateCode();
+    void ReleaseCode() noexcept;
+
+public:
+    Dynarec() = default;
+    ~Dynarec();
+
+    // Compiled code is tied to the code buffer, copies start empty
+    Dynarec(const Dynarec&) : Dynarec() {}
+    Dynarec& operator=(const Dynarec&)
+    {
+        Clear();
+        return *this;
+    }
+
+    static bool Available() noexcept;
+
+    const Stats& GetStats() const noexcept
+    {
+        return stats_;
+    }
+
+    Stats& GetStats() noexcept
+    {
+        return stats_;
+    }
+
+    // Compiled block starting at pc, compiling it first if needed. nullptr when pc must be interpreted.
+    const Block* Lookup(std::uint16_t pc, emulator::component::Bus& bus);
+
+    // Drop every block if a compiled instruction was written to
+    void Invalidate(std::size_t address, std::size_t size) noexcept;
+
+    void Clear() noexcept;
+};
+
+}; // namespace emulator::chip8
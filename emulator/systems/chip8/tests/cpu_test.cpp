@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+
+// Test delay timer polling is skipped and still exits once the timer expires
+TEST(Chip8CPU, DelayTimerIdleLoop)
+{
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"));
+    auto& bus = system->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    bus.PowerOn();
+
+    const std::uint8_t program[] = {
+        0x60, 0x05, // LD V0, 5
+        0xF0, 0x15, // LD DT, V0
+        0xF1, 0x07, // LD V1, DT
+        0x31, 0x00, // SE V1, 0
+        0x12, 0x04, // JP 0x204
+        0x12, 0x0A, // JP 0x20A
+    };
+    for (std::size_t i = 0; i < sizeof(program); i++) {
+        bus.Write<std::uint8_t>(0x200 + i, program[i]);
+    }
+
+    std::size_t ticks = 0;
+    while (cpu->GetProgramCounter() != 0x20A && scheduler.Now() < 1000) {
+        bus.ReceiveTick();
+        ++ticks;
+    }
+
+    // DT loaded on the 2nd tick, expires 5 * 8 ticks later
+    ASSERT_EQ(cpu->GetProgramCounter(), 0x20A);
+    ASSERT_GE(scheduler.Now(), 42);
+    ASSERT_LT(scheduler.Now(), 42 + 8);
+
+    ASSERT_EQ(cpu->GetIdleStats().idleLoopsDetected, 1);
+    ASSERT_GT(cpu->GetIdleStats().idleLoopCycles, 0);
+    ASSERT_LT(ticks, scheduler.Now());
+
+    delete system;
+}
+
+// Test a self jump keeps skipping while the timers run
+TEST(Chip8CPU, SelfJumpIdleLoop)
+{
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"));
+    auto& bus = system->GetBus();
+
+    bus.PowerOn();
+
+    // JP 0x200
+    bus.Write<std::uint8_t>(0x200, 0x12);
+    bus.Write<std::uint8_t>(0x201, 0x00);
+
+    for (int i = 0; i < 100; i++) {
+        bus.ReceiveTick();
+    }
+
+    ASSERT_EQ(cpu->GetProgramCounter(), 0x200);
+    ASSERT_GT(bus.GetScheduler().Now(), 100);
+    ASSERT_GT(cpu->GetIdleStats().idleLoopCycles, 0);
+
+    delete system;
+}
+
+static void LoadProgram(emulator::component::Bus& bus, const std::vector<std::uint8_t>& program)
+{
+    for (std::size_t i = 0; i < program.size(); i++) {
+        bus.Write<std::uint8_t>(0x200 + i, program[i]);
+    }
+}
+
+// Test compiled blocks leave the same state at the same tick as the interpreter
+TEST(Chip8CPU, DynarecMatchesInterpreter)
+{
+    if (!emulator::chip8::Dynarec::Available()) {
+        GTEST_SKIP() << "Dynarec not supported on this host";
+    }
+
+    const std::vector<std::uint8_t> program = {
+        0x60, 0xFF, // LD V0, 0xFF
+        0x61, 0x01, // LD V1, 1
+        0x80, 0x14, // ADD V0, V1
+        0x62, 0x03, // LD V2, 3
+        0x82, 0x05, // SUB V2, V0
+        0x8F, 0x25, // SUB VF, V2
+        0x82, 0x06, // SHR V2
+        0x82, 0x0E, // SHL V2
+        0x85, 0x27, // SUBN V5, V2
+        0x86, 0x10, // LD V6, V1
+        0x86, 0x21, // OR V6, V2
+        0x86, 0x52, // AND V6, V5
+        0x86, 0x03, // XOR V6, V0
+        0x77, 0xFE, // ADD V7, 0xFE
+        0xA1, 0x23, // LD I, 0x123
+        0xF7, 0x1E, // ADD I, V7
+        0x8F, 0xF4, // ADD VF, VF
+        0xF2, 0x29, // LD F, V2
+        0x12, 0x24, // JP 0x224
+    };
+    const std::uint16_t end = 0x200 + program.size() - 2;
+
+    emulator::component::System* systems[] = {CreateSystem(), CreateSystem()};
+    emulator::chip8::CPU* cpus[2];
+    for (int i = 0; i < 2; i++) {
+        cpus[i] = reinterpret_cast<emulator::chip8::CPU*>(systems[i]->GetComponent("CPU"));
+        systems[i]->GetBus().PowerOn();
+        LoadProgram(systems[i]->GetBus(), program);
+    }
+    ASSERT_TRUE(cpus[0]->SetDynarecEnabled(true));
+
+    for (int i = 0; i < 2; i++) {
+        auto& bus = systems[i]->GetBus();
+        while (cpus[i]->GetProgramCounter() != end && bus.GetScheduler().Now() < 1000) {
+            bus.ReceiveTick();
+        }
+    }
+
+    ASSERT_EQ(cpus[0]->GetProgramCounter(), end);
+    ASSERT_EQ(systems[0]->GetBus().GetScheduler().Now(), systems[1]->GetBus().GetScheduler().Now());
+    for (std::size_t reg = 0; reg < 16; reg++) {
+        ASSERT_EQ(cpus[0]->GetRegister(reg), cpus[1]->GetRegister(reg)) << "V" << reg;
+    }
+    ASSERT_EQ(cpus[0]->GetIndexRegister(), cpus[1]->GetIndexRegister());
+
+    ASSERT_EQ(cpus[0]->GetDynarecStats().blocksCompiled, 1);
+    ASSERT_EQ(cpus[0]->GetDynarecStats().instructionsExecuted, program.size() / 2 - 1);
+
+    delete systems[0];
+    delete systems[1];
+}
+
+// Test writing over compiled code drops the block and runs the new instruction
+TEST(Chip8CPU, DynarecSelfModifyingCode)
+{
+    if (!emulator::chip8::Dynarec::Available()) {
+        GTEST_SKIP() << "Dynarec not supported on this host";
+    }
+
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"));
+    auto& bus = system->GetBus();
+
+    bus.PowerOn();
+    LoadProgram(bus, {
+                         0x63, 0x05, // LD V3, 5
+                         0x72, 0x01, // ADD V2, 1
+                         0x60, 0x63, // LD V0, 0x63
+                         0x61, 0x09, // LD V1, 9
+                         0xA2, 0x00, // LD I, 0x200
+                         0xF1, 0x55, // LD [I], V1
+                         0x32, 0x02, // SE V2, 2
+                         0x12, 0x00, // JP 0x200
+                         0x12, 0x10, // JP 0x210
+                     });
+    cpu->SetDynarecEnabled(true);
+    cpu->SetDynarecVerify(true);
+
+    while (cpu->GetProgramCounter() != 0x210 && bus.GetScheduler().Now() < 1000) {
+        bus.ReceiveTick();
+    }
+
+    // Second pass ran LD V3, 9
+    ASSERT_EQ(cpu->GetProgramCounter(), 0x210);
+    ASSERT_EQ(cpu->GetRegister(2), 2);
+    ASSERT_EQ(cpu->GetRegister(3), 9);
+
+    auto& stats = cpu->GetDynarecStats();
+    ASSERT_GE(stats.invalidations, 1);
+    ASSERT_EQ(stats.divergences, 0);
+    ASSERT_TRUE(cpu->DynarecEnabled());
+
+    delete system;
+}
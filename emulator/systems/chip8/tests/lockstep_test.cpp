@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <components/lockstep.h>
+#include <emulator.h>
+
+#include "cpu.h"
+
+using emulator::component::Lockstep;
+
+// Test the dynarec agrees with the interpreter over a loop storing to memory
+TEST(Chip8Lockstep, DynarecMatchesInterpreter)
+{
+    if (!emulator::chip8::Dynarec::Available()) {
+        GTEST_SKIP() << "Dynarec not supported on this host";
+    }
+
+    const std::uint8_t program[] = {
+        0x60, 0x00, // LD V0, 0
+        0x70, 0x01, // ADD V0, 1
+        0x81, 0x04, // ADD V1, V0
+        0x82, 0x15, // SUB V2, V1
+        0xA3, 0x00, // LD I, 0x300
+        0xF2, 0x55, // LD [I], V2
+        0x30, 0x40, // SE V0, 0x40
+        0x12, 0x02, // JP 0x202
+        0x12, 0x00, // JP 0x200
+    };
+
+    emulator::component::System* systems[] = {CreateSystem(), CreateSystem()};
+    for (auto system : systems) {
+        auto& bus = system->GetBus();
+        bus.PowerOn();
+        for (std::size_t i = 0; i < sizeof(program); i++) {
+            bus.Write<std::uint8_t>(0x200 + i, program[i]);
+        }
+    }
+
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(systems[1]->GetComponent("CPU"));
+    ASSERT_TRUE(cpu->SetDynarecEnabled(true));
+
+    // Compiled blocks finish their instructions ahead of the interpreter
+    Lockstep lockstep(*systems[0], *systems[1], {.memoryRanges = {{0x200, 0x3FF}}, .compareCycles = false});
+
+    auto divergence = lockstep.Run(2000);
+    ASSERT_FALSE(divergence.has_value()) << divergence->Describe();
+    ASSERT_GE(lockstep.InstructionsCompared(), 2000);
+    ASSERT_GT(cpu->GetDynarecStats().blocksExecuted, 0);
+
+    delete systems[0];
+    delete systems[1];
+}
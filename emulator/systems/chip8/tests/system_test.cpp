@@ -2,6 +2,8 @@
 
 #include <emulator.h>
 
+#include "cpu.h"
+
 TEST(Chip8System, CreateSystem)
 {
     auto system = CreateSystem();
@@ -14,3 +16,82 @@ TEST(Chip8System, GetSystemName)
     auto system = CreateSystem();
     ASSERT_STRCASEEQ(system->Name().c_str(), "Chip8");
 }
+
+// Test a movie recorded with host input at arbitrary times replays to the same state
+TEST(Chip8System, MovieReplay)
+{
+    // Count loops while key 0 is held: SKP V0; JP 0x200; ADD V1, 1; JP 0x200
+    const std::uint8_t program[] = {0xE0, 0x9E, 0x12, 0x00, 0x71, 0x01, 0x12, 0x00};
+
+    auto run = [&](emulator::component::System* system, auto&& during) {
+        auto input = system->GetFirstComponentByType<emulator::component::Input>(emulator::component::IComponent::ComponentType::Input);
+        auto& bus = system->GetBus();
+        bus.PowerOn();
+        for (std::size_t i = 0; i < sizeof(program); i++) {
+            bus.Write<std::uint8_t>(0x200 + i, program[i]);
+        }
+
+        for (int tick = 0; tick < 600; tick++) {
+            during(input, tick);
+            bus.ReceiveTick();
+        }
+        return reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"))->GetRegister(1);
+    };
+
+    auto recorder = CreateSystem();
+    auto input = recorder->GetFirstComponentByType<emulator::component::Input>(emulator::component::IComponent::ComponentType::Input);
+    input->RecordMovie();
+    auto recorded = run(recorder, [](auto input, int tick) {
+        // Key 0 is mapped to 'x', pressed and released off any frame boundary
+        if (tick == 101) {
+            input->PressKey('x');
+        } else if (tick == 333) {
+            input->ReleaseKey('x');
+        }
+    });
+    auto movie = input->StopMovie();
+    ASSERT_GT(recorded, 0);
+    ASSERT_EQ(movie->GetChanges().size(), 2);
+
+    auto player = CreateSystem();
+    player->GetFirstComponentByType<emulator::component::Input>(emulator::component::IComponent::ComponentType::Input)->PlayMovie(*movie);
+    auto replayed = run(player, [](auto, int) {});
+    ASSERT_EQ(replayed, recorded);
+
+    delete recorder;
+    delete player;
+}
+
+// Test FX0A stores the first key released that was not already held when it started
+TEST(Chip8System, WaitForKeyRelease)
+{
+    // LD V3, K; JP 0x202
+    const std::uint8_t program[] = {0xF3, 0x0A, 0x12, 0x02};
+
+    auto system = CreateSystem();
+    auto input = system->GetFirstComponentByType<emulator::component::Input>(emulator::component::IComponent::ComponentType::Input);
+    auto cpu = reinterpret_cast<emulator::chip8::CPU*>(system->GetComponent("CPU"));
+    auto& bus = system->GetBus();
+    bus.PowerOn();
+    for (std::size_t i = 0; i < sizeof(program); i++) {
+        bus.Write<std::uint8_t>(0x200 + i, program[i]);
+    }
+
+    // Keys 5 and 6
+    input->PressKey('w');
+    for (int tick = 0; tick < 400; tick++) {
+        if (tick == 100) {
+            input->PressKey('e');
+        } else if (tick == 200) {
+            input->ReleaseKey('w');
+        } else if (tick == 250) {
+            ASSERT_EQ(cpu->GetRegister(3), 0);
+        } else if (tick == 300) {
+            input->ReleaseKey('e');
+        }
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(cpu->GetRegister(3), 6);
+
+    delete system;
+}
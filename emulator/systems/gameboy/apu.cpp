@@ -0,0 +1,416 @@
+#include "apu.h"
+
+#include <components/exceptions/AddressInUse.h>
+
+namespace emulator::gameboy
+{
+
+namespace
+{
+
+// Bits that always read back as 1, 0xFF10-0xFF2F
+constexpr std::array<std::uint8_t, 0x20> kReadMask = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF, // NR10-NR14
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF, // NR20-NR24
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF, // NR30-NR34
+    0xFF, 0xFF, 0x00, 0x00, 0xBF, // NR40-NR44
+    0x00, 0x00, 0x70,             // NR50-NR52
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Output of each of the 8 duty steps, most significant bit first
+constexpr std::array<std::uint8_t, 4> kDuty = {0b00000001, 0b10000001, 0b10000111, 0b01111110};
+
+constexpr std::array<emulator::component::Scheduler::Cycle, 8> kNoiseDivisor = {8, 16, 32, 48, 64, 80, 96, 112};
+
+constexpr std::array<std::uint16_t, 4> kMaxLength = {64, 64, 256, 64};
+
+constexpr std::size_t kSquare1 = 0, kSquare2 = 1, kWave = 2, kNoise = 3;
+
+} // namespace
+
+APU::APU(std::uint32_t sampleRate) : emulator::component::Audio(kClockRate, kFrameSequencerPeriod, sampleRate)
+{
+}
+
+APU::~APU()
+{
+    CancelSequencer();
+}
+
+APU::Scheduler::Cycle APU::Now() const noexcept
+{
+    if (bus_ == nullptr) {
+        return syncCycle_;
+    }
+    return bus_->GetScheduler().Now();
+}
+
+APU::Scheduler::Cycle APU::Period(std::size_t channel) const noexcept
+{
+    const auto& ch = channels_[channel];
+    switch (channel) {
+    case kSquare1:
+    case kSquare2:
+        return (2048 - ch.frequency) * 4;
+    case kWave:
+        return (2048 - ch.frequency) * 2;
+    default: {
+        auto nr43 = Register(0xFF22);
+        return kNoiseDivisor[nr43 & 0x7] << (nr43 >> 4);
+    }
+    }
+}
+
+std::uint8_t APU::Digital(std::size_t channel) const noexcept
+{
+    const auto& ch = channels_[channel];
+    if (!ch.enabled || !ch.dac) {
+        return 0;
+    }
+
+    switch (channel) {
+    case kSquare1:
+    case kSquare2: {
+        auto duty = Register(ChannelBase(channel) + 1) >> 6;
+        return ((kDuty[duty] >> (7 - ch.phase)) & 1) ? ch.volume : 0;
+    }
+    case kWave: {
+        // Volume code 0 mutes, 1-3 shift right by 0-2
+        auto code = (Register(0xFF1C) >> 5) & 0x3;
+        if (code == 0) {
+            return 0;
+        }
+        auto sample = Register(kWaveRAMStart + ch.phase / 2);
+        sample = (ch.phase & 1) ? (sample & 0xF) : (sample >> 4);
+        return sample >> (code - 1);
+    }
+    default:
+        return (ch.phase & 1) ? 0 : ch.volume;
+    }
+}
+
+int APU::Gain(std::size_t channel) const noexcept
+{
+    auto panning = Register(0xFF25);
+    if ((panning & (0x11 << channel)) == 0) {
+        return 0;
+    }
+
+    // Average of the left and right master volumes, 1-8 each
+    auto volume = Register(0xFF24);
+    return (((volume >> 4) & 0x7) + (volume & 0x7) + 2) * kVolumeScale / 16;
+}
+
+void APU::Step(std::size_t channel) noexcept
+{
+    auto& ch = channels_[channel];
+    switch (channel) {
+    case kSquare1:
+    case kSquare2:
+        ch.phase = (ch.phase + 1) & 0x7;
+        break;
+    case kWave:
+        ch.phase = (ch.phase + 1) & 0x1F;
+        break;
+    default: {
+        auto bit = (ch.phase ^ (ch.phase >> 1)) & 1;
+        ch.phase = (ch.phase >> 1) | (bit << 14);
+        if (Register(0xFF22) & 0x08) {
+            // 7-bit mode also feeds bit 6
+            ch.phase = (ch.phase & ~0x40) | (bit << 6);
+        }
+    } break;
+    }
+}
+
+void APU::Emit(std::size_t channel, Scheduler::Cycle cycle) noexcept
+{
+    auto& ch = channels_[channel];
+    auto level = power_ ? Digital(channel) * Gain(channel) : 0;
+    if (level != ch.level) {
+        blip_.AddDelta(cycle - frameStart_, level - ch.level);
+        ch.level = level;
+    }
+}
+
+void APU::Sync() noexcept
+{
+    auto now = Now();
+    for (std::size_t channel = 0; channel < channels_.size(); channel++) {
+        auto& ch = channels_[channel];
+        if (!ch.enabled) {
+            continue;
+        }
+
+        // Only the steps themselves are visited, deltas where the output changes
+        auto cycle = syncCycle_;
+        while (ch.timer <= now - cycle) {
+            cycle += ch.timer;
+            ch.timer = Period(channel);
+            Step(channel);
+            Emit(channel, cycle);
+        }
+        ch.timer -= now - cycle;
+    }
+    syncCycle_ = now;
+}
+
+void APU::Trigger(std::size_t channel) noexcept
+{
+    auto& ch = channels_[channel];
+    auto base = ChannelBase(channel);
+
+    ch.enabled = ch.dac;
+    if (ch.length == 0) {
+        ch.length = kMaxLength[channel];
+    }
+    ch.timer = Period(channel);
+
+    auto envelope = Register(base + 2);
+    ch.volume = envelope >> 4;
+    ch.envelopeTimer = envelope & 0x7;
+
+    if (channel == kWave) {
+        ch.phase = 0;
+    } else if (channel == kNoise) {
+        ch.phase = 0x7FFF;
+    } else if (channel == kSquare1) {
+        auto sweep = Register(0xFF10);
+        auto period = (sweep >> 4) & 0x7;
+        ch.sweepShadow = ch.frequency;
+        ch.sweepTimer = period ? period : 8;
+        ch.sweepEnabled = period != 0 || (sweep & 0x7) != 0;
+        if (sweep & 0x7) {
+            SweepTarget();
+        }
+    }
+}
+
+std::uint16_t APU::SweepTarget() noexcept
+{
+    auto& ch = channels_[kSquare1];
+    auto sweep = Register(0xFF10);
+    auto delta = ch.sweepShadow >> (sweep & 0x7);
+    auto target = (sweep & 0x08) ? ch.sweepShadow - delta : ch.sweepShadow + delta;
+    if (target > 2047) {
+        ch.enabled = false;
+    }
+    return static_cast<std::uint16_t>(target);
+}
+
+void APU::ClockLength() noexcept
+{
+    for (auto& ch : channels_) {
+        if (ch.lengthEnabled && ch.length > 0 && --ch.length == 0) {
+            ch.enabled = false;
+        }
+    }
+}
+
+void APU::ClockSweep() noexcept
+{
+    auto& ch = channels_[kSquare1];
+    if (--ch.sweepTimer != 0) {
+        return;
+    }
+
+    auto sweep = Register(0xFF10);
+    auto period = (sweep >> 4) & 0x7;
+    ch.sweepTimer = period ? period : 8;
+    if (!ch.sweepEnabled || period == 0) {
+        return;
+    }
+
+    auto target = SweepTarget();
+    if (target <= 2047 && (sweep & 0x7) != 0) {
+        ch.frequency = target;
+        ch.sweepShadow = target;
+        Register(0xFF13) = target & 0xFF;
+        Register(0xFF14) = (Register(0xFF14) & ~0x7) | (target >> 8);
+        SweepTarget();
+    }
+}
+
+void APU::ClockEnvelope() noexcept
+{
+    for (std::size_t channel : {kSquare1, kSquare2, kNoise}) {
+        auto& ch = channels_[channel];
+        auto envelope = Register(ChannelBase(channel) + 2);
+        auto period = envelope & 0x7;
+        if (period == 0 || (ch.envelopeTimer > 0 && --ch.envelopeTimer != 0)) {
+            continue;
+        }
+
+        ch.envelopeTimer = period;
+        if ((envelope & 0x08) && ch.volume < 15) {
+            ch.volume++;
+        } else if (!(envelope & 0x08) && ch.volume > 0) {
+            ch.volume--;
+        }
+    }
+}
+
+void APU::ScheduleSequencer()
+{
+    sequencerEvent_ = bus_->GetScheduler().ScheduleAt(frameStart_ + kFrameSequencerPeriod, [this]() {
+        sequencerEvent_ = Scheduler::kInvalidEvent;
+        RunSequencer();
+    });
+}
+
+void APU::CancelSequencer() noexcept
+{
+    if (sequencerEvent_ != Scheduler::kInvalidEvent && bus_ != nullptr) {
+        bus_->GetScheduler().Cancel(sequencerEvent_);
+    }
+    sequencerEvent_ = Scheduler::kInvalidEvent;
+}
+
+void APU::RunSequencer()
+{
+    Sync();
+
+    if (power_) {
+        // Length on even steps, sweep on 2 and 6, envelope on 7
+        if ((sequencerStep_ & 1) == 0) {
+            ClockLength();
+        }
+        if (sequencerStep_ == 2 || sequencerStep_ == 6) {
+            ClockSweep();
+        }
+        if (sequencerStep_ == 7) {
+            ClockEnvelope();
+        }
+        sequencerStep_ = (sequencerStep_ + 1) & 0x7;
+    }
+
+    for (std::size_t channel = 0; channel < channels_.size(); channel++) {
+        Emit(channel, syncCycle_);
+    }
+
+    // Sound keeps flowing, silent or not, so consumers see a steady rate
+    EndFrame(syncCycle_ - frameStart_);
+    frameStart_ = syncCycle_;
+    ScheduleSequencer();
+}
+
+void APU::AttachToBus(emulator::component::Bus* bus)
+{
+    if (!bus->RegisterComponentAddressRange(this, {0xFF10, 0xFF3F})) {
+        throw component::AddressInUse(0xFF10, 0x30);
+    }
+    bus_ = bus;
+}
+
+void APU::RemoveFromBus()
+{
+    CancelSequencer();
+    bus_ = nullptr;
+}
+
+void APU::PowerOn() noexcept
+{
+    // Scheduler was reset along with the bus, any previous event is gone
+    sequencerEvent_ = Scheduler::kInvalidEvent;
+
+    channels_ = {};
+    registers_ = {};
+    power_ = false;
+    sequencerStep_ = 0;
+    syncCycle_ = Now();
+    frameStart_ = syncCycle_;
+    blip_.Clear();
+
+    if (bus_ != nullptr) {
+        ScheduleSequencer();
+    }
+}
+
+void APU::PowerOff() noexcept
+{
+    CancelSequencer();
+}
+
+void APU::WriteUInt8(std::size_t address, std::uint8_t value)
+{
+    Sync();
+
+    if (address >= kWaveRAMStart) {
+        Register(address) = value;
+    } else if (address == 0xFF26) {
+        auto power = (value & 0x80) != 0;
+        if (power_ && !power) {
+            // Powering off clears every register but wave RAM
+            std::fill(registers_.begin(), registers_.begin() + (0xFF26 - kRegisterStart), 0);
+            for (auto& ch : channels_) {
+                ch.enabled = false;
+                ch.dac = false;
+                ch.length = 0;
+                ch.lengthEnabled = false;
+                ch.frequency = 0;
+            }
+        } else if (!power_ && power) {
+            sequencerStep_ = 0;
+        }
+        power_ = power;
+    } else if (power_) {
+        Register(address) = value;
+
+        auto offset = address - kRegisterStart;
+        auto channel = offset / 5;
+        if (channel < channels_.size()) {
+            auto& ch = channels_[channel];
+            switch (offset % 5) {
+            case 0:
+                if (channel == kWave) {
+                    ch.dac = (value & 0x80) != 0;
+                    ch.enabled = ch.enabled && ch.dac;
+                }
+                break;
+            case 1:
+                ch.length = channel == kWave ? 256 - value : 64 - (value & 0x3F);
+                break;
+            case 2:
+                if (channel != kWave) {
+                    ch.dac = (value & 0xF8) != 0;
+                    ch.enabled = ch.enabled && ch.dac;
+                }
+                break;
+            case 3:
+                ch.frequency = (ch.frequency & 0x700) | value;
+                break;
+            case 4:
+                ch.frequency = (ch.frequency & 0xFF) | ((value & 0x7) << 8);
+                ch.lengthEnabled = (value & 0x40) != 0;
+                if (value & 0x80) {
+                    Trigger(channel);
+                }
+                break;
+            }
+        }
+    }
+
+    for (std::size_t channel = 0; channel < channels_.size(); channel++) {
+        Emit(channel, syncCycle_);
+    }
+}
+
+std::uint8_t APU::ReadUInt8(std::size_t address)
+{
+    if (address >= kWaveRAMStart) {
+        return Register(address);
+    }
+
+    if (address == 0xFF26) {
+        // Length and sweep only end channels on sequencer steps, status needs no sync
+        std::uint8_t status = power_ ? 0x80 : 0;
+        for (std::size_t channel = 0; channel < channels_.size(); channel++) {
+            status |= channels_[channel].enabled ? 1 << channel : 0;
+        }
+        return status | kReadMask[address - kRegisterStart];
+    }
+    return Register(address) | kReadMask[address - kRegisterStart];
+}
+
+}; // namespace emulator::gameboy
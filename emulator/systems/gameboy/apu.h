@@ -0,0 +1,186 @@
+#pragma once
+
+#include <components/audio.h>
+#include <components/bus.h>
+#include <components/scheduler.h>
+
+#include <array>
+
+namespace emulator::gameboy
+{
+
+/*
+Sound registers:
+    Address	Name	Explanation
+    0xFF10	NR10	Channel 1 sweep, -PPPNSSS
+    0xFF11	NR11	Channel 1 duty and length, DDLLLLLL
+    0xFF12	NR12	Channel 1 envelope, VVVVAPPP, DAC is off while VVVVA is 0
+    0xFF13	NR13	Channel 1 frequency low
+    0xFF14	NR14	Channel 1 trigger, length enable and frequency high, TL---FFF
+    0xFF16	NR21-NR24	Channel 2, as channel 1 without the sweep
+    0xFF1A	NR30	Channel 3 DAC, bit 7
+    0xFF1B	NR31	Channel 3 length
+    0xFF1C	NR32	Channel 3 volume, -VV-----
+    0xFF1D	NR33-NR34	Channel 3 frequency, as channel 1
+    0xFF20	NR41	Channel 4 length
+    0xFF21	NR42	Channel 4 envelope
+    0xFF22	NR43	Channel 4 clock shift, width and divisor, SSSSWDDD
+    0xFF23	NR44	Channel 4 trigger and length enable
+    0xFF24	NR50	Master volume, -LLL-RRR
+    0xFF25	NR51	Channel panning, left in the high nibble
+    0xFF26	NR52	Power, bit 7, and channel status
+    0xFF30	Wave RAM	32 4-bit samples for channel 3
+
+Nothing runs per cycle. Channels are brought up to date when a register is accessed
+and by the 512Hz frame sequencer event, adding a delta to the band-limited buffer only
+where their output changes. Each sequencer step also ends an audio frame. Output is
+mono, a channel plays when panned to either side.
+*/
+class APU : public emulator::component::Audio
+{
+public:
+    using Scheduler = emulator::component::Scheduler;
+
+    static constexpr double kClockRate = 4194304;
+    static constexpr Scheduler::Cycle kFrameSequencerPeriod = 8192;
+
+private:
+    static constexpr std::size_t kRegisterStart = 0xFF10;
+    static constexpr std::size_t kWaveRAMStart = 0xFF30;
+
+    // Output of one step of channel volume at full master volume, four channels at 15 fit a Sample
+    static constexpr int kVolumeScale = 256;
+
+    struct Channel {
+        bool enabled;
+        bool dac;
+        std::uint16_t frequency;
+
+        // Cycles until the next duty, sample or LFSR step
+        Scheduler::Cycle timer;
+
+        // Last output added to the buffer
+        int level;
+
+        std::uint16_t length;
+        bool lengthEnabled;
+
+        std::uint8_t volume;
+        std::uint8_t envelopeTimer;
+
+        // Duty step, wave position or LFSR
+        std::uint16_t phase;
+
+        // Channel 1 only
+        std::uint16_t sweepShadow;
+        std::uint8_t sweepTimer;
+        bool sweepEnabled;
+    };
+    std::array<Channel, 4> channels_{};
+
+    // As last written, wave RAM included
+    std::array<std::uint8_t, 0x30> registers_{};
+    bool power_{false};
+
+    Scheduler::Cycle syncCycle_{0};
+    Scheduler::Cycle frameStart_{0};
+    std::uint8_t sequencerStep_{0};
+    Scheduler::EventID sequencerEvent_{Scheduler::kInvalidEvent};
+
+    std::uint8_t& Register(std::size_t address) noexcept
+    {
+        return registers_[address - kRegisterStart];
+    }
+
+    std::uint8_t Register(std::size_t address) const noexcept
+    {
+        return registers_[address - kRegisterStart];
+    }
+
+    // First register, NRx0, of a channel
+    static constexpr std::size_t ChannelBase(std::size_t channel) noexcept
+    {
+        return kRegisterStart + channel * 5;
+    }
+
+    Scheduler::Cycle Now() const noexcept;
+    Scheduler::Cycle Period(std::size_t channel) const noexcept;
+    std::uint8_t Digital(std::size_t channel) const noexcept;
+    int Gain(std::size_t channel) const noexcept;
+
+    void Step(std::size_t channel) noexcept;
+    void Emit(std::size_t channel, Scheduler::Cycle cycle) noexcept;
+    void Sync() noexcept;
+
+    void Trigger(std::size_t channel) noexcept;
+    std::uint16_t SweepTarget() noexcept;
+    void ClockLength() noexcept;
+    void ClockSweep() noexcept;
+    void ClockEnvelope() noexcept;
+
+    void ScheduleSequencer();
+    void CancelSequencer() noexcept;
+    void RunSequencer();
+
+public:
+    explicit APU(std::uint32_t sampleRate = kDefaultSampleRate);
+    ~APU();
+
+    void ReceiveTick() override
+    {
+    }
+
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
+    void AttachToBus(emulator::component::Bus* bus) override;
+    void RemoveFromBus() override;
+
+    void PowerOn() noexcept override;
+    void PowerOff() noexcept override;
+
+    void SaveState(emulator::component::StateWriter& state) const override
+    {
+        state.Write(channels_);
+        state.Write(registers_);
+        state.Write(power_);
+        state.Write(syncCycle_);
+        state.Write(frameStart_);
+        state.Write(sequencerStep_);
+        state.Write(sequencerEvent_);
+    }
+
+    void LoadState(emulator::component::StateReader& state) override
+    {
+        state.Read(channels_);
+        state.Read(registers_);
+        state.Read(power_);
+        state.Read(syncCycle_);
+        state.Read(frameStart_);
+        state.Read(sequencerStep_);
+        state.Read(sequencerEvent_);
+        blip_.Clear();
+    }
+
+    bool ChannelEnabled(std::size_t channel) const noexcept
+    {
+        return channels_[channel].enabled;
+    }
+
+    void WriteUInt8(std::size_t address, std::uint8_t value) override;
+    std::uint8_t ReadUInt8(std::size_t address) override;
+
+    void WriteInt8(std::size_t address, std::int8_t value) override
+    {
+        WriteUInt8(address, static_cast<std::uint8_t>(value));
+    }
+
+    std::int8_t ReadInt8(std::size_t address) override
+    {
+        return static_cast<std::int8_t>(ReadUInt8(address));
+    }
+};
+
+}; // namespace emulator::gameboy
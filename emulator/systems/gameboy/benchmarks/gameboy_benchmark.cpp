@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+
+#include <components/staticsystem.h>
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+#include "ppu.h"
+
+using emulator::gameboy::CPU;
+using GameBoySystem = emulator::component::StaticSystem<CPU, emulator::gameboy::PPU>;
+
+static emulator::component::System* CreateSystemWithProgram(const std::vector<std::uint8_t>& program)
+{
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+    auto& bus = system->GetBus();
+
+    bus.PowerOn();
+    for (std::size_t i = 0; i < program.size(); i++) {
+        bus.Write<std::uint8_t>(0xC000 + i, program[i]);
+    }
+
+    cpu->SetRegister<CPU::Registers::PC>(0xC000);
+    cpu->SetRegister<CPU::Registers::SP>(0xFFFE);
+    return system;
+}
+
+// Arithmetic and memory loop running from WRAM, args(0) enables the block cache, args(1) the static tick loop
+static void BM_GameBoyInstructions(benchmark::State& state)
+{
+    auto system = CreateSystemWithProgram({
+        0x04,             // INC B
+        0x48,             // LD C, B
+        0x81,             // ADD A, C
+        0x3C,             // INC A
+        0x00,             // NOP
+        0x21, 0x00, 0xC1, // LD HL, 0xC100
+        0x7E,             // LD A, (HL)
+        0x18, 0xF5,       // JR -11
+    });
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+    auto& bus = system->GetBus();
+    cpu->SetBlockCacheEnabled(state.range(0));
+    static_cast<GameBoySystem*>(system)->UseDynamicTick(!state.range(1));
+
+    auto instructions = cpu->GetInstructionCount();
+    auto cycles = bus.GetScheduler().Now();
+    for (auto _ : state) {
+        bus.ReceiveTick();
+    }
+
+    state.SetItemsProcessed(cpu->GetInstructionCount() - instructions);
+    state.counters["cycles"] = benchmark::Counter(bus.GetScheduler().Now() - cycles, benchmark::Counter::kIsRate);
+    delete system;
+}
+BENCHMARK(BM_GameBoyInstructions)->ArgNames({"blockcache", "static"})->ArgsProduct({{0, 1}, {0, 1}});
+
+// Same loop with every instruction recorded to a binary trace
+static void BM_GameBoyTrace(benchmark::State& state)
+{
+    auto path = (std::filesystem::temp_directory_path() / "gameboy_benchmark.trace").string();
+    auto system = CreateSystemWithProgram({
+        0x04,             // INC B
+        0x48,             // LD C, B
+        0x81,             // ADD A, C
+        0x3C,             // INC A
+        0x00,             // NOP
+        0x21, 0x00, 0xC1, // LD HL, 0xC100
+        0x7E,             // LD A, (HL)
+        0x18, 0xF5,       // JR -11
+    });
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+    auto& bus = system->GetBus();
+    system->StartTrace(path);
+
+    auto instructions = cpu->GetInstructionCount();
+    for (auto _ : state) {
+        bus.ReceiveTick();
+    }
+
+    state.SetItemsProcessed(cpu->GetInstructionCount() - instructions);
+    system->StopTrace();
+    state.counters["bytes/instr"] = double(std::filesystem::file_size(path)) / (cpu->GetInstructionCount() - instructions);
+    std::remove(path.c_str());
+    delete system;
+}
+BENCHMARK(BM_GameBoyTrace);
+
+// Full frames with the LCD on and the CPU spinning on a short jump, args(0) uses the static tick loop
+static void BM_GameBoyFrame(benchmark::State& state)
+{
+    static constexpr std::uint64_t kCyclesPerFrame = 70224;
+
+    auto system = CreateSystemWithProgram({
+        0x00,       // NOP
+        0x18, 0xFD, // JR -3
+    });
+    auto& bus = system->GetBus();
+    static_cast<GameBoySystem*>(system)->UseDynamicTick(!state.range(0));
+    auto& scheduler = bus.GetScheduler();
+    bus.Write<std::uint8_t>(0xFF40, 0x91);
+
+    for (auto _ : state) {
+        auto end = scheduler.Now() + kCyclesPerFrame;
+        while (scheduler.Now() < end) {
+            bus.ReceiveTick();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    delete system;
+}
+BENCHMARK(BM_GameBoyFrame)->Unit(benchmark::kMicrosecond)->ArgName("static")->Arg(0)->Arg(1);
+
+// CPU state copy, the only GameBoy snapshot mechanism
+static void BM_GameBoyCPUSnapshot(benchmark::State& state)
+{
+    auto system = CreateSystemWithProgram({0x00});
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+
+    for (auto _ : state) {
+        CPU snapshot(*cpu);
+        benchmark::DoNotOptimize(snapshot);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    delete system;
+}
+BENCHMARK(BM_GameBoyCPUSnapshot);
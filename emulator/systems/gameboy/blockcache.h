@@ -0,0 +1,159 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace emulator::gameboy
+{
+
+class CPU;
+
+/**
+ * Decoded instructions grouped into basic blocks, keyed by start PC and ROM bank.
+ *
+ * Blocks are filled lazily as the CPU executes them and end on the first
+ * control flow instruction. The bytes of blocks in writable memory are
+ * tracked so a write to them drops every writable block. Blocks are only
+ * dropped from Flush() so microcode executing out of a block stays valid
+ * until the instruction completes.
+ */
+class BlockCache
+{
+public:
+    using MicroCode = std::function<void(CPU*)>;
+
+    static constexpr std::size_t kMaxBlockLength = 64;
+
+    // First address that can hold code and be written
+    static constexpr std::uint16_t kWritableStart = 0x8000;
+
+    struct Instruction {
+        std::uint16_t address;
+        bool endsBlock;
+
+        // Microcode stack after decode, bottom first
+        std::vector<MicroCode> microcode;
+    };
+
+    struct Block {
+        std::vector<Instruction> instructions;
+        bool complete{false};
+    };
+
+    struct Stats {
+        std::uint64_t hits{0};
+        std::uint64_t misses{0};
+        std::uint64_t invalidations{0};
+    };
+
+private:
+    std::unordered_map<std::uint32_t, Block> blocks_;
+    std::bitset<0x10000> codeBytes_;
+
+    // Bumped whenever blocks are dropped so stale Block pointers are detected
+    std::uint64_t generation_{0};
+
+    bool invalidatePending_{false};
+    bool clearPending_{false};
+
+    Stats stats_;
+
+    static constexpr std::uint32_t Key(std::uint16_t pc, std::uint8_t bank) noexcept
+    {
+        return (std::uint32_t(bank) << 16) | pc;
+    }
+
+public:
+    BlockCache() = default;
+
+    // Decoded microcode is bound to the owning CPU, copies start empty
+    BlockCache(const BlockCache&) : BlockCache() {}
+    BlockCache& operator=(const BlockCache&)
+    {
+        Clear();
+        Flush();
+        return *this;
+    }
+
+    std::uint64_t Generation() const noexcept
+    {
+        return generation_;
+    }
+
+    const Stats& GetStats() const noexcept
+    {
+        return stats_;
+    }
+
+    std::size_t Size() const noexcept
+    {
+        return blocks_.size();
+    }
+
+    Block& Lookup(std::uint16_t pc, std::uint8_t bank)
+    {
+        auto [it, inserted] = blocks_.try_emplace(Key(pc, bank));
+        if (inserted) {
+            ++stats_.misses;
+        } else {
+            ++stats_.hits;
+        }
+        return it->second;
+    }
+
+    void Append(Block& block, Instruction instruction)
+    {
+        if (instruction.address >= kWritableStart) {
+            // Longest instruction is 3 bytes
+            for (std::uint32_t i = instruction.address; i < instruction.address + 3u && i < codeBytes_.size(); ++i) {
+                codeBytes_.set(i);
+            }
+        }
+
+        block.complete = instruction.endsBlock || block.instructions.size() + 1 >= kMaxBlockLength;
+        block.instructions.push_back(std::move(instruction));
+    }
+
+    void InvalidateWrite(std::size_t address, std::size_t size) noexcept
+    {
+        for (std::size_t i = address; i < address + size && i < codeBytes_.size(); ++i) {
+            if (codeBytes_.test(i)) {
+                invalidatePending_ = true;
+                return;
+            }
+        }
+    }
+
+    void Clear() noexcept
+    {
+        clearPending_ = true;
+    }
+
+    // Drop blocks invalidated since the last call, only between instructions
+    void Flush()
+    {
+        if (!invalidatePending_ && !clearPending_) [[likely]] {
+            return;
+        }
+
+        if (clearPending_) {
+            blocks_.clear();
+        } else {
+            // Self-modifying code is rare, drop everything that lives in writable memory
+            std::erase_if(blocks_, [](const auto& entry) {
+                return (entry.first & 0xFFFF) >= kWritableStart;
+            });
+            ++stats_.invalidations;
+        }
+        codeBytes_.reset();
+
+        invalidatePending_ = false;
+        clearPending_ = false;
+        ++generation_;
+    }
+};
+
+}; // namespace emulator::gameboy
@@ -2,10 +2,14 @@
 #include "debugger.h"
 
 #include <components/exceptions/AddressInUse.h>
+#include <components/log.h>
 #include <components/memory.h>
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace emulator::gameboy
 {
 
@@ -14,64 +18,406 @@ CPU::CPU() : microcodeStackLength_(0), microcode_{}, registers_{}
 }
 
 CPU::CPU(const CPU& other)
-    : microcodeStackLength_(other.microcodeStackLength_),
+    : enableIMENextCycle_(other.enableIMENextCycle_),
+      IME_(other.IME_),
+      interrupts_(other.interrupts_),
+      haltMode_(other.haltMode_),
+      tCycles_(other.tCycles_),
+      idleLoop_(other.idleLoop_),
+      instructionPC_(other.instructionPC_),
+      idleLoopSkip_(other.idleLoopSkip_),
+      microcodeStackLength_(other.microcodeStackLength_),
       microcode_(other.microcode_),
+      scratch8_(other.scratch8_),
+      scratch16_(other.scratch16_),
+      blockCacheEnabled_(other.blockCacheEnabled_),
+      romBank_(other.romBank_),
       registers_(other.registers_)
 {
+    // Cached microcode belongs to the other CPU, move what is left of it onto the stack
+    if (other.blockMicrocodeLength_ > 0) {
+        auto length = other.microcodeStackLength_;
+        std::copy(other.microcode_.begin(), other.microcode_.begin() + length,
+                  microcode_.begin() + other.blockMicrocodeLength_);
+        std::copy(other.blockMicrocode_, other.blockMicrocode_ + other.blockMicrocodeLength_, microcode_.begin());
+        microcodeStackLength_ = length + other.blockMicrocodeLength_;
+    }
 }
 
 CPU::~CPU() {}
 
-void CPU::ReceiveTick()
+void CPU::SaveState(emulator::component::StateWriter& state) const
 {
-    // CPU based off M-Cycles which are every 4 T-Cycles
-    static int TCycles = TCycleToMCycle;
-    if (--TCycles > 0) {
-        return;
-    } else {
-        TCycles = TCycleToMCycle;
-    }
+    emulator::component::CPU::SaveState(state);
+
+    state.Write(enableIMENextCycle_);
+    state.Write(IME_);
+    state.Write(interrupts_);
+    state.Write(haltMode_);
+    state.Write(tCycles_);
+    state.Write(idleLoop_);
+    state.Write(instructionPC_);
+    state.Write(idleLoopSkip_);
+    state.Write(scratch8_);
+    state.Write(scratch16_);
+    state.Write(romBank_);
+    state.Write(registers_);
+
+    // Cached microcode of the current instruction is saved below the stack, as the copy constructor does
+    std::array<MicroCode, 32> microcode{};
+    std::copy(blockMicrocode_, blockMicrocode_ + blockMicrocodeLength_, microcode.begin());
+    std::copy(microcode_.begin(), microcode_.begin() + microcodeStackLength_, microcode.begin() + blockMicrocodeLength_);
+    state.WriteObject(microcode);
+    state.Write(microcodeStackLength_ + blockMicrocodeLength_);
+}
+
+void CPU::LoadState(emulator::component::StateReader& state)
+{
+    emulator::component::CPU::LoadState(state);
+
+    state.Read(enableIMENextCycle_);
+    state.Read(IME_);
+    state.Read(interrupts_);
+    state.Read(haltMode_);
+    state.Read(tCycles_);
+    state.Read(idleLoop_);
+    state.Read(instructionPC_);
+    state.Read(idleLoopSkip_);
+    state.Read(scratch8_);
+    state.Read(scratch16_);
+    state.Read(romBank_);
+    state.Read(registers_);
+    state.ReadObject(microcode_);
+    state.Read(microcodeStackLength_);
+
+    // Memory was restored without going through the bus, so nothing decoded can be trusted
+    blockMicrocode_ = nullptr;
+    blockMicrocodeLength_ = 0;
+    currentBlock_ = nullptr;
+    blockCache_.Clear();
+}
+
+void CPU::ExecuteMCycle()
+{
+    idleLoopSkip_ = false;
 
     if (enableIMENextCycle_) {
         IME_ = true;
         enableIMENextCycle_ = false;
     }
 
+    if (haltMode_ != HaltMode::Running) [[unlikely]] {
+        if (!ShouldWake()) {
+            // Nothing changes until an interrupt is raised, let the bus skip ahead
+            bus_->RequestIdleSkip();
+            return;
+        }
+        haltMode_ = HaltMode::Running;
+    }
+
     // Pipeline executes fetch on same cycle as end of execute
     // Decode and execute are same cycle(s) on real system
     // Fetch and decode are same cycle(s) when emulating
 
     if (microcodeStackLength_ > 0) {
-        auto microcode = microcode_[--microcodeStackLength_];
+        auto microcode = std::move(microcode_[--microcodeStackLength_]);
         if (microcode != nullptr) {
             microcode_[microcodeStackLength_] = nullptr;
             microcode(this);
         }
+    } else if (blockMicrocodeLength_ > 0) {
+        blockMicrocode_[--blockMicrocodeLength_](this);
     }
 
-    if (microcodeStackLength_ == 0) {
+    // HALT/STOP take effect before the next fetch
+    if (microcodeStackLength_ == 0 && blockMicrocodeLength_ == 0 && haltMode_ == HaltMode::Running) {
+        if (IME_ && interrupts_.Pending()) [[unlikely]] {
+            DispatchInterrupt();
+            return;
+        }
+
         // Step to next instruction
-        auto system = GetSystem();
-        if (system->DebuggerEnabled()) {
-            auto debugger = system->GetDebugger();
-            if (debugger != nullptr) {
-                // Do nothing if debugger has CPU stopped
-                if (debugger->IsStopped()) {
-                    return;
-                }
-
-                // Alert that stepping to next instruction
-                debugger->Notify(emulator::debugger::NotificationType::CPU_STEP, nullptr);
+        if (debugger_ != nullptr) [[unlikely]] {
+            // Do nothing if debugger has CPU stopped
+            if (debugger_->IsStopped()) {
+                return;
+            }
+
+            // Alert that stepping to next instruction, this may end a step or hit a breakpoint
+            emulator::debugger::Address next = GetRegister<Registers::PC>();
+            debugger_->Notify(emulator::debugger::NotificationType::CPU_STEP, &next);
+            if (debugger_->IsStopped()) {
+                return;
             }
         }
 
-        // Fetch and generate microcode for execution
+        // Jumped backwards a short distance, may be a busy-wait loop
         auto pc = GetRegister<Registers::PC>();
+        if (pc <= instructionPC_ && instructionPC_ - pc < kMaxIdleLoopLength) [[unlikely]] {
+            CheckIdleLoop(pc);
+        } else if (idleLoop_.checked && (pc < idleLoop_.head || pc > idleLoop_.tail)) {
+            idleLoop_.checked = false;
+        }
+        instructionPC_ = pc;
+        ++instructionCount_;
+
+        if (Tracing()) [[unlikely]] {
+            std::uint32_t opcode = bus_->Read<std::uint8_t>(pc);
+            if (opcode == 0xCB) {
+                opcode = (opcode << 8) | bus_->Read<std::uint8_t>(pc + 1);
+            }
+            TraceInstruction(pc, opcode);
+        }
+
+        FetchInstruction(pc);
+    }
+}
+
+// Control flow leaves the block, the next instruction starts a new one
+static constexpr bool EndsBlock(std::uint8_t opcode) noexcept
+{
+    switch (opcode) {
+    case 0x10: // STOP
+    case 0x18: // JR i8
+    case 0x20: // JR NZ, i8
+    case 0x28: // JR Z, i8
+    case 0x30: // JR NC, i8
+    case 0x38: // JR C, i8
+    case 0x76: // HALT
+    case 0xC0: // RET NZ
+    case 0xC2: // JP NZ, u16
+    case 0xC3: // JP u16
+    case 0xC4: // CALL NZ, u16
+    case 0xC7: // RST 00h
+    case 0xC8: // RET Z
+    case 0xC9: // RET
+    case 0xCA: // JP Z, u16
+    case 0xCC: // CALL Z, u16
+    case 0xCD: // CALL u16
+    case 0xCF: // RST 08h
+    case 0xD0: // RET NC
+    case 0xD2: // JP NC, u16
+    case 0xD4: // CALL NC, u16
+    case 0xD7: // RST 10h
+    case 0xD8: // RET C
+    case 0xD9: // RETI
+    case 0xDA: // JP C, u16
+    case 0xDC: // CALL C, u16
+    case 0xDF: // RST 18h
+    case 0xE7: // RST 20h
+    case 0xE9: // JP HL
+    case 0xEF: // RST 28h
+    case 0xF3: // DI
+    case 0xF7: // RST 30h
+    case 0xFB: // EI
+    case 0xFF: // RST 38h
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Load the microcode for the instruction at PC, from the block cache when it has been decoded before.
+// Operands are still read by the microcode so memory timing is unchanged.
+void CPU::FetchInstruction(std::uint16_t pc)
+{
+    if (!blockCacheEnabled_) [[unlikely]] {
         auto opcode = bus_->Read<std::uint8_t>(pc);
         AddRegister<Registers::PC>(1);
 
         DecodeOpcode(opcode);
+        return;
     }
+
+    blockCache_.Flush();
+    if (currentBlock_ != nullptr && blockGeneration_ != blockCache_.Generation()) [[unlikely]] {
+        currentBlock_ = nullptr;
+    }
+
+    if (currentBlock_ != nullptr) {
+        auto& instructions = currentBlock_->instructions;
+        if (blockIndex_ < instructions.size()) {
+            if (instructions[blockIndex_].address != pc) {
+                currentBlock_ = nullptr;
+            }
+        } else if (currentBlock_->complete || pc <= instructions.back().address ||
+                   pc - instructions.back().address > 3) {
+            // Block ended, or PC moved somewhere other than the following instruction
+            currentBlock_ = nullptr;
+        }
+    }
+
+    if (currentBlock_ == nullptr) {
+        currentBlock_ = &blockCache_.Lookup(pc, pc >= 0x4000 && pc < 0x8000 ? romBank_ : 0);
+        blockIndex_ = 0;
+        blockGeneration_ = blockCache_.Generation();
+    }
+
+    auto& instructions = currentBlock_->instructions;
+    if (blockIndex_ < instructions.size()) [[likely]] {
+        auto& microcode = instructions[blockIndex_++].microcode;
+        blockMicrocode_ = microcode.data();
+        blockMicrocodeLength_ = microcode.size();
+
+        AddRegister<Registers::PC>(1);
+        return;
+    }
+
+    // Not decoded yet, extend the block
+    auto opcode = bus_->Read<std::uint8_t>(pc);
+    AddRegister<Registers::PC>(1);
+
+    DecodeOpcode(opcode);
+
+    blockCache_.Append(*currentBlock_, {
+                                           .address = pc,
+                                           .endsBlock = EndsBlock(opcode),
+                                           .microcode = {microcode_.begin(), microcode_.begin() + microcodeStackLength_},
+                                       });
+    ++blockIndex_;
+}
+
+std::uint64_t CPU::IdleCycles() const noexcept
+{
+    if (enableIMENextCycle_) {
+        return 0;
+    }
+
+    if (haltMode_ != HaltMode::Running) {
+        return ShouldWake() ? 0 : std::numeric_limits<std::uint64_t>::max();
+    } else if (idleLoopSkip_) {
+        // Only an interrupt can change what the loop observes outside of PPU/scheduler events
+        return IME_ && interrupts_.Pending() ? 0 : std::numeric_limits<std::uint64_t>::max();
+    }
+    return 0;
+}
+
+void CPU::SkipCycles(std::uint64_t cycles) noexcept
+{
+    if (haltMode_ != HaltMode::Running) {
+        idleStats_.haltedCycles += cycles;
+    } else {
+        idleStats_.idleLoopCycles += cycles;
+    }
+
+    // Only the M-Cycle phase matters while idle
+    tCycles_ = (tCycles_ + TCycleToMCycle - (cycles % TCycleToMCycle) - 1) % TCycleToMCycle + 1;
+}
+
+void CPU::CheckIdleLoop(std::uint16_t head)
+{
+    if (!idleLoop_.checked || idleLoop_.head != head || idleLoop_.tail != instructionPC_) {
+        idleLoop_.head = head;
+        idleLoop_.tail = instructionPC_;
+        idleLoop_.checked = true;
+        idleLoop_.idle = IsIdleLoop(head, instructionPC_);
+
+        if (idleLoop_.idle) {
+            ++idleStats_.idleLoopsDetected;
+            EMU_TRACE(CPU, "[CPU] Idle loop 0x{:04X}-0x{:04X}", head, instructionPC_);
+        }
+    }
+
+    if (idleLoop_.idle) {
+        idleLoopSkip_ = true;
+        bus_->RequestIdleSkip();
+    }
+}
+
+// Memory only the CPU writes, or registers that only change on PPU mode changes and scheduled events
+static bool IsIdleLoopStableAddress(std::uint16_t address) noexcept
+{
+    return (address >= 0xC000 && address <= 0xFDFF) || // Internal RAM + echo
+           (address >= 0xFF80 && address <= 0xFFFE) || // HRAM
+           address == 0xFF0F ||                        // IF
+           address == 0xFF41 ||                        // STAT
+           address == 0xFF44;                          // LY
+}
+
+// Loop body may only contain instructions whose result is the same every iteration while the
+// memory they read is unchanged, and must end in a jump back to the head
+bool CPU::IsIdleLoop(std::uint16_t head, std::uint16_t tail)
+{
+    auto pc = head;
+    while (pc <= tail) {
+        auto opcode = bus_->Read<std::uint8_t>(pc);
+        std::uint16_t length = 1;
+        std::int32_t target = -1;
+        std::int32_t read = -1;
+
+        switch (opcode) {
+        case 0x00: // NOP
+        case 0xA7: // AND A
+        case 0xB7: // OR A
+        case 0xBF: // CP A
+            break;
+        case 0x7E: // LD A, (HL)
+        case 0xA6: // AND (HL)
+        case 0xB6: // OR (HL)
+        case 0xBE: // CP (HL)
+            read = GetRegister<Registers::HL>();
+            break;
+        case 0xE6: // AND u8
+        case 0xF6: // OR u8
+        case 0xFE: // CP u8
+            length = 2;
+            break;
+        case 0xF0: // LDH A, (u8)
+            length = 2;
+            read = 0xFF00 + bus_->Read<std::uint8_t>(pc + 1);
+            break;
+        case 0xFA: // LD A, (u16)
+            length = 3;
+            read = bus_->Read<std::uint8_t>(pc + 1) | (bus_->Read<std::uint8_t>(pc + 2) << 8);
+            break;
+        case 0xCB: {
+            // BIT n, A / BIT n, (HL)
+            auto cb = bus_->Read<std::uint8_t>(pc + 1);
+            if ((cb & 0xC7) == 0x46) {
+                read = GetRegister<Registers::HL>();
+            } else if ((cb & 0xC7) != 0x47) {
+                return false;
+            }
+            length = 2;
+        } break;
+        case 0x18: // JR i8
+        case 0x20: // JR NZ, i8
+        case 0x28: // JR Z, i8
+        case 0x30: // JR NC, i8
+        case 0x38: // JR C, i8
+            length = 2;
+            target = static_cast<std::uint16_t>(pc + 2 + static_cast<std::int8_t>(bus_->Read<std::uint8_t>(pc + 1)));
+            break;
+        case 0xC2: // JP NZ, u16
+        case 0xC3: // JP u16
+        case 0xCA: // JP Z, u16
+        case 0xD2: // JP NC, u16
+        case 0xDA: // JP C, u16
+            length = 3;
+            target = bus_->Read<std::uint8_t>(pc + 1) | (bus_->Read<std::uint8_t>(pc + 2) << 8);
+            break;
+        default:
+            return false;
+        }
+
+        if (read >= 0 && !IsIdleLoopStableAddress(static_cast<std::uint16_t>(read))) {
+            return false;
+        }
+
+        if (pc == tail) {
+            return target == head;
+        }
+        pc += length;
+    }
+    return false;
+}
+
+bool CPU::ShouldWake() const noexcept
+{
+    if (haltMode_ == HaltMode::Stopped) {
+        return interrupts_.IsRequested(InterruptController::Interrupt::Joypad);
+    }
+    return interrupts_.Pending() != 0;
 }
 
 void CPU::PowerOn() noexcept {}
@@ -81,6 +427,22 @@ void CPU::PowerOff() noexcept
     microcodeStackLength_ = 0;
     microcode_.fill(0);
     registers_.fill(0);
+
+    enableIMENextCycle_ = false;
+    IME_ = false;
+    interrupts_.Reset();
+    haltMode_ = HaltMode::Running;
+    tCycles_ = TCycleToMCycle;
+
+    idleLoop_ = {};
+    instructionPC_ = 0;
+    idleLoopSkip_ = false;
+    instructionCount_ = 0;
+
+    blockCache_.Clear();
+    currentBlock_ = nullptr;
+    blockIndex_ = 0;
+    blockMicrocodeLength_ = 0;
 }
 
 void CPU::PushMicrocode(MicroCode code)
@@ -94,8 +456,13 @@ void CPU::PushMicrocode(MicroCode code)
 
 void CPU::AttachToBus(component::Bus* bus)
 {
-    if (!bus->RegisterComponentAddressRange(this, {0xFF00, 0xFF40})) {
-        throw component::AddressInUse(0xFF00, 0x40);
+    // Skip joypad and timer registers
+    if (!bus->RegisterComponentAddressRange(this, {0xFF01, 0xFF03})) {
+        throw component::AddressInUse(0xFF01, 0x3);
+    }
+    // Skip sound registers
+    if (!bus->RegisterComponentAddressRange(this, {0xFF08, 0xFF0F})) {
+        throw component::AddressInUse(0xFF08, 0x8);
     }
     // Skip PPU controlled registers
     if (!bus->RegisterComponentAddressRange(this, {0xFF50, 0xFF70})) {
@@ -106,13 +473,39 @@ void CPU::AttachToBus(component::Bus* bus)
         throw component::AddressInUse(0xFFFF, 0x1);
     }
     bus_ = bus;
+
+    // Code running from RAM can be rewritten
+    bus->AddWriteObserver(this, {BlockCache::kWritableStart, 0xFFFF},
+                          [this](std::size_t address, std::size_t size) { blockCache_.InvalidateWrite(address, size); });
+}
+
+void CPU::GetRegisterFile(RegisterFile& registers) const
+{
+    // PC has already moved past the opcode of the instruction that just started
+    registers = {
+        {"AF", registers_[0]},
+        {"BC", registers_[1]},
+        {"DE", registers_[2]},
+        {"HL", registers_[3]},
+        {"SP", registers_[4]},
+        {"PC", registers_[5]},
+        {"IME", IME_},
+        {"IE", interrupts_.GetEnable()},
+        {"IF", interrupts_.GetFlags()},
+    };
 }
 
 void CPU::LogStacktrace() noexcept
 {
-    spdlog::debug("[CPU] AF: {:04X}   BC: {:04X}", GetRegister<Registers::AF>(), GetRegister<Registers::BC>());
-    spdlog::debug("[CPU] DE: {:04X}   HL: {:04X}", GetRegister<Registers::DE>(), GetRegister<Registers::HL>());
-    spdlog::debug("[CPU] SP: {:04X}   PC: {:04X}", GetRegister<Registers::SP>(), GetRegister<Registers::PC>());
+    EMU_DEBUG(CPU, "[CPU] AF: {:04X}   BC: {:04X}", GetRegister<Registers::AF>(), GetRegister<Registers::BC>());
+    EMU_DEBUG(CPU, "[CPU] DE: {:04X}   HL: {:04X}", GetRegister<Registers::DE>(), GetRegister<Registers::HL>());
+    EMU_DEBUG(CPU, "[CPU] SP: {:04X}   PC: {:04X}", GetRegister<Registers::SP>(), GetRegister<Registers::PC>());
+    EMU_DEBUG(CPU, "[CPU] Skipped {} halted / {} idle loop cycles ({} loops)",
+                  idleStats_.haltedCycles, idleStats_.idleLoopCycles, idleStats_.idleLoopsDetected);
+
+    auto& cacheStats = blockCache_.GetStats();
+    EMU_DEBUG(CPU, "[CPU] Block cache: {} blocks, {} hits / {} misses, {} invalidations",
+                  blockCache_.Size(), cacheStats.hits, cacheStats.misses, cacheStats.invalidations);
 }
 
 void CPU::SetStartup(const char* data, std::size_t size) noexcept
@@ -134,6 +527,7 @@ void CPU::LoadStartup() noexcept
 
     cartridge0->LoadData((const char*)bootData_, bootSize_);
     cartridge0->OverwriteContext(0, bootSize_); // Make Context 0 the boot ROM
+    blockCache_.Clear();
 }
 
 // Load the first 32KiB of the ROM into the cartridge memory
@@ -147,6 +541,7 @@ void CPU::LoadROM(const char* data, std::size_t size) noexcept
     romData_ = new std::uint8_t[size];
     romSize_ = size;
     std::memcpy((void*)romData_, data, size);
+    blockCache_.Clear();
 
     auto cartridge0 = reinterpret_cast<emulator::component::Memory<emulator::component::MemoryType::ReadOnly>*>(
         GetSystem()->GetComponent(emulator::gameboy::kCartridge0Name));
@@ -9,6 +9,8 @@
 #include <components/cpu.h>
 #include <components/system.h>
 
+#include "blockcache.h"
+#include "interrupts.h"
 #include "names.h"
 
 namespace emulator::gameboy
@@ -243,27 +245,51 @@ public:
 private:
     bool enableIMENextCycle_{false};
     bool IME_{false};
-    std::uint8_t IEFlags_{0};
-    std::uint8_t IFFlags_{0};
-
-    enum class InterruptFlag {
-        VBlank = 0,
-        LCDStat = 1,
-        Timer = 2,
-        Serial = 3,
-        Joypad = 4
-    };
+    InterruptController interrupts_;
 
-    template <InterruptFlag T>
-    constexpr bool GetInterruptFlag() const noexcept
-    {
-        return (IEFlags_ >> static_cast<std::uint8_t>(T)) & 0x1;
-    }
-
-    using MicroCode = std::function<void(CPU*)>;
+    enum class HaltMode {
+        Running,
+        Halted, // HALT, wakes on any enabled interrupt
+        Stopped // STOP, wakes on joypad input
+    };
+    HaltMode haltMode_{HaltMode::Running};
+
+    // T-Cycles left until the next M-Cycle
+    std::size_t tCycles_{TCycleToMCycle};
+
+    // Busy-wait loops (e.g. polling LY) are skipped like HALT while the polled value can not change
+    static constexpr std::uint16_t kMaxIdleLoopLength = 16;
+    struct {
+        std::uint16_t head{0};
+        std::uint16_t tail{0};
+        bool checked{false};
+        bool idle{false};
+    } idleLoop_;
+    std::uint16_t instructionPC_{0};
+    bool idleLoopSkip_{false};
+
+    using MicroCode = BlockCache::MicroCode;
     std::array<MicroCode, 32> microcode_;
     size_t microcodeStackLength_;
 
+    // Intermediate values shared between the microcode of one instruction
+    std::uint8_t scratch8_{0};
+    std::uint16_t scratch16_{0};
+
+    // Decoded instructions are replayed from the cache instead of decoded on every fetch
+    bool blockCacheEnabled_{true};
+    BlockCache blockCache_;
+    BlockCache::Block* currentBlock_{nullptr};
+    std::size_t blockIndex_{0};
+    std::uint64_t blockGeneration_{0};
+
+    // Cached microcode of the executing instruction, runs below anything pushed onto microcode_
+    const MicroCode* blockMicrocode_{nullptr};
+    std::size_t blockMicrocodeLength_{0};
+
+    // Bank mapped at 0x4000-0x7FFF, fixed until a memory bank controller is emulated
+    std::uint8_t romBank_{1};
+
     std::array<std::uint16_t, 6> registers_;
 
     const std::uint8_t* romData_{nullptr};
@@ -273,8 +299,15 @@ private:
     std::size_t bootSize_{0};
 
     void PushMicrocode(MicroCode code);
+    void FetchInstruction(std::uint16_t pc);
     void DecodeOpcode(std::uint8_t opcode);
 
+    bool ShouldWake() const noexcept;
+    void DispatchInterrupt();
+
+    void CheckIdleLoop(std::uint16_t head);
+    bool IsIdleLoop(std::uint16_t head, std::uint16_t tail);
+
     template <Registers reg>
     MicroCode GenerateRLC_RRC(bool shiftLeft)
     {
@@ -354,17 +387,69 @@ private:
 
     void DecodeCBOpcode();
 
+    void ExecuteMCycle();
+
 public:
     CPU();
     CPU(const CPU& other);
 
     ~CPU();
 
-    void ReceiveTick() override;
+    // Inline so a StaticSystem only pays for a call once per M-cycle
+    void ReceiveTick() override
+    {
+        // CPU based off M-Cycles which are every 4 T-Cycles
+        if (--tCycles_ > 0) [[likely]] {
+            return;
+        }
+        tCycles_ = TCycleToMCycle;
+        ExecuteMCycle();
+    }
+
+    std::uint64_t IdleCycles() const noexcept override;
+    void SkipCycles(std::uint64_t cycles) noexcept override;
+
+    InterruptController& GetInterruptController() noexcept
+    {
+        return interrupts_;
+    }
+
+    bool IsHalted() const noexcept
+    {
+        return haltMode_ != HaltMode::Running;
+    }
+
+    bool InterruptsEnabled() const noexcept
+    {
+        return IME_;
+    }
+
+    const BlockCache& GetBlockCache() const noexcept
+    {
+        return blockCache_;
+    }
+
+    // Decode every instruction on fetch, the reference to compare the block cache against
+    void SetBlockCacheEnabled(bool enabled) noexcept
+    {
+        blockCacheEnabled_ = enabled;
+        currentBlock_ = nullptr;
+    }
+
+    void GetRegisterFile(RegisterFile& registers) const override;
+
+    ProgramLocation GetProgramLocation() const noexcept override
+    {
+        // Only the switchable ROM window is banked
+        return {instructionPC_, instructionPC_ >= 0x4000 && instructionPC_ < 0x8000 ? romBank_ : 0u};
+    }
 
     void PowerOn() noexcept override;
     void PowerOff() noexcept override;
 
+    void SaveState(emulator::component::StateWriter& state) const override;
+    void LoadState(emulator::component::StateReader& state) override;
+
     void AttachToBus(component::Bus* bus) override;
 
     void LogStacktrace() noexcept override;
@@ -380,10 +465,11 @@ public:
             // Disable boot ROM if value != 0
             auto system = bus_->GetBoundSystem();
             bus_->RemoveComponent(system->GetComponent(kBootROMName));
+            blockCache_.Clear();
         } else if (address == 0xFFFF) {
-            IEFlags_ = value & 0b00011111;
+            interrupts_.SetEnable(value);
         } else if (address == 0xFF0F) {
-            IFFlags_ = value & 0b00011111;
+            interrupts_.SetFlags(value);
         }
     }
 
@@ -415,9 +501,9 @@ public:
     std::uint8_t ReadUInt8(std::size_t address) override
     {
         if (address == 0xFFFF) {
-            return IEFlags_;
+            return interrupts_.GetEnable();
         } else if (address == 0xFF0F) {
-            return IFFlags_;
+            return interrupts_.GetFlags();
         }
         return 0;
     }
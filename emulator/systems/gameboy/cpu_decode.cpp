@@ -45,11 +45,10 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // LD BC, d16
     case 0x01:
         // 12 Cycles
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::BC>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -112,13 +111,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD B, d8
     case 0x06:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::B>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -144,7 +142,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD (u16), SP
     case 0x08:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 20 Cycles
         PushMicrocode(CycleNoOp);
@@ -153,8 +151,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             auto WZ = static_cast<std::uint16_t*>(scratch);
             auto spMSB = static_cast<std::uint8_t>(cpu->GetRegister<Registers::SP>() >> 8);
             bus->Write<std::uint8_t>(*WZ + 1, spMSB);
-
-            delete WZ;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -203,13 +199,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (BC)
     case 0x0A:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -256,13 +251,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD C, d8
     case 0x0E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::C>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -286,14 +280,26 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
         });
         break;
 
+    // STOP
+    case 0x10:
+        // 4 Cycles
+        PushMicrocode([](CPU* cpu) {
+            // Second byte is ignored
+            cpu->AddRegister<Registers::PC>(1);
+            cpu->haltMode_ = HaltMode::Stopped;
+
+            // Writing any value to DIV resets it
+            cpu->bus_->Write<std::uint8_t>(0xFF04, 0);
+        });
+        break;
+
     // LD DE, d16
     case 0x11:
         // 12 Cycles
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::DE>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -356,13 +362,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD D, d8
     case 0x16:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::D>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -390,13 +395,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JR r8
     case 0x18:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         // Need to actually do parsing
         PushMicrocode([scratch](CPU* cpu) {
             // PC = WZ
             auto WZ = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::PC>(*WZ);
-            delete WZ;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
@@ -448,13 +452,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (DE)
     case 0x1A:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -501,13 +504,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD E, d8
     case 0x1E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::E>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -535,7 +537,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JR NZ, r8
     case 0x20:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto Z = static_cast<std::uint16_t*>(scratch);
 
@@ -550,7 +552,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // PC = WZ
                     auto WZ = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*WZ);
-                    delete WZ;
                 });
 
                 cpu->PushMicrocode([scratch](CPU* cpu) {
@@ -569,7 +570,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             } else {
                 // No Jump
                 cpu->PushMicrocode(CycleNoOp);
-                delete Z;
             }
         });
         break;
@@ -577,11 +577,10 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // LD HL, d16
     case 0x21:
         // 12 Cycles
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::HL>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -645,13 +644,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD H, d8
     case 0x26:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::H>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -662,7 +660,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JR Z, r8
     case 0x28:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto Z = static_cast<std::uint16_t*>(scratch);
 
@@ -677,7 +675,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // PC = WZ
                     auto WZ = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*WZ);
-                    delete WZ;
                 });
 
                 cpu->PushMicrocode([scratch](CPU* cpu) {
@@ -696,7 +693,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             } else {
                 // No Jump
                 cpu->PushMicrocode(CycleNoOp);
-                delete Z;
             }
         });
         break;
@@ -728,13 +724,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (HL+)
     case 0x2A:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -783,13 +778,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD L, d8
     case 0x2E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::L>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -800,7 +794,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JR NC, r8
     case 0x30:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto Z = static_cast<std::uint16_t*>(scratch);
 
@@ -815,7 +809,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // PC = WZ
                     auto WZ = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*WZ);
-                    delete WZ;
                 });
 
                 cpu->PushMicrocode([scratch](CPU* cpu) {
@@ -834,7 +827,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             } else {
                 // No Jump
                 cpu->PushMicrocode(CycleNoOp);
-                delete Z;
             }
         });
         break;
@@ -842,11 +834,10 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // LD SP, d16
     case 0x31:
         // 12 Cycles
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::SP>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -882,7 +873,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // INC (HL)
     case 0x34:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 12 Cycles
         PushMicrocode(CycleNoOp);
@@ -895,7 +886,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::Z>(value == 0);
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::H>(IsHC(*tmp, 1));
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -905,7 +895,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // DEC (HL)
     case 0x35:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 12 Cycles
         PushMicrocode(CycleNoOp);
@@ -918,7 +908,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::Z>(value == 0);
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::H>(IsHCSub(*tmp, 1));
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -928,7 +917,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD (HL), d8
     case 0x36:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 12 Cycles
         PushMicrocode(CycleNoOp);
@@ -936,7 +925,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             auto bus = cpu->bus_;
             auto tmp = static_cast<std::uint8_t*>(scratch);
             bus->Write<std::uint8_t>(cpu->GetRegister<Registers::HL>(), *tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -947,7 +935,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JR C, r8
     case 0x38:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
         PushMicrocode([scratch](CPU* cpu) {
             auto Z = static_cast<std::uint16_t*>(scratch);
 
@@ -962,7 +950,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // PC = WZ
                     auto WZ = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*WZ);
-                    delete WZ;
                 });
 
                 cpu->PushMicrocode([scratch](CPU* cpu) {
@@ -981,7 +968,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             } else {
                 // No Jump
                 cpu->PushMicrocode(CycleNoOp);
-                delete Z;
             }
         });
         break;
@@ -1013,13 +999,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (HL-)
     case 0x3A:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1068,13 +1053,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, d8
     case 0x3E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1131,13 +1115,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD B, (HL)
     case 0x46:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::B>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1201,13 +1184,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD C, (HL)
     case 0x4E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::C>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1271,13 +1253,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD D, (HL)
     case 0x56:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::D>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1341,13 +1322,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD E, (HL)
     case 0x5E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::E>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1411,13 +1391,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD H, (HL)
     case 0x66:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::H>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1481,13 +1460,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD L, (HL)
     case 0x6E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::L>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1563,6 +1541,14 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
         PushMicrocode(CycleNoOp);
         break;
 
+    // HALT
+    case 0x76:
+        // 4 Cycles
+        PushMicrocode([](CPU* cpu) {
+            cpu->haltMode_ = HaltMode::Halted;
+        });
+        break;
+
     // LD (HL), A
     case 0x77:
         PushMicrocode([](CPU* cpu) {
@@ -1623,13 +1609,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (HL)
     case 0x7E:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1742,7 +1727,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // ADD A, (HL)
     case 0x86:
         // 8 Cycles
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
         PushMicrocode([scratch](CPU* cpu) {
             auto a = static_cast<std::uint8_t>(cpu->GetRegister<Registers::A>());
             auto tmp = static_cast<std::uint8_t*>(scratch);
@@ -1753,8 +1738,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::C>(value < a);
             cpu->SetFlag<Flags::H>(IsHC(a, *tmp));
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -1876,7 +1859,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // SUB A, (HL)
     case 0x96:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -1889,8 +1872,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(true);
             cpu->SetFlag<Flags::C>(a < *tmp);
             cpu->SetFlag<Flags::H>(IsHCSub(a, *tmp));
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -2002,7 +1983,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // AND A, (HL)
     case 0xA6:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -2015,8 +1996,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::C>(false);
             cpu->SetFlag<Flags::H>(true);
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -2129,13 +2108,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // XOR (HL)
     case 0xAE:
         // 8 Cycles
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
         PushMicrocode([scratch](CPU* cpu) {
             auto a = static_cast<std::uint8_t>(cpu->GetRegister<Registers::A>());
 
             auto tmp = static_cast<std::uint8_t*>(scratch);
             std::uint8_t value = a ^ *tmp;
-            delete tmp;
 
             cpu->SetRegister<Registers::A>(value);
             cpu->SetFlag<Flags::Z>(value == 0);
@@ -2255,13 +2233,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // OR A, (HL)
     case 0xB6:
         // 8 Cycles
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
         PushMicrocode([scratch](CPU* cpu) {
             auto a = static_cast<std::uint8_t>(cpu->GetRegister<Registers::A>());
 
             auto tmp = static_cast<std::uint8_t*>(scratch);
             std::uint8_t value = a | *tmp;
-            delete tmp;
 
             cpu->SetRegister<Registers::A>(value);
             cpu->SetFlag<Flags::Z>(value == 0);
@@ -2369,7 +2346,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
     // CP A, (HL)
     case 0xBE:
         // 8 Cycles
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         PushMicrocode([scratch](CPU* cpu) {
             auto a = static_cast<std::uint8_t>(cpu->GetRegister<Registers::A>());
@@ -2378,8 +2355,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(true);
             cpu->SetFlag<Flags::H>(IsHCSub(a, *tmp));
             cpu->SetFlag<Flags::C>(a < *tmp);
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -2400,7 +2375,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // RET NZ
     case 0xC0:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // Always need a re-fetch cycle
         PushMicrocode(CycleNoOp);
@@ -2411,7 +2386,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // Set register
                     auto s = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*s);
-                    delete s;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     // Pop 1-byte for upper
@@ -2438,14 +2412,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // POP BC
     case 0xC1:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             // Set register
             auto s = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::BC>(*s);
-            delete s;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -2470,7 +2443,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JP NZ, a16
     case 0xC2:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/16 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2488,10 +2461,8 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -2505,14 +2476,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JP a16:
     case 0xC3:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 16 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
         PushMicrocode([scratch](CPU* cpu) {
             auto newPC = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::PC>(*newPC);
-            delete newPC;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -2534,7 +2504,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CALL NZ, u16
     case 0xC4:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/24 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2556,7 +2526,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto bus = cpu->bus_;
@@ -2568,7 +2537,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     cpu->SubRegister<Registers::SP>(1);
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -2602,7 +2570,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // ADD A, u8
     case 0xC6:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -2616,8 +2584,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::C>(value < a);
             cpu->SetFlag<Flags::H>(IsHC(a, *tmp));
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -2628,7 +2594,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // RET Z
     case 0xC8:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // Always need a re-fetch cycle
         PushMicrocode(CycleNoOp);
@@ -2639,7 +2605,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // Set register
                     auto s = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*s);
-                    delete s;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     // Pop 1-byte for upper
@@ -2666,7 +2631,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // RET
     case 0xC9:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // Always need a re-fetch cycle
         PushMicrocode(CycleNoOp);
@@ -2674,7 +2639,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             // Set register
             auto s = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::PC>(*s);
-            delete s;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -2699,7 +2663,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JP Z, a16
     case 0xCA:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/16 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2717,10 +2681,8 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -2743,7 +2705,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CALL Z, u16
     case 0xCC:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/24 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2765,7 +2727,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto bus = cpu->bus_;
@@ -2777,7 +2738,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     cpu->SubRegister<Registers::SP>(1);
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -2791,7 +2751,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CALL u16
     case 0xCD:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/24 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2802,7 +2762,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
             auto newPC = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::PC>(*newPC);
-            delete newPC;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -2833,7 +2792,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // RET NC
     case 0xD0:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // Always need a re-fetch cycle
         PushMicrocode(CycleNoOp);
@@ -2844,7 +2803,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // Set register
                     auto s = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*s);
-                    delete s;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     // Pop 1-byte for upper
@@ -2871,14 +2829,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // POP DE
     case 0xD1:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             // Set register
             auto s = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::DE>(*s);
-            delete s;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -2903,7 +2860,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // JP NC, a16
     case 0xD2:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/16 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2921,10 +2878,8 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -2938,7 +2893,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CALL NC, u16
     case 0xD4:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/24 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -2960,7 +2915,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto bus = cpu->bus_;
@@ -2972,7 +2926,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     cpu->SubRegister<Registers::SP>(1);
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -3006,7 +2959,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // SUB A, u8
     case 0xD6:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -3020,8 +2973,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(true);
             cpu->SetFlag<Flags::C>(a < *tmp);
             cpu->SetFlag<Flags::H>(IsHCSub(a, *tmp));
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -3032,7 +2983,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // RET C
     case 0xD8:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // Always need a re-fetch cycle
         PushMicrocode(CycleNoOp);
@@ -3043,7 +2994,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     // Set register
                     auto s = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*s);
-                    delete s;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     // Pop 1-byte for upper
@@ -3068,9 +3018,42 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
         });
         break;
 
+    // RETI
+    case 0xD9:
+        scratch = &scratch16_;
+
+        // Always need a re-fetch cycle
+        PushMicrocode(CycleNoOp);
+        PushMicrocode([scratch](CPU* cpu) {
+            // Set register and enable interrupts without delay
+            auto s = static_cast<std::uint16_t*>(scratch);
+            cpu->SetRegister<Registers::PC>(*s);
+            cpu->IME_ = true;
+        });
+        PushMicrocode([scratch](CPU* cpu) {
+            // Pop 1-byte for upper
+            auto bus = cpu->bus_;
+            auto upper = bus->Read<std::uint8_t>(cpu->GetRegister<Registers::SP>());
+
+            auto s = static_cast<std::uint16_t*>(scratch);
+            *s = (std::uint16_t(upper) << 8) | std::uint16_t(*s & 0xFF);
+
+            cpu->AddRegister<Registers::SP>(1);
+        });
+        PushMicrocode([scratch](CPU* cpu) {
+            // Pop 1-byte for lower
+            auto bus = cpu->bus_;
+
+            auto s = static_cast<std::uint16_t*>(scratch);
+            *s = bus->Read<std::uint8_t>(cpu->GetRegister<Registers::SP>());
+
+            cpu->AddRegister<Registers::SP>(1);
+        });
+        break;
+
     // JP C, a16
     case 0xDA:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/16 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -3088,10 +3071,8 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -3105,7 +3086,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CALL C, u16
     case 0xDC:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12/24 Cycles
         PushMicrocode(CycleNoOp); // Pipeline refresh
@@ -3127,7 +3108,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
                     auto newPC = static_cast<std::uint16_t*>(scratch);
                     cpu->SetRegister<Registers::PC>(*newPC);
-                    delete newPC;
                 });
                 cpu->PushMicrocode([scratch](CPU* cpu) {
                     auto bus = cpu->bus_;
@@ -3139,7 +3119,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
                     cpu->SubRegister<Registers::SP>(1);
                 });
             } else {
-                delete s;
             }
         });
         PushMicrocode([scratch](CPU* cpu) {
@@ -3153,14 +3132,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD (0xFF00 + n), A
     case 0xE0:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 12 Cycles
         PushMicrocode(CycleNoOp);
         PushMicrocode([scratch](CPU* cpu) {
             auto n = static_cast<std::uint8_t*>(scratch);
             std::uint16_t addr = std::uint16_t(0xFF00) | *n;
-            delete n;
 
             auto lsb = std::uint8_t(cpu->GetRegister<Registers::A>());
 
@@ -3176,14 +3154,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // POP HL
     case 0xE1:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             // Set register
             auto s = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::HL>(*s);
-            delete s;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -3241,7 +3218,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // AND A, u8
     case 0xE6:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -3255,8 +3232,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(false);
             cpu->SetFlag<Flags::C>(false);
             cpu->SetFlag<Flags::H>(true);
-
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -3275,7 +3250,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD (u16), A
     case 0xEA:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 16 Cycles
         PushMicrocode(CycleNoOp);
@@ -3284,7 +3259,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
             auto tmp = static_cast<std::uint16_t*>(scratch);
             bus->Write<std::uint8_t>(*tmp, static_cast<std::uint8_t>(cpu->GetRegister<Registers::A>()));
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -3302,7 +3276,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // XOR d8
     case 0xEE:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -3310,7 +3284,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
             auto tmp = static_cast<std::uint8_t*>(scratch);
             std::uint8_t value = a ^ *tmp;
-            delete tmp;
 
             cpu->SetRegister<Registers::A>(value);
             cpu->SetFlag<Flags::Z>(value == 0);
@@ -3327,13 +3300,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (0xFF00 + n)
     case 0xF0:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 12 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto n = static_cast<std::uint8_t*>(scratch);
             cpu->SetRegister<Registers::A>(*n);
-            delete n;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto n = static_cast<std::uint8_t*>(scratch);
@@ -3351,14 +3323,13 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // POP AF
     case 0xF1:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 12 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             // Set register
             auto s = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::AF>(*s);
-            delete s;
         });
         PushMicrocode([scratch](CPU* cpu) {
             // Pop 1-byte for upper
@@ -3411,7 +3382,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // OR A, u8
     case 0xF6:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 8 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -3419,7 +3390,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
             auto tmp = static_cast<std::uint8_t*>(scratch);
             std::uint8_t value = a | *tmp;
-            delete tmp;
 
             cpu->SetRegister<Registers::A>(value);
             cpu->SetFlag<Flags::Z>(value == 0);
@@ -3436,13 +3406,12 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // LD A, (u16)
     case 0xFA:
-        scratch = new std::uint16_t;
+        scratch = &scratch16_;
 
         // 16 Cycles
         PushMicrocode([scratch](CPU* cpu) {
             auto tmp = static_cast<std::uint16_t*>(scratch);
             cpu->SetRegister<Registers::A>(*tmp);
-            delete tmp;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -3474,7 +3443,7 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
 
     // CP A, u8
     case 0xFE:
-        scratch = new std::uint8_t;
+        scratch = &scratch8_;
 
         // 4 Cycles
         PushMicrocode([scratch](CPU* cpu) {
@@ -3484,7 +3453,6 @@ void CPU::DecodeOpcode(std::uint8_t opcode)
             cpu->SetFlag<Flags::N>(true);
             cpu->SetFlag<Flags::H>(IsHCSub(a, *other));
             cpu->SetFlag<Flags::C>(a < *other);
-            delete other;
         });
         PushMicrocode([scratch](CPU* cpu) {
             auto bus = cpu->bus_;
@@ -3530,13 +3498,12 @@ void CPU::DecodeCBOpcode()
             PushMicrocode(GenerateRLC_RRC<Registers::L>((opcode & 0xF) < 0x8));
             break;
         case 0x6:
-            scratch = new std::uint8_t;
+            scratch = &scratch8_;
             PushMicrocode([scratch](CPU* cpu) {
                 // Write Back
                 auto bus = cpu->bus_;
                 auto val = static_cast<std::uint8_t*>(scratch);
                 bus->Write<std::uint8_t>(cpu->GetRegister<Registers::HL>(), *val);
-                delete val;
             });
             PushMicrocode([opcode, scratch](CPU* cpu) {
                 int carry;
@@ -3588,13 +3555,12 @@ void CPU::DecodeCBOpcode()
             PushMicrocode(GenerateRL_RR<Registers::L>((opcode & 0xF) < 0x8));
             break;
         case 0x6:
-            scratch = new std::uint8_t;
+            scratch = &scratch8_;
             PushMicrocode([scratch](CPU* cpu) {
                 // Write Back
                 auto bus = cpu->bus_;
                 auto val = static_cast<std::uint8_t*>(scratch);
                 bus->Write<std::uint8_t>(cpu->GetRegister<Registers::HL>(), *val);
-                delete val;
             });
             PushMicrocode([opcode, scratch](CPU* cpu) {
                 int carry = cpu->GetFlag<Flags::C>();
@@ -3656,13 +3622,12 @@ void CPU::DecodeCBOpcode()
             PushMicrocode(GenerateBit8<Registers::L>(bit));
             break;
         case 0x6:
-            scratch = new std::uint8_t;
+            scratch = &scratch8_;
 
             // (HL)
             PushMicrocode([scratch, bit](CPU* cpu) {
                 auto tmp = static_cast<std::uint8_t*>(scratch);
                 auto z = (*tmp >> bit) & 0x1;
-                delete tmp;
 
                 cpu->SetFlag<Flags::Z>(z);
                 cpu->SetFlag<Flags::N>(0);
@@ -3685,4 +3650,32 @@ void CPU::DecodeCBOpcode()
     }
 }
 
+void CPU::DispatchInterrupt()
+{
+    auto interrupt = interrupts_.HighestPriorityPending();
+    interrupts_.Acknowledge(interrupt);
+    IME_ = false;
+    currentBlock_ = nullptr;
+
+    // 20 Cycles
+    PushMicrocode(CycleNoOp); // Pipeline refresh
+    PushMicrocode([interrupt](CPU* cpu) {
+        auto bus = cpu->bus_;
+        auto lsb = cpu->GetRegister<Registers::PC>() & 0xFF;
+        bus->Write<std::uint8_t>(cpu->GetRegister<Registers::SP>(), lsb);
+
+        cpu->SetRegister<Registers::PC>(InterruptController::Vector(interrupt));
+    });
+    PushMicrocode([](CPU* cpu) {
+        auto bus = cpu->bus_;
+        auto msb = cpu->GetRegister<Registers::PC>() >> 8;
+        bus->Write<std::uint8_t>(cpu->GetRegister<Registers::SP>(), msb);
+        cpu->SubRegister<Registers::SP>(1);
+    });
+    PushMicrocode([](CPU* cpu) {
+        cpu->SubRegister<Registers::SP>(1);
+    });
+    PushMicrocode(CycleNoOp);
+}
+
 }; // namespace emulator::gameboy
@@ -5,7 +5,13 @@
 #include <components/system.h>
 #include <debugger/sysdebugger.h>
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace emulator::gameboy
 {
@@ -15,6 +21,10 @@ class Debugger : public emulator::debugger::ISystemDebugger
 private:
     std::array<emulator::debugger::RegisterInfo, 1> kDebugRegisters;
 
+    struct Checkpoint : public emulator::debugger::ICheckpoint {
+        emulator::component::System::Snapshot snapshot;
+    };
+
     emulator::component::System* system_;
     emulator::gameboy::CPU* cpu_;
 
@@ -122,35 +132,131 @@ public:
         } else {
             return false;
         }
+        InvalidateFutureHistory();
         return true;
 
         // TODO: Repeat for all registers
     }
 
-    std::uint8_t* ReadMemory(emulator::debugger::Address addr, std::size_t& bytes) const noexcept
+    int RegisterIndex(std::string_view name) const noexcept
     {
-        auto bus = system_->GetBus();
+        static constexpr std::string_view kNames[] = {"af", "a", "f", "bc", "b", "c", "de", "d", "e", "hl", "h", "l", "sp", "pc"};
 
-        auto buf = new std::uint8_t[bytes];
-        if (buf == nullptr) {
-            bytes = 0;
-            return nullptr;
+        for (int i = 0; i < static_cast<int>(std::size(kNames)); i++) {
+            if (std::equal(name.begin(), name.end(), kNames[i].begin(), kNames[i].end(),
+                           [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; })) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Indices follow CPU::Registers
+    std::uint64_t ReadRegister(int index) const noexcept
+    {
+        using Registers = emulator::gameboy::CPU::Registers;
+        switch (static_cast<Registers>(index)) {
+        case Registers::AF:
+            return cpu_->GetRegister<Registers::AF>();
+        case Registers::A:
+            return cpu_->GetRegister<Registers::A>();
+        case Registers::F:
+            return cpu_->GetRegister<Registers::F>();
+        case Registers::BC:
+            return cpu_->GetRegister<Registers::BC>();
+        case Registers::B:
+            return cpu_->GetRegister<Registers::B>();
+        case Registers::C:
+            return cpu_->GetRegister<Registers::C>();
+        case Registers::DE:
+            return cpu_->GetRegister<Registers::DE>();
+        case Registers::D:
+            return cpu_->GetRegister<Registers::D>();
+        case Registers::E:
+            return cpu_->GetRegister<Registers::E>();
+        case Registers::HL:
+            return cpu_->GetRegister<Registers::HL>();
+        case Registers::H:
+            return cpu_->GetRegister<Registers::H>();
+        case Registers::L:
+            return cpu_->GetRegister<Registers::L>();
+        case Registers::SP:
+            return cpu_->GetRegister<Registers::SP>();
+        case Registers::PC:
+            return cpu_->GetRegister<Registers::PC>();
+        }
+        return 0;
+    }
+
+    std::size_t ReadMemory(emulator::debugger::Address addr, std::span<std::uint8_t> data) const noexcept
+    {
+        auto& bus = system_->GetBus();
+
+        // Stop at the first unmapped byte
+        auto bytes = bus.MappedLength(addr, data.size());
+        bus.ReadBlock(addr, data.first(bytes));
+        return bytes;
+    }
+
+    bool WriteMemory(emulator::debugger::Address addr, std::span<const std::uint8_t> data) noexcept
+    {
+        auto& bus = system_->GetBus();
+        if (bus.MappedLength(addr, data.size()) != data.size()) {
+            return false;
         }
 
-        for (auto start = addr, end = addr + bytes; start < end; start++) {
-            try {
-                buf[start - addr] = bus.Read<std::uint8_t>(start);
-            } catch (emulator::component::InvalidAddress) {
-                bytes = start - addr;
-                return buf;
+        bus.WriteBlock(addr, data);
+        InvalidateFutureHistory();
+        return true;
+    }
+
+    std::vector<emulator::debugger::MemoryRegion> GetMemoryMap() const
+    {
+        using emulator::debugger::MemoryRegion;
+
+        std::vector<MemoryRegion> regions;
+        for (const auto& range : system_->GetBus().GetAddressRanges()) {
+            auto type = range.component->IsReadOnly() ? MemoryRegion::Type::ROM : MemoryRegion::Type::RAM;
+
+            // Ranges can overlap by a byte, later ones are trimmed to start where the last ended
+            auto start = range.start;
+            if (!regions.empty()) {
+                auto& last = regions.back();
+                start = std::max(start, last.start + last.length);
+                if (start > range.end) {
+                    continue;
+                }
+
+                if (last.type == type && last.start + last.length == start) {
+                    last.length += range.end - start + 1;
+                    continue;
+                }
             }
+            regions.push_back({start, range.end - start + 1, type});
         }
-        return buf;
+        return regions;
+    }
+
+    bool SupportsReverse() const noexcept
+    {
+        return system_ != nullptr;
+    }
+
+    std::unique_ptr<emulator::debugger::ICheckpoint> SaveCheckpoint() const
+    {
+        auto checkpoint = std::make_unique<Checkpoint>();
+        checkpoint->snapshot = system_->SaveSnapshot();
+        return checkpoint;
+    }
+
+    void RestoreCheckpoint(const emulator::debugger::ICheckpoint& checkpoint)
+    {
+        system_->RestoreSnapshot(static_cast<const Checkpoint&>(checkpoint).snapshot);
     }
 
-    bool WriteMemory(emulator::debugger::Address, void*, std::size_t) noexcept
+    std::uint64_t GetInstructionCount() const noexcept
     {
-        return false;
+        return cpu_->GetInstructionCount();
     }
 };
 
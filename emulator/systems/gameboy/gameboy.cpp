@@ -3,31 +3,51 @@
 #include <components/display.h>
 #include <components/memory.h>
 #include <components/multimappedmemory.h>
+#include <components/staticsystem.h>
 #include <emulator.h>
 
+#include "apu.h"
 #include "cpu.h"
 #include "debugger.h"
+#include "joypad.h"
 #include "names.h"
 #include "ppu.h"
+#include "timer.h"
 
 emulator::component::System* CreateSystem()
 {
     auto cpu = new emulator::gameboy::CPU();
     auto debugger = new emulator::gameboy::Debugger(cpu);
 
+    // 8 KiB VRAM
+    auto vram = new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0x8000, 0x2000);
+
+    auto ppu = new emulator::gameboy::PPU();
+    ppu->SetInterruptController(&cpu->GetInterruptController());
+    ppu->SetVRAM(vram);
+
+    auto timer = new emulator::gameboy::Timer();
+    timer->SetInterruptController(&cpu->GetInterruptController());
+
     auto notUsedMemory = new emulator::component::Memory<emulator::component::MemoryType::ReadOnly>(0xFEA0, 0x60, true);
     notUsedMemory->Fill(0xFF);
 
-    auto system = new emulator::component::System(
+    // The CPU and PPU are the only tickable components, tick them without virtual dispatch
+    auto system = new emulator::component::StaticSystem<emulator::gameboy::CPU, emulator::gameboy::PPU>(
         "GameBoy",
         4194304, // 4.194304 MHz
         {
-            {emulator::gameboy::kDisplayName, new emulator::gameboy::PPU()},
+            {emulator::gameboy::kDisplayName, ppu},
 
             {emulator::gameboy::kCPUName, cpu},
 
-            // 8 KiB VRAM
-            {emulator::gameboy::kVRAMName, new emulator::component::Memory<emulator::component::MemoryType::ReadWrite>(0x8000, 0x2000)},
+            {emulator::gameboy::kTimerName, timer},
+
+            {emulator::gameboy::kJoypadName, new emulator::gameboy::Joypad()},
+
+            {emulator::gameboy::kAPUName, new emulator::gameboy::APU()},
+
+            {emulator::gameboy::kVRAMName, vram},
 
             // 8 KiB Internal RAM
             {emulator::gameboy::kInternal8KiBRAMName, new emulator::component::MultiMappedMemory<emulator::component::MemoryType::ReadWrite>({{0xC000, 0xE000}, {0xE000, 0xFDFF}}, 0x2000)},
@@ -49,6 +69,9 @@ emulator::component::System* CreateSystem()
 
     debugger->SetSystem(system);
 
+    // Unmapped reads float high on the GameBoy bus
+    system->GetBus().SetAccessFaultPolicy(emulator::component::AccessFaultPolicy::LogOnce, 0xFF);
+
     system->RegisterFrontendFunction("Load Startup", [cpu](emulator::component::FrontendInterface& frontend) {
         auto selectedFile = frontend.OpenFileDialog();
         if (selectedFile.empty()) {
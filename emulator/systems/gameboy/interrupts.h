@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace emulator::gameboy
+{
+
+/*
+Interrupts (IE @ 0xFFFF, IF @ 0xFF0F):
+    Bit	Source	Vector
+    0	VBlank	0x40
+    1	STAT	0x48
+    2	Timer	0x50
+    3	Serial	0x58
+    4	Joypad	0x60
+*/
+class InterruptController
+{
+public:
+    enum class Interrupt {
+        VBlank = 0,
+        LCDStat = 1,
+        Timer = 2,
+        Serial = 3,
+        Joypad = 4
+    };
+
+    static constexpr std::uint8_t kInterruptMask = 0b00011111;
+
+private:
+    std::uint8_t IEFlags_{0};
+    std::uint8_t IFFlags_{0};
+
+public:
+    static constexpr std::uint16_t Vector(Interrupt interrupt) noexcept
+    {
+        return 0x40 + static_cast<std::uint16_t>(interrupt) * 0x8;
+    }
+
+    void Request(Interrupt interrupt) noexcept
+    {
+        IFFlags_ |= 1 << static_cast<std::uint8_t>(interrupt);
+    }
+
+    void Acknowledge(Interrupt interrupt) noexcept
+    {
+        IFFlags_ &= ~(1 << static_cast<std::uint8_t>(interrupt));
+    }
+
+    bool IsRequested(Interrupt interrupt) const noexcept
+    {
+        return (IFFlags_ >> static_cast<std::uint8_t>(interrupt)) & 0x1;
+    }
+
+    // Enabled and requested interrupts, regardless of IME
+    std::uint8_t Pending() const noexcept
+    {
+        return IEFlags_ & IFFlags_ & kInterruptMask;
+    }
+
+    // Lowest bit has the highest priority
+    Interrupt HighestPriorityPending() const noexcept
+    {
+        return static_cast<Interrupt>(std::countr_zero(Pending()));
+    }
+
+    std::uint8_t GetEnable() const noexcept
+    {
+        return IEFlags_;
+    }
+
+    void SetEnable(std::uint8_t value) noexcept
+    {
+        IEFlags_ = value & kInterruptMask;
+    }
+
+    std::uint8_t GetFlags() const noexcept
+    {
+        return IFFlags_;
+    }
+
+    void SetFlags(std::uint8_t value) noexcept
+    {
+        IFFlags_ = value & kInterruptMask;
+    }
+
+    void Reset() noexcept
+    {
+        IEFlags_ = 0;
+        IFFlags_ = 0;
+    }
+};
+
+}; // namespace emulator::gameboy
@@ -0,0 +1,60 @@
+#include "joypad.h"
+
+#include <components/exceptions/AddressInUse.h>
+
+namespace emulator::gameboy
+{
+
+Joypad::Joypad() : emulator::component::Input(kFrameCycles)
+{
+    // Host keycodes in Key order
+    constexpr static InputKeyCode kKeycodes[] = {
+        0x4000004F, // Right arrow
+        0x40000050, // Left arrow
+        0x40000052, // Up arrow
+        0x40000051, // Down arrow
+        0x78,       // X
+        0x7A,       // Z
+        0x08,       // Backspace
+        0x0D,       // Return
+    };
+    for (auto keycode : kKeycodes) {
+        RegisterKey(keycode);
+    }
+}
+
+void Joypad::AttachToBus(emulator::component::Bus* bus)
+{
+    if (!bus->RegisterComponentAddressRange(this, {0xFF00, 0xFF00})) {
+        throw component::AddressInUse(0xFF00, 0x1);
+    }
+    bus_ = bus;
+}
+
+void Joypad::PowerOn() noexcept
+{
+    Input::PowerOn();
+    select_ = 0x30;
+}
+
+void Joypad::WriteUInt8(std::size_t address, std::uint8_t value)
+{
+    select_ = value & 0x30;
+}
+
+std::uint8_t Joypad::ReadUInt8(std::size_t address)
+{
+    Poll();
+    auto pressed = GetPressed();
+
+    std::uint8_t lines = 0;
+    if ((select_ & 0x10) == 0) {
+        lines |= pressed & 0xF;
+    }
+    if ((select_ & 0x20) == 0) {
+        lines |= (pressed >> 4) & 0xF;
+    }
+    return 0xC0 | select_ | (~lines & 0xF);
+}
+
+}; // namespace emulator::gameboy
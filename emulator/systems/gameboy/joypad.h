@@ -0,0 +1,71 @@
+#pragma once
+
+#include <components/bus.h>
+#include <components/input.h>
+
+namespace emulator::gameboy
+{
+
+/*
+Joypad register:
+    Address	Name	Explanation
+    0xFF00	P1	Bit 5 selects buttons, bit 4 the d-pad, bits 0-3 are low while a selected key is pressed
+
+Keys are registered in P1 bit order, d-pad then buttons, so each group is a nibble of
+the pressed mask. Input is polled on reads of P1, once per frame, and the joypad
+interrupt is not raised.
+*/
+class Joypad : public emulator::component::Input
+{
+public:
+    // Cycles per frame, 154 lines of 456 dots
+    static constexpr emulator::component::Scheduler::Cycle kFrameCycles = 70224;
+
+    enum class Key {
+        Right,
+        Left,
+        Up,
+        Down,
+        A,
+        B,
+        Select,
+        Start,
+    };
+
+private:
+    std::uint8_t select_{0x30};
+
+public:
+    Joypad();
+
+    void AttachToBus(emulator::component::Bus* bus) override;
+
+    void PowerOn() noexcept override;
+
+    void SaveState(emulator::component::StateWriter& state) const override
+    {
+        Input::SaveState(state);
+        state.Write(select_);
+    }
+
+    void LoadState(emulator::component::StateReader& state) override
+    {
+        Input::LoadState(state);
+        state.Read(select_);
+    }
+
+    void WriteUInt8(std::size_t address, std::uint8_t value) override;
+    std::uint8_t ReadUInt8(std::size_t address) override;
+
+    void WriteInt8(std::size_t address, std::int8_t value) override
+    {
+        WriteUInt8(address, static_cast<std::uint8_t>(value));
+    }
+
+    std::int8_t ReadInt8(std::size_t address) override
+    {
+        return static_cast<std::int8_t>(ReadUInt8(address));
+    }
+};
+
+}; // namespace emulator::gameboy
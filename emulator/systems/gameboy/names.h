@@ -5,6 +5,9 @@ namespace emulator::gameboy
 
 static constexpr const char* kDisplayName = "Display";
 static constexpr const char* kCPUName = "CPU";
+static constexpr const char* kTimerName = "Timer";
+static constexpr const char* kJoypadName = "Joypad";
+static constexpr const char* kAPUName = "APU";
 static constexpr const char* kVRAMName = "VRAM";
 static constexpr const char* kInternal8KiBRAMName = "Internal8KiBRAM";
 static constexpr const char* kUpperInternalRAMName = "UpperInternalRAM";
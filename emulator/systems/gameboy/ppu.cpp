@@ -34,6 +34,63 @@ void PPU::ReceiveTick()
     }
 }
 
+std::uint64_t PPU::IdleCycles() const noexcept
+{
+    // Outside of pixel transfer nothing happens until the mode's last tick
+    std::size_t modeEnd;
+    switch (mode_) {
+    case PPUMode::OAM:
+        modeEnd = 80;
+        break;
+    case PPUMode::HBlank:
+    case PPUMode::VBlank:
+        modeEnd = 456;
+        break;
+    default:
+        return 0;
+    }
+
+    return tickTracker_ + 1 < modeEnd ? modeEnd - tickTracker_ - 1 : 0;
+}
+
+void PPU::SkipCycles(std::uint64_t cycles) noexcept
+{
+    tickTracker_ += cycles;
+}
+
+void PPU::setMode(PPUMode mode) noexcept
+{
+    mode_ = mode;
+
+    int statSource = -1;
+    switch (mode) {
+    case PPUMode::HBlank:
+        statSource = 3;
+        break;
+    case PPUMode::VBlank:
+        requestInterrupt(InterruptController::Interrupt::VBlank);
+        statSource = 4;
+        break;
+    case PPUMode::OAM:
+        statSource = 5;
+        break;
+    default:
+        break;
+    }
+
+    if (statSource >= 0 && ((statInterruptSelect_ >> statSource) & 0x1)) {
+        requestInterrupt(InterruptController::Interrupt::LCDStat);
+    }
+}
+
+void PPU::setLY(std::uint8_t ly) noexcept
+{
+    LY_ = ly;
+    if (LY_ == LYC_ && (statInterruptSelect_ & 0x40)) {
+        requestInterrupt(InterruptController::Interrupt::LCDStat);
+    }
+}
+
 void PPU::AttachToBus(emulator::component::Bus* bus)
 {
     // OAM - Object Attribute Memory
@@ -47,6 +104,109 @@ void PPU::AttachToBus(emulator::component::Bus* bus)
     bus_ = bus;
 }
 
+void PPU::PowerOn() noexcept
+{
+    Display::PowerOn();
+
+    // The bus has already dropped any pending completion with the scheduler reset
+    if (dmaActive_) {
+        bus_->RemoveAddressOverrides(this);
+        dmaActive_ = false;
+    }
+    oam_.fill(0);
+}
+
+void PPU::SaveState(emulator::component::StateWriter& state) const
+{
+    Display::SaveState(state);
+
+    state.Write(spriteFIFO_);
+    state.Write(bgFIFO_);
+    state.Write(SCY_);
+    state.Write(SCX_);
+    state.Write(LY_);
+    state.Write(LX_);
+    state.Write(WY_);
+    state.Write(WX_);
+    state.Write(LYC_);
+    state.Write(statInterruptSelect_);
+    state.Write(GetLCDCRegister());
+    state.Write(mode_);
+    state.Write(tickTracker_);
+    state.Write(oam_);
+    state.Write(dmaSource_);
+    state.Write(dmaEvent_);
+    state.Write(dmaActive_);
+    state.WriteBytes(colorPalette_, sizeof(colorPalette_));
+    state.Write(pixelTransferBackgroundState_);
+}
+
+void PPU::LoadState(emulator::component::StateReader& state)
+{
+    Display::LoadState(state);
+
+    auto dmaWasActive = dmaActive_;
+
+    std::uint8_t lcdc = 0;
+    state.Read(spriteFIFO_);
+    state.Read(bgFIFO_);
+    state.Read(SCY_);
+    state.Read(SCX_);
+    state.Read(LY_);
+    state.Read(LX_);
+    state.Read(WY_);
+    state.Read(WX_);
+    state.Read(LYC_);
+    state.Read(statInterruptSelect_);
+    state.Read(lcdc);
+    SetLCDCRegister(lcdc);
+    state.Read(mode_);
+    state.Read(tickTracker_);
+    state.Read(oam_);
+    state.Read(dmaSource_);
+    state.Read(dmaEvent_);
+    state.Read(dmaActive_);
+    state.ReadBytes(colorPalette_, sizeof(colorPalette_));
+    state.Read(pixelTransferBackgroundState_);
+
+    // The completion event comes back with the scheduler, the bus lock has to follow it
+    if (dmaWasActive != dmaActive_) {
+        if (dmaActive_) {
+            bus_->AddAddressOverride(this, {0x0000, kOAMStart + kOAMSize - 1});
+        } else {
+            bus_->RemoveAddressOverrides(this);
+        }
+    }
+}
+
+void PPU::startDMA(std::uint8_t source)
+{
+    auto& scheduler = bus_->GetScheduler();
+    if (dmaActive_) {
+        // Restarting only moves the completion
+        scheduler.Cancel(dmaEvent_);
+    } else {
+        bus_->AddAddressOverride(this, {0x0000, kOAMStart + kOAMSize - 1});
+    }
+
+    dmaSource_ = source;
+    dmaActive_ = true;
+    dmaEvent_ = scheduler.Schedule(kDMACycles, [this]() { completeDMA(); });
+}
+
+void PPU::completeDMA()
+{
+    bus_->RemoveAddressOverrides(this);
+    dmaActive_ = false;
+
+    // The whole transfer lands at once, sources above WRAM read its echo
+    std::uint16_t source = dmaSource_ << 8;
+    if (source >= 0xFE00) {
+        source -= 0x2000;
+    }
+    bus_->ReadBlock(source, oam_);
+}
+
 void PPU::handleOAM()
 {
     if (tickTracker_ < 80) [[likely]] {
@@ -54,7 +214,7 @@ void PPU::handleOAM()
     }
 
     LX_ = 0;
-    mode_ = PPUMode::PixelTransfer;
+    setMode(PPUMode::PixelTransfer);
 
     spriteFIFO_.Clear();
     bgFIFO_.Clear();
@@ -82,7 +242,7 @@ void PPU::handlePixelTransfer()
     ++LX_;
 
     if (LX_ >= 160) {
-        mode_ = PPUMode::HBlank;
+        setMode(PPUMode::HBlank);
     }
 }
 
@@ -103,7 +263,7 @@ void PPU::handlePixelTransferBackground() noexcept
         // Optimized fallthrough
         break;
     case 3:
-        pixelTransferBackgroundState_.tileDataLow = bus_->Read<std::uint8_t>(
+        pixelTransferBackgroundState_.tileDataLow = readVRAM(
             pixelTransferBackgroundState_.tileMapAddress +
             pixelTransferBackgroundState_.tileLine);
         break;
@@ -111,7 +271,7 @@ void PPU::handlePixelTransferBackground() noexcept
         // Optimized fallthrough
         break;
     case 5:
-        pixelTransferBackgroundState_.tileDataHigh = bus_->Read<std::uint8_t>(
+        pixelTransferBackgroundState_.tileDataHigh = readVRAM(
             pixelTransferBackgroundState_.tileMapAddress +
             pixelTransferBackgroundState_.tileLine + 1);
         break;
@@ -138,13 +298,14 @@ void PPU::handleHBlank()
     if (tickTracker_ < 456) [[likely]] {
         return;
     }
-    LY_++;
+    setLY(LY_ + 1);
     tickTracker_ = 0;
 
     if (LY_ >= 144) {
-        mode_ = PPUMode::VBlank;
+        CompleteFrame();
+        setMode(PPUMode::VBlank);
     } else {
-        mode_ = PPUMode::OAM;
+        setMode(PPUMode::OAM);
     }
 }
 
@@ -153,12 +314,13 @@ void PPU::handleVBlank()
     if (tickTracker_ < 456) [[likely]] {
         return;
     }
-    LY_++;
     tickTracker_ = 0;
 
-    if (LY_ >= 153) {
-        LY_ = 0;
-        mode_ = PPUMode::OAM;
+    if (LY_ + 1 >= 153) {
+        setLY(0);
+        setMode(PPUMode::OAM);
+    } else {
+        setLY(LY_ + 1);
     }
 }
 
@@ -170,7 +332,7 @@ std::uint16_t PPU::calculateTileMapAddress(std::uint16_t tileMapAddress) const n
 
     // Calculate the tile map address
     std::uint16_t tileNumber = (tileY * 32) + tileX;
-    std::uint16_t tileDataNumber = bus_->Read<std::uint8_t>(tileMapAddress + tileNumber);
+    std::uint16_t tileDataNumber = readVRAM(tileMapAddress + tileNumber);
 
     // Use the addressing mode to calculate the tile map address
     if (bgWindowTileDataAddressingMode_) {
@@ -2,7 +2,13 @@
 
 #include <components/bus.h>
 #include <components/display.h>
+#include <components/log.h>
 
+#include <array>
+#include <cstring>
+#include <span>
+
+#include "interrupts.h"
 #include "names.h"
 
 namespace emulator::gameboy
@@ -111,6 +117,19 @@ private:
     std::uint8_t SCY_, SCX_;
     std::uint8_t LY_, LX_;
     std::uint8_t WY_, WX_;
+    std::uint8_t LYC_{0};
+
+    // STAT interrupt sources (bits 3-6), mode and LYC == LY are derived
+    std::uint8_t statInterruptSelect_{0};
+
+    InterruptController* interrupts_{nullptr};
+
+    // The PPU has its own path to VRAM, unaffected by DMA locking the CPU bus
+    emulator::component::IComponent* vram_{nullptr};
+    std::uint8_t readVRAM(std::uint16_t address) const
+    {
+        return vram_ != nullptr ? vram_->ReadUInt8(address) : bus_->Read<std::uint8_t>(address);
+    }
 
     bool ldcEnabled_{false};
 
@@ -137,6 +156,19 @@ private:
     PPUMode mode_;
     std::size_t tickTracker_;
 
+    static constexpr std::uint16_t kOAMStart = 0xFE00;
+    static constexpr std::size_t kOAMSize = 0xA0;
+    std::array<std::uint8_t, kOAMSize> oam_{};
+
+    // OAM DMA moves one byte per M-cycle, until it completes the CPU only reaches HRAM and I/O
+    static constexpr emulator::component::Scheduler::Cycle kDMACycles = kOAMSize * 4;
+    std::uint8_t dmaSource_{0xFF};
+    emulator::component::Scheduler::EventID dmaEvent_{0};
+    bool dmaActive_{false};
+
+    void startDMA(std::uint8_t source);
+    void completeDMA();
+
     const Pixel kColorPaletteWhite_{0xFF, 0xFF, 0xFF, 0xFF};
     const Pixel kColorPaletteLightGray_{0x55, 0x55, 0x55, 0xFF};
     const Pixel kColorPaletteDarkGray_{0xAA, 0xAA, 0xAA, 0xFF};
@@ -148,6 +180,15 @@ private:
         kColorPaletteWhite_,
     };
 
+    void setMode(PPUMode mode) noexcept;
+    void setLY(std::uint8_t ly) noexcept;
+    void requestInterrupt(InterruptController::Interrupt interrupt) noexcept
+    {
+        if (interrupts_ != nullptr) {
+            interrupts_->Request(interrupt);
+        }
+    }
+
     void handleOAM();
     void handlePixelTransfer();
 
@@ -193,16 +234,82 @@ private:
         bgDisplayEnabled_ = (val & 0x01) != 0;
     }
 
+    std::uint8_t GetSTATRegister() const noexcept
+    {
+        return 0x80 |
+               statInterruptSelect_ |
+               ((LY_ == LYC_) << 2) |
+               static_cast<std::uint8_t>(mode_);
+    }
+
 public:
     PPU();
 
     void AttachToBus(emulator::component::Bus* bus) override;
 
+    void SetInterruptController(InterruptController* interrupts) noexcept
+    {
+        interrupts_ = interrupts;
+    }
+
+    void SetVRAM(emulator::component::IComponent* vram) noexcept
+    {
+        vram_ = vram;
+    }
+
     void ReceiveTick() override;
 
+    bool IsTickable() const noexcept override
+    {
+        return true;
+    }
+
+    std::uint64_t IdleCycles() const noexcept override;
+    void SkipCycles(std::uint64_t cycles) noexcept override;
+
+    void PowerOn() noexcept override;
+
+    void SaveState(emulator::component::StateWriter& state) const override;
+    void LoadState(emulator::component::StateReader& state) override;
+
+    bool DMAActive() const noexcept
+    {
+        return dmaActive_;
+    }
+
+    const std::array<std::uint8_t, kOAMSize>& GetOAM() const noexcept
+    {
+        return oam_;
+    }
+
+    void ReadBlock(std::size_t address, std::span<std::uint8_t> data) override
+    {
+        if (!dmaActive_ && address >= kOAMStart && address + data.size() <= kOAMStart + kOAMSize) {
+            std::memcpy(data.data(), oam_.data() + (address - kOAMStart), data.size());
+        } else {
+            Display::ReadBlock(address, data);
+        }
+    }
+
+    void WriteBlock(std::size_t address, std::span<const std::uint8_t> data) override
+    {
+        if (!dmaActive_ && address >= kOAMStart && address + data.size() <= kOAMStart + kOAMSize) {
+            std::memcpy(oam_.data() + (address - kOAMStart), data.data(), data.size());
+        } else {
+            Display::WriteBlock(address, data);
+        }
+    }
+
     void WriteUInt8(std::size_t address, std::uint8_t value) override
     {
-        if (address == 0xFF42) {
+        // Below OAM is only routed here while DMA locks the bus
+        if (address < kOAMStart + kOAMSize) {
+            if (!dmaActive_ && address >= kOAMStart) {
+                oam_[address - kOAMStart] = value;
+            }
+        } else if (address == 0xFF41) {
+            statInterruptSelect_ = value & 0b01111000;
+        } else if (address == 0xFF42) {
             SCY_ = value;
         } else if (address == 0xFF43) {
             SCX_ = value;
@@ -214,7 +321,9 @@ public:
              */
             LY_ = value;
         } else if (address == 0xFF45) {
-            LY_ = value;
+            LYC_ = value;
+        } else if (address == 0xFF46) {
+            startDMA(value);
         } else if (address == 0xFF47) {
             // This register assigns gray shades to the color IDs of the BG and Window tiles
             for (std::size_t i = 0; i < 4; ++i) {
@@ -240,24 +349,32 @@ public:
         } else if (address == 0xFF4B) {
             WX_ = value;
         } else {
-            spdlog::error("PPU: Write to unhandled address: 0x{0:X}", address);
+            EMU_ERROR_LIMITED(PPU, "PPU: Write to unhandled address: 0x{0:X}", address);
         }
     }
 
     std::uint8_t ReadUInt8(std::size_t address) override
     {
-        if (address == 0xFF42) {
+        if (address < kOAMStart + kOAMSize) {
+            return dmaActive_ || address < kOAMStart ? 0xFF : oam_[address - kOAMStart];
+        } else if (address == 0xFF41) {
+            return GetSTATRegister();
+        } else if (address == 0xFF42) {
             return SCY_;
         } else if (address == 0xFF43) {
             return SCX_;
         } else if (address == 0xFF44) {
             return LY_;
+        } else if (address == 0xFF45) {
+            return LYC_;
+        } else if (address == 0xFF46) {
+            return dmaSource_;
         } else if (address == 0xFF4A) {
             return WY_;
         } else if (address == 0xFF4B) {
             return WX_;
         } else {
-            spdlog::error("PPU: Read from unhandled address: {0:x}", address);
+            EMU_ERROR_LIMITED(PPU, "PPU: Read from unhandled address: 0x{0:X}", address);
         }
         return 0;
     }
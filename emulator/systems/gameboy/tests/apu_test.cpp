@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <components/bus.h>
+
+#include "apu.h"
+
+using emulator::gameboy::APU;
+
+class GameBoyAPU : public ::testing::Test
+{
+protected:
+    emulator::component::Bus bus_;
+    APU* apu_;
+
+    virtual void SetUp()
+    {
+        apu_ = new APU();
+        bus_.AddComponent(apu_);
+        bus_.PowerOn();
+    }
+
+    void Tick(std::size_t cycles)
+    {
+        for (std::size_t i = 0; i < cycles; i++) {
+            bus_.ReceiveTick();
+        }
+    }
+
+    void Write(std::uint16_t address, std::uint8_t value)
+    {
+        bus_.Write<std::uint8_t>(address, value);
+    }
+
+    std::uint8_t Read(std::uint16_t address)
+    {
+        return bus_.Read<std::uint8_t>(address);
+    }
+
+    // Channel 1 at 1024Hz, 50% duty, full volume on both sides
+    void PlaySquare()
+    {
+        Write(0xFF26, 0x80);
+        Write(0xFF24, 0x77);
+        Write(0xFF25, 0xFF);
+        Write(0xFF11, 0x80);
+        Write(0xFF12, 0xF0);
+        Write(0xFF13, 0x80);
+        Write(0xFF14, 0x87); // 2048 - 128
+    }
+
+    std::vector<APU::Sample> ReadAll()
+    {
+        std::vector<APU::Sample> samples(apu_->GetBufferedSamples());
+        samples.resize(apu_->ReadSamples(samples));
+        return samples;
+    }
+};
+
+// Test registers are ignored while powered off and read back with their unused bits set
+TEST_F(GameBoyAPU, Registers)
+{
+    ASSERT_EQ(Read(0xFF26), 0x70);
+    Write(0xFF24, 0x77);
+    ASSERT_EQ(Read(0xFF24), 0x00);
+
+    // Wave RAM is always accessible
+    Write(0xFF30, 0x12);
+    ASSERT_EQ(Read(0xFF30), 0x12);
+
+    Write(0xFF26, 0x80);
+    Write(0xFF24, 0x77);
+    Write(0xFF11, 0x80);
+    ASSERT_EQ(Read(0xFF26), 0xF0);
+    ASSERT_EQ(Read(0xFF24), 0x77);
+    ASSERT_EQ(Read(0xFF11), 0xBF);
+    ASSERT_EQ(Read(0xFF15), 0xFF);
+    ASSERT_EQ(Read(0xFF27), 0xFF);
+
+    // Powering off clears them
+    Write(0xFF26, 0x00);
+    Write(0xFF26, 0x80);
+    ASSERT_EQ(Read(0xFF24), 0x00);
+    ASSERT_EQ(Read(0xFF30), 0x12);
+}
+
+// Test samples arrive at the host rate and follow the channel frequency
+TEST_F(GameBoyAPU, SquareWave)
+{
+    PlaySquare();
+    ASSERT_EQ(Read(0xFF26), 0xF1);
+
+    // A tenth of a second
+    Tick(APU::kFrameSequencerPeriod * 51);
+    auto samples = ReadAll();
+    ASSERT_NEAR(samples.size(), APU::kDefaultSampleRate / 10, 100);
+
+    // Both edges of every period cross zero once the DC filter settles
+    int crossings = 0;
+    for (std::size_t i = 1; i < samples.size(); i++) {
+        crossings += (samples[i - 1] < 0) != (samples[i] < 0);
+    }
+    ASSERT_NEAR(crossings, 2 * 102, 10);
+}
+
+// Test the length counter ends a channel on the frame sequencer
+TEST_F(GameBoyAPU, Length)
+{
+    PlaySquare();
+    Write(0xFF11, 0xBE); // 2 steps
+    Write(0xFF14, 0xC7);
+    ASSERT_TRUE(apu_->ChannelEnabled(0));
+
+    // Length is clocked on every other step
+    Tick(APU::kFrameSequencerPeriod * 2);
+    ASSERT_TRUE(apu_->ChannelEnabled(0));
+    Tick(APU::kFrameSequencerPeriod);
+    ASSERT_FALSE(apu_->ChannelEnabled(0));
+    ASSERT_EQ(Read(0xFF26), 0xF0);
+}
+
+// Test a WAV dump holds every sample produced
+TEST_F(GameBoyAPU, WavDump)
+{
+    auto path = std::filesystem::temp_directory_path() / "gameboy_apu_test.wav";
+    apu_->StartWav(path.string());
+    PlaySquare();
+    Tick(APU::kFrameSequencerPeriod * 10);
+    apu_->StopWav();
+
+    auto samples = ReadAll();
+    ASSERT_GT(samples.size(), 0);
+    ASSERT_EQ(std::filesystem::file_size(path), 44 + samples.size() * sizeof(APU::Sample));
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> header(44);
+    file.read(header.data(), header.size());
+    ASSERT_EQ(std::string(header.data(), 4), "RIFF");
+    ASSERT_EQ(std::string(header.data() + 8, 4), "WAVE");
+
+    std::vector<APU::Sample> written(samples.size());
+    file.read(reinterpret_cast<char*>(written.data()), written.size() * sizeof(APU::Sample));
+    ASSERT_EQ(written, samples);
+
+    std::filesystem::remove(path);
+}
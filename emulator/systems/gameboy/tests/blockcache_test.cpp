@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::gameboy::CPU;
+
+class GameBoyBlockCache : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    CPU* cpu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        cpu_ = reinterpret_cast<CPU*>(system_->GetComponent(emulator::gameboy::kCPUName));
+
+        system_->GetBus().PowerOn();
+
+        cpu_->SetRegister<CPU::Registers::PC>(0xC000);
+        cpu_->SetRegister<CPU::Registers::SP>(0xFFFE);
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void LoadData(std::vector<std::uint8_t> data)
+    {
+        auto& bus = system_->GetBus();
+        for (std::size_t i = 0; i < data.size(); i++) {
+            bus.Write<std::uint8_t>(0xC000 + i, data[i]);
+        }
+    }
+};
+
+// Test loop iterations after the first are replayed from the cache
+TEST_F(GameBoyBlockCache, LoopReplayed)
+{
+    auto& bus = system_->GetBus();
+
+    // LD B, 10; DEC B; JR NZ, -3; NOP
+    LoadData({0x06, 0x0A, 0x05, 0x20, 0xFD, 0x00});
+
+    for (int i = 0; i < 1000 && cpu_->GetRegister<CPU::Registers::PC>() < 0xC006; i++) {
+        bus.ReceiveTick();
+    }
+
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC006);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 0);
+
+    auto& stats = cpu_->GetBlockCache().GetStats();
+    // Loop body is decoded on the first of its 9 entries
+    ASSERT_EQ(stats.hits, 8);
+    ASSERT_EQ(stats.invalidations, 0);
+}
+
+// Test writing over cached code decodes the new instruction
+TEST_F(GameBoyBlockCache, SelfModifyingCode)
+{
+    auto& bus = system_->GetBus();
+
+    // LD A, 1; LD HL, 0xC000; LD (HL), 0x06; JP 0xC000
+    LoadData({0x3E, 0x01, 0x21, 0x00, 0xC0, 0x36, 0x06, 0xC3, 0x00, 0xC0});
+    cpu_->SetRegister<CPU::Registers::B>(0);
+
+    // Second pass runs LD B, 1
+    for (int i = 0; i < 1000 && cpu_->GetRegister<CPU::Registers::B>() == 0; i++) {
+        bus.ReceiveTick();
+    }
+
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::A>(), 0x01);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 0x01);
+    ASSERT_GE(cpu_->GetBlockCache().GetStats().invalidations, 1);
+}
@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::gameboy::CPU;
+
+class GameBoyDebugger : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    emulator::debugger::ISystemDebugger* debugger_;
+    CPU* cpu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        debugger_ = system_->GetDebugger();
+        cpu_ = reinterpret_cast<CPU*>(system_->GetComponent(emulator::gameboy::kCPUName));
+
+        system_->GetBus().PowerOn();
+
+        cpu_->SetRegister<CPU::Registers::PC>(0xC000);
+        cpu_->SetRegister<CPU::Registers::SP>(0xFFFE);
+
+        // NOPs
+        auto& bus = system_->GetBus();
+        for (std::uint16_t i = 0; i < 0x10; i++) {
+            bus.Write<std::uint8_t>(0xC000 + i, 0x00);
+        }
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void Tick(std::size_t ticks)
+    {
+        auto& bus = system_->GetBus();
+        for (std::size_t i = 0; i < ticks; i++) {
+            bus.ReceiveTick();
+        }
+    }
+};
+
+// Test the CPU runs freely when no debugger is attached, even though it starts stopped
+TEST_F(GameBoyDebugger, Detached)
+{
+    ASSERT_TRUE(debugger_->IsStopped());
+
+    Tick(16);
+    ASSERT_GT(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+}
+
+// Test stepping stops after the requested instructions and reports completion
+TEST_F(GameBoyDebugger, Step)
+{
+    system_->UseDebugger();
+
+    Tick(16);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+
+    bool completed = false;
+    debugger_->StepCPU(3, [&completed]() { completed = true; });
+    ASSERT_FALSE(debugger_->IsStopped());
+
+    Tick(64);
+    ASSERT_TRUE(completed);
+    ASSERT_TRUE(debugger_->IsStopped());
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC003);
+
+    // Detaching lets the CPU run regardless
+    system_->UseDebugger(false);
+    Tick(16);
+    ASSERT_GT(cpu_->GetRegister<CPU::Registers::PC>(), 0xC003);
+}
+
+// Test a parked thread times out while stopped and wakes when resumed
+TEST_F(GameBoyDebugger, ParkAndResume)
+{
+    system_->UseDebugger();
+
+    ASSERT_TRUE(debugger_->WaitWhileStopped(std::chrono::milliseconds(1)));
+
+    std::thread resumer([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        debugger_->RunCPU();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_FALSE(debugger_->WaitWhileStopped(std::chrono::seconds(10)));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    resumer.join();
+
+    ASSERT_FALSE(debugger_->WaitWhileStopped(std::chrono::milliseconds(1)));
+}
+
+// Test the memory map follows the bus in order and debugger writes reach work RAM
+TEST_F(GameBoyDebugger, MemoryMap)
+{
+    auto regions = debugger_->GetMemoryMap();
+    ASSERT_FALSE(regions.empty());
+    for (std::size_t i = 1; i < regions.size(); i++) {
+        ASSERT_GE(regions[i].start, regions[i - 1].start + regions[i - 1].length);
+    }
+
+    auto wram = std::find_if(regions.begin(), regions.end(), [](const auto& region) {
+        return region.start <= 0xC000 && 0xC000 < region.start + region.length;
+    });
+    ASSERT_NE(wram, regions.end());
+    ASSERT_EQ(wram->type, emulator::debugger::MemoryRegion::Type::RAM);
+
+    std::uint8_t data[] = {0xDE, 0xAD};
+    ASSERT_TRUE(debugger_->WriteMemory(0xC100, data));
+    std::uint8_t read[2] = {};
+    ASSERT_EQ(debugger_->ReadMemory(0xC100, read), 2);
+    ASSERT_EQ(read[1], 0xAD);
+}
+
+// Test a conditional breakpoint in a loop only stops once its condition holds
+TEST_F(GameBoyDebugger, ConditionalBreakpoint)
+{
+    // INC B; JR -3
+    auto& bus = system_->GetBus();
+    bus.Write<std::uint8_t>(0xC000, 0x04);
+    bus.Write<std::uint8_t>(0xC001, 0x18);
+    bus.Write<std::uint8_t>(0xC002, 0xFD);
+    cpu_->SetRegister<CPU::Registers::B>(0);
+
+    system_->UseDebugger();
+    debugger_->AddBreakpoint(0xC000, "B == 50 && [0xC001] == 0x18");
+    ASSERT_THROW(debugger_->AddBreakpoint(0xC000, "Q == 1"), std::invalid_argument);
+
+    bool stopped = false;
+    debugger_->RunCPU([&stopped]() { stopped = true; });
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_TRUE(debugger_->IsStopped());
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 50);
+
+    // Continuing runs the loop past the breakpoint until B wraps around to 50 again
+    stopped = false;
+    debugger_->RunCPU([&stopped]() { stopped = true; });
+    Tick(100);
+    ASSERT_FALSE(stopped);
+    ASSERT_GT(cpu_->GetRegister<CPU::Registers::B>(), 50);
+
+    debugger_->RemoveBreakpoint(0xC000);
+    Tick(100000);
+    ASSERT_FALSE(stopped);
+}
+
+// Test restoring a snapshot puts back the registers, memory and cycle it was taken at
+TEST_F(GameBoyDebugger, Snapshot)
+{
+    // INC B; LD (HL), B; JR -4
+    auto& bus = system_->GetBus();
+    bus.Write<std::uint8_t>(0xC000, 0x04);
+    bus.Write<std::uint8_t>(0xC001, 0x70);
+    bus.Write<std::uint8_t>(0xC002, 0x18);
+    bus.Write<std::uint8_t>(0xC003, 0xFC);
+    cpu_->SetRegister<CPU::Registers::HL>(0xC100);
+
+    Tick(1000);
+    auto snapshot = system_->SaveSnapshot();
+    auto now = bus.GetScheduler().Now();
+    auto b = cpu_->GetRegister<CPU::Registers::B>();
+    auto pc = cpu_->GetRegister<CPU::Registers::PC>();
+    auto instructions = cpu_->GetInstructionCount();
+    auto stored = bus.Read<std::uint8_t>(0xC100);
+
+    Tick(1000);
+    ASSERT_NE(cpu_->GetRegister<CPU::Registers::B>(), b);
+
+    system_->RestoreSnapshot(snapshot);
+    ASSERT_EQ(bus.GetScheduler().Now(), now);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), b);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), pc);
+    ASSERT_EQ(cpu_->GetInstructionCount(), instructions);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xC100), stored);
+
+    // Running again from the snapshot follows the same path
+    Tick(1000);
+    auto replayed = cpu_->GetRegister<CPU::Registers::B>();
+    system_->RestoreSnapshot(snapshot);
+    Tick(1000);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), replayed);
+}
+
+// Test stepping and continuing backwards through recorded history
+TEST_F(GameBoyDebugger, ReverseExecution)
+{
+    // INC B; JR -3
+    auto& bus = system_->GetBus();
+    bus.Write<std::uint8_t>(0xC000, 0x04);
+    bus.Write<std::uint8_t>(0xC001, 0x18);
+    bus.Write<std::uint8_t>(0xC002, 0xFD);
+    cpu_->SetRegister<CPU::Registers::B>(0);
+
+    ASSERT_TRUE(debugger_->SupportsReverse());
+    debugger_->EnableHistory(10, 64);
+    system_->UseDebugger();
+    debugger_->AddBreakpoint(0xC000, "B == 50");
+
+    bool stopped = false;
+    auto stop = [&stopped]() { stopped = true; };
+    debugger_->RunCPU(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 50);
+    auto instructions = cpu_->GetInstructionCount();
+
+    // Back over the JR, then the INC B
+    stopped = false;
+    debugger_->ReverseStep(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_FALSE(debugger_->IsReplaying());
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC001);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 50);
+    ASSERT_EQ(cpu_->GetInstructionCount(), instructions - 1);
+
+    stopped = false;
+    debugger_->ReverseStep(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 49);
+
+    // Continuing backwards stops at the latest earlier hit, several checkpoints back
+    debugger_->AddBreakpoint(0xC000, "B == 20");
+    stopped = false;
+    debugger_->ReverseContinue(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_FALSE(debugger_->AtHistoryStart());
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 20);
+
+    // Nothing earlier, so it stops where history begins
+    stopped = false;
+    debugger_->ReverseContinue(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_TRUE(debugger_->AtHistoryStart());
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC000);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 0);
+
+    // Running forwards again reaches the same state
+    debugger_->AddBreakpoint(0xC000, "B == 50");
+    stopped = false;
+    debugger_->RunCPU(stop);
+    Tick(100000);
+    ASSERT_TRUE(stopped);
+    ASSERT_FALSE(debugger_->AtHistoryStart());
+    ASSERT_EQ(cpu_->GetInstructionCount(), instructions);
+}
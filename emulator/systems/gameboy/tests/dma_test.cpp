@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "names.h"
+#include "ppu.h"
+
+using emulator::gameboy::PPU;
+
+class GameBoyDMA : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    PPU* ppu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        ppu_ = reinterpret_cast<PPU*>(system_->GetComponent(emulator::gameboy::kDisplayName));
+        system_->PowerOn();
+
+        auto& bus = system_->GetBus();
+        for (std::size_t i = 0; i < 0xA0; i++) {
+            bus.Write<std::uint8_t>(0xC100 + i, std::uint8_t(i + 1));
+        }
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+};
+
+// Test the copy lands in OAM once, 160 M-cycles after the write
+TEST_F(GameBoyDMA, CopiesOnCompletion)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    bus.Write<std::uint8_t>(0xFF46, 0xC1);
+    ASSERT_TRUE(ppu_->DMAActive());
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF46), 0xC1);
+
+    scheduler.Advance(160 * 4 - 1);
+    ASSERT_TRUE(ppu_->DMAActive());
+    ASSERT_EQ(ppu_->GetOAM()[0], 0);
+
+    scheduler.Advance(1);
+    ASSERT_FALSE(ppu_->DMAActive());
+    for (std::size_t i = 0; i < 0xA0; i++) {
+        ASSERT_EQ(ppu_->GetOAM()[i], i + 1);
+        ASSERT_EQ(bus.Read<std::uint8_t>(0xFE00 + i), i + 1);
+    }
+}
+
+// Test the CPU side of the bus only reaches HRAM and I/O during the transfer
+TEST_F(GameBoyDMA, LocksBus)
+{
+    auto& bus = system_->GetBus();
+    bus.Write<std::uint8_t>(0xFF80, 0x12);
+    bus.Write<std::uint8_t>(0xFF46, 0xC1);
+
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xC100), 0xFF);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFE00), 0xFF);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0x0000), 0xFF);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF80), 0x12);
+
+    // Writes outside HRAM are dropped
+    bus.Write<std::uint8_t>(0xC100, 0x55);
+    bus.Write<std::uint8_t>(0xFF81, 0x34);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF81), 0x34);
+
+    bus.GetScheduler().Advance(160 * 4);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xC100), 0x01);
+    ASSERT_EQ(ppu_->GetOAM()[0], 0x01);
+}
+
+// Test writing the register again restarts the transfer from the new source
+TEST_F(GameBoyDMA, Restart)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    bus.Write<std::uint8_t>(0xFF46, 0xC0);
+    scheduler.Advance(100);
+    bus.Write<std::uint8_t>(0xFF46, 0xC1);
+
+    scheduler.Advance(160 * 4 - 1);
+    ASSERT_TRUE(ppu_->DMAActive());
+    scheduler.Advance(1);
+    ASSERT_FALSE(ppu_->DMAActive());
+    ASSERT_EQ(ppu_->GetOAM()[0], 0x01);
+}
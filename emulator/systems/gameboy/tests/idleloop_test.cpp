@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::gameboy::CPU;
+
+class GameBoyIdleLoop : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    CPU* cpu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        cpu_ = reinterpret_cast<CPU*>(system_->GetComponent(emulator::gameboy::kCPUName));
+
+        system_->GetBus().PowerOn();
+
+        cpu_->SetRegister<CPU::Registers::PC>(0xC000);
+        cpu_->SetRegister<CPU::Registers::SP>(0xFFFE);
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void LoadData(std::vector<std::uint8_t> data)
+    {
+        auto& bus = system_->GetBus();
+        for (std::size_t i = 0; i < data.size(); i++) {
+            bus.Write<std::uint8_t>(0xC000 + i, data[i]);
+        }
+    }
+};
+
+// Test polling LY is skipped ahead and still exits on the expected line
+TEST_F(GameBoyIdleLoop, PollLY)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    // LDH A, (0x44); CP 0x90; JR NZ, -6; NOP
+    LoadData({0xF0, 0x44, 0xFE, 0x90, 0x20, 0xFA, 0x00});
+
+    std::size_t ticks = 0;
+    while (cpu_->GetRegister<CPU::Registers::PC>() < 0xC007 && scheduler.Now() < 70224) {
+        bus.ReceiveTick();
+        ++ticks;
+    }
+
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC007);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::A>(), 0x90);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF44), 0x90);
+
+    ASSERT_EQ(cpu_->GetIdleStats().idleLoopsDetected, 1);
+    ASSERT_GT(cpu_->GetIdleStats().idleLoopCycles, 0);
+    ASSERT_LT(ticks, scheduler.Now());
+}
+
+// Test a JR -2 spin waits for the interrupt without ticking every cycle
+TEST_F(GameBoyIdleLoop, SpinUntilInterrupt)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    // EI; JR -2
+    LoadData({0xFB, 0x18, 0xFE});
+    bus.Write<std::uint8_t>(0xFFFF, 0x01);
+
+    while (cpu_->GetRegister<CPU::Registers::PC>() >= 0xC000 && scheduler.Now() < 70224) {
+        bus.ReceiveTick();
+    }
+
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0x40);
+    ASSERT_GE(scheduler.Now(), 144 * 456);
+    ASSERT_GT(cpu_->GetIdleStats().idleLoopCycles, 0);
+}
+
+// Test loops with side effects are executed normally
+TEST_F(GameBoyIdleLoop, SideEffectsNotSkipped)
+{
+    auto& bus = system_->GetBus();
+
+    // INC B; JR -3
+    LoadData({0x04, 0x18, 0xFD});
+
+    for (int i = 0; i < 100 * CPU::TCycleToMCycle; i++) {
+        bus.ReceiveTick();
+    }
+
+    ASSERT_EQ(cpu_->GetIdleStats().idleLoopsDetected, 0);
+    ASSERT_EQ(cpu_->GetIdleStats().idleLoopCycles, 0);
+    ASSERT_EQ(bus.GetSkippedCycles(), 0);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::B>(), 25);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::gameboy::CPU;
+using emulator::gameboy::InterruptController;
+
+class GameBoyInterrupts : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    CPU* cpu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        cpu_ = reinterpret_cast<CPU*>(system_->GetComponent(emulator::gameboy::kCPUName));
+
+        system_->GetBus().PowerOn();
+
+        cpu_->SetRegister<CPU::Registers::PC>(0xC000);
+        cpu_->SetRegister<CPU::Registers::SP>(0xFFFE);
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void LoadData(std::vector<std::uint8_t> data)
+    {
+        auto& bus = system_->GetBus();
+        for (std::size_t i = 0; i < data.size(); i++) {
+            bus.Write<std::uint8_t>(0xC000 + i, data[i]);
+        }
+    }
+};
+
+// Test TIMA overflow reloads TMA and requests the timer interrupt
+TEST_F(GameBoyInterrupts, TimerOverflow)
+{
+    auto& bus = system_->GetBus();
+    auto& interrupts = cpu_->GetInterruptController();
+    LoadData({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+
+    bus.Write<std::uint8_t>(0xFF06, 0x10); // TMA
+    bus.Write<std::uint8_t>(0xFF05, 0xFE); // TIMA
+    bus.Write<std::uint8_t>(0xFF07, 0x05); // TAC, enabled @ 16 cycles
+
+    for (int i = 0; i < 31; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF05), 0xFF);
+    ASSERT_FALSE(interrupts.IsRequested(InterruptController::Interrupt::Timer));
+
+    bus.ReceiveTick();
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF05), 0x10);
+    ASSERT_TRUE(interrupts.IsRequested(InterruptController::Interrupt::Timer));
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF0F) & 0x04, 0x04);
+}
+
+// Test HALT skips idle cycles and dispatches VBlank once it is raised
+TEST_F(GameBoyInterrupts, HaltUntilVBlank)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    // EI; HALT; NOP
+    LoadData({0xFB, 0x76, 0x00});
+    bus.Write<std::uint8_t>(0xFFFF, 0x01);
+
+    std::size_t ticks = 0;
+    while (cpu_->GetRegister<CPU::Registers::PC>() >= 0xC000 && scheduler.Now() < 70224) {
+        bus.ReceiveTick();
+        ++ticks;
+    }
+
+    // Vector 0x40 reached after line 144 started
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0x40);
+    ASSERT_GE(scheduler.Now(), 144 * 456);
+    ASSERT_FALSE(cpu_->IsHalted());
+    ASSERT_FALSE(cpu_->InterruptsEnabled());
+
+    // Return address is the instruction after HALT
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::SP>(), 0xFFFC);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFFFC), 0x02);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFFFD), 0xC0);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF0F) & 0x01, 0);
+
+    // Most of the wait was skipped rather than ticked
+    ASSERT_GT(bus.GetSkippedCycles(), 0);
+    ASSERT_LT(ticks, scheduler.Now());
+}
+
+// Test HALT with IME disabled resumes without dispatching the interrupt
+TEST_F(GameBoyInterrupts, HaltWithoutIME)
+{
+    auto& bus = system_->GetBus();
+    auto& scheduler = bus.GetScheduler();
+
+    // HALT; NOP; NOP
+    LoadData({0x76, 0x00, 0x00});
+    bus.Write<std::uint8_t>(0xFFFF, 0x04);
+    bus.Write<std::uint8_t>(0xFF05, 0xF0); // TIMA
+    bus.Write<std::uint8_t>(0xFF07, 0x04); // TAC, enabled @ 1024 cycles
+
+    for (int i = 0; i < 4 * CPU::TCycleToMCycle; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_TRUE(cpu_->IsHalted());
+
+    while (cpu_->IsHalted() && scheduler.Now() < 0x20000) {
+        bus.ReceiveTick();
+    }
+    ASSERT_FALSE(cpu_->IsHalted());
+    ASSERT_GE(scheduler.Now(), 16 * 1024);
+
+    for (int i = 0; i < 2 * CPU::TCycleToMCycle; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC004);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::SP>(), 0xFFFE);
+    ASSERT_TRUE(cpu_->GetInterruptController().IsRequested(InterruptController::Interrupt::Timer));
+}
+
+// Test RETI returns to the interrupted code and re-enables interrupts
+TEST_F(GameBoyInterrupts, ReturnFromInterrupt)
+{
+    auto& bus = system_->GetBus();
+
+    // RETI at the top of the stack frame
+    LoadData({0xD9});
+    bus.Write<std::uint8_t>(0xFFFC, 0x34);
+    bus.Write<std::uint8_t>(0xFFFD, 0xC0);
+    cpu_->SetRegister<CPU::Registers::SP>(0xFFFC);
+
+    for (int i = 0; i < 5 * CPU::TCycleToMCycle; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::PC>(), 0xC035);
+    ASSERT_EQ(cpu_->GetRegister<CPU::Registers::SP>(), 0xFFFE);
+    ASSERT_TRUE(cpu_->InterruptsEnabled());
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "joypad.h"
+#include "names.h"
+
+using emulator::gameboy::Joypad;
+
+class GameBoyJoypad : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    Joypad* joypad_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        joypad_ = reinterpret_cast<Joypad*>(system_->GetComponent(emulator::gameboy::kJoypadName));
+
+        system_->GetBus().PowerOn();
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void Press(Joypad::Key key)
+    {
+        joypad_->PressKey(joypad_->GetKeys()[static_cast<std::size_t>(key)]);
+    }
+};
+
+// Test P1 reports the selected group of keys, active low
+TEST_F(GameBoyJoypad, SelectGroups)
+{
+    auto& bus = system_->GetBus();
+    ASSERT_EQ(system_->GetFirstComponentByType<emulator::component::Input>(emulator::component::IComponent::ComponentType::Input), joypad_);
+
+    Press(Joypad::Key::Left);
+    Press(Joypad::Key::Start);
+
+    // Nothing selected
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xFF);
+    ASSERT_EQ(joypad_->GetPressed(), 0b10000010);
+
+    bus.Write<std::uint8_t>(0xFF00, 0x20); // D-pad
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xED);
+
+    bus.Write<std::uint8_t>(0xFF00, 0x10); // Buttons
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xD7);
+
+    bus.Write<std::uint8_t>(0xFF00, 0x00);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xC5);
+}
+
+// Test key changes wait for the next frame
+TEST_F(GameBoyJoypad, PerFrame)
+{
+    auto& bus = system_->GetBus();
+    bus.Write<std::uint8_t>(0xFF00, 0x20);
+
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xEF);
+    Press(Joypad::Key::Right);
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xEF);
+
+    for (std::size_t i = 0; i < Joypad::kFrameCycles; i++) {
+        bus.ReceiveTick();
+    }
+    ASSERT_EQ(bus.Read<std::uint8_t>(0xFF00), 0xEE);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <components/lockstep.h>
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::component::Lockstep;
+using emulator::gameboy::CPU;
+
+class GameBoyLockstep : public ::testing::Test
+{
+protected:
+    emulator::component::System* systems_[2];
+    CPU* cpus_[2];
+
+    virtual void SetUp()
+    {
+        // Copy a block of WRAM with a self-modifying inner loop, then call a routine that patches it
+        const std::vector<std::uint8_t> program = {
+            0x06, 0x10,       // LD B, 0x10
+            0x21, 0x00, 0xC1, // LD HL, 0xC100
+            0x7E,             // LD A, (HL)
+            0x3C,             // INC A
+            0x77,             // LD (HL), A
+            0x23,             // INC HL
+            0x05,             // DEC B
+            0x20, 0xF9,       // JR NZ, -7
+            0xCD, 0x20, 0xC0, // CALL 0xC020
+            0x18, 0xEF,       // JR -17
+        };
+        const std::vector<std::uint8_t> routine = {
+            0x3E, 0x3D,       // LD A, 0x3D
+            0xEA, 0x06, 0xC0, // LD (0xC006), A
+            0xC9,             // RET
+        };
+
+        for (int i = 0; i < 2; i++) {
+            systems_[i] = CreateSystem();
+            cpus_[i] = reinterpret_cast<CPU*>(systems_[i]->GetComponent(emulator::gameboy::kCPUName));
+
+            auto& bus = systems_[i]->GetBus();
+            bus.PowerOn();
+            for (std::size_t j = 0; j < program.size(); j++) {
+                bus.Write<std::uint8_t>(0xC000 + j, program[j]);
+            }
+            for (std::size_t j = 0; j < routine.size(); j++) {
+                bus.Write<std::uint8_t>(0xC020 + j, routine[j]);
+            }
+
+            cpus_[i]->SetRegister<CPU::Registers::PC>(0xC000);
+            cpus_[i]->SetRegister<CPU::Registers::SP>(0xFFFE);
+        }
+
+        // Reference decodes every instruction
+        cpus_[0]->SetBlockCacheEnabled(false);
+    }
+
+    virtual void TearDown()
+    {
+        delete systems_[0];
+        delete systems_[1];
+    }
+};
+
+// Test the block cache agrees with decoding every instruction, including across self-modifying code
+TEST_F(GameBoyLockstep, BlockCacheMatchesReference)
+{
+    Lockstep lockstep(*systems_[0], *systems_[1], {.memoryRanges = {{0xC000, 0xC1FF}, {0xFF80, 0xFFFE}}});
+
+    auto divergence = lockstep.Run(2000);
+    ASSERT_FALSE(divergence.has_value()) << divergence->Describe();
+    ASSERT_EQ(lockstep.InstructionsCompared(), 2000);
+
+    ASSERT_EQ(cpus_[0]->GetBlockCache().GetStats().hits, 0);
+    ASSERT_GT(cpus_[1]->GetBlockCache().GetStats().hits, 0);
+    ASSERT_GT(cpus_[1]->GetBlockCache().GetStats().invalidations, 0);
+}
+
+// Test the first differing register is reported with the instructions leading up to it
+TEST_F(GameBoyLockstep, ReportsDivergence)
+{
+    systems_[1]->GetBus().Write<std::uint8_t>(0xC100, 0x55);
+
+    Lockstep lockstep(*systems_[0], *systems_[1], {.memoryRanges = {{0xC000, 0xC0FF}}, .traceWindow = 2});
+
+    // A is loaded by the 3rd instruction, visible once the 4th starts
+    auto divergence = lockstep.Run(100);
+    ASSERT_TRUE(divergence.has_value());
+    ASSERT_EQ(divergence->instruction, 4);
+    ASSERT_EQ(divergence->reason, "Register AF: reference 0x0, candidate 0x5500");
+    ASSERT_EQ(lockstep.InstructionsCompared(), 3);
+
+    ASSERT_EQ(divergence->referenceTrace.size(), 2);
+    ASSERT_EQ(divergence->candidateTrace.back().instruction, 4);
+    ASSERT_NE(divergence->Describe().find("Candidate trace:"), std::string::npos);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::gameboy::CPU;
+
+class GameBoyProfiler : public ::testing::Test
+{
+protected:
+    emulator::component::System* system_;
+    CPU* cpu_;
+
+    virtual void SetUp()
+    {
+        system_ = CreateSystem();
+        cpu_ = reinterpret_cast<CPU*>(system_->GetComponent(emulator::gameboy::kCPUName));
+
+        system_->PowerOn();
+
+        cpu_->SetRegister<CPU::Registers::PC>(0xC000);
+        cpu_->SetRegister<CPU::Registers::SP>(0xFFFE);
+
+        // INC A; JR -3
+        auto& bus = system_->GetBus();
+        bus.Write<std::uint8_t>(0xC000, 0x3C);
+        bus.Write<std::uint8_t>(0xC001, 0x18);
+        bus.Write<std::uint8_t>(0xC002, 0xFD);
+    }
+
+    virtual void TearDown()
+    {
+        delete system_;
+    }
+
+    void RunCycles(std::uint64_t cycles)
+    {
+        auto& bus = system_->GetBus();
+        auto end = bus.GetScheduler().Now() + cycles;
+        while (bus.GetScheduler().Now() < end) {
+            bus.ReceiveTick();
+        }
+    }
+};
+
+// Test samples land on the loop and stop once disabled
+TEST_F(GameBoyProfiler, SamplesProgramCounter)
+{
+    auto& profiler = system_->GetProfiler();
+    profiler.SetInterval(64);
+
+    // Nothing is recorded until enabled
+    RunCycles(64 * 4);
+    ASSERT_EQ(profiler.GetSampleCount(), 0);
+
+    profiler.SetEnabled(true);
+    profiler.Sync();
+    RunCycles(64 * 32);
+    ASSERT_EQ(profiler.GetSampleCount(), 32);
+
+    auto histogram = profiler.GetHistogram();
+    ASSERT_FALSE(histogram.empty());
+    for (auto& entry : histogram) {
+        ASSERT_EQ(entry.bank, 0);
+        ASSERT_TRUE(entry.pc == 0xC000 || entry.pc == 0xC001);
+    }
+
+    profiler.SetEnabled(false);
+    profiler.Sync();
+    RunCycles(64 * 4);
+    ASSERT_EQ(profiler.GetSampleCount(), 32);
+}
+
+// Test both export formats list every location
+TEST_F(GameBoyProfiler, Export)
+{
+    auto& profiler = system_->GetProfiler();
+    profiler.SetInterval(64);
+    profiler.SetEnabled(true);
+    profiler.Sync();
+    RunCycles(64 * 16);
+
+    auto flat = profiler.ExportFlat();
+    ASSERT_EQ(flat.rfind("# 16 samples, every 64 cycles\n", 0), 0);
+    ASSERT_NE(flat.find("00:C00"), std::string::npos);
+
+    auto collapsed = profiler.ExportCollapsed("GameBoy");
+    ASSERT_NE(collapsed.find("GameBoy;bank_00;0xC00"), std::string::npos);
+    ASSERT_EQ(std::count(collapsed.begin(), collapsed.end(), '\n'), profiler.GetHistogram().size());
+
+    profiler.Clear();
+    ASSERT_EQ(profiler.GetSampleCount(), 0);
+}
@@ -2,6 +2,16 @@
 
 #include <emulator.h>
 
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <components/audio.h>
+
+#include "apu.h"
+#include "cpu.h"
+#include "names.h"
+
 TEST(GameBoySystem, CreateSystem)
 {
     auto system = CreateSystem();
@@ -118,4 +128,80 @@ TEST(GameBoySystem, ReadWriteUpperInternalRAM)
     ASSERT_EQ(bus.Read<std::int32_t>(0xFFFF - sizeof(std::int32_t)), (std::int32_t)0xDEADC0DE);
 }
 
-// Test writing to upper internal ram
\ No newline at end of file
+// Test writing to upper internal ram
+// Run a JR -2 loop from work RAM, power on as the other system tests do
+static void PowerOnLooping(emulator::component::System* system)
+{
+    using emulator::gameboy::CPU;
+
+    auto& bus = system->GetBus();
+    bus.PowerOn();
+    bus.Write<std::uint8_t>(0xC000, 0x18);
+    bus.Write<std::uint8_t>(0xC001, 0xFE);
+
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+    cpu->SetRegister<CPU::Registers::PC>(0xC000);
+    cpu->SetRegister<CPU::Registers::SP>(0xFFFE);
+}
+
+// Test a system synced to audio runs no faster than the audio is played
+TEST(GameBoySystem, AudioSyncPacesByPlayback)
+{
+    using emulator::component::Audio;
+    using emulator::component::SystemStatus;
+
+    static constexpr auto kPlayTime = std::chrono::milliseconds(500);
+    static constexpr auto kPeriod = std::chrono::milliseconds(10);
+
+    auto system = CreateSystem();
+    auto audio = reinterpret_cast<Audio*>(system->GetComponent(emulator::gameboy::kAPUName));
+    PowerOnLooping(system);
+    system->SetAudioSync(true);
+
+    volatile SystemStatus status = SystemStatus::RUNNING;
+    std::thread runner([&] { system->Run(status); });
+
+    // Play back at the sample rate, as the audio device would
+    std::array<Audio::Sample, 1024> samples;
+    auto perPeriod = audio->GetSampleRate() * kPeriod.count() / 1000;
+    auto start = std::chrono::steady_clock::now();
+    for (auto played = std::chrono::milliseconds(0); played < kPlayTime; played += kPeriod) {
+        audio->ReadSamples(std::span(samples).first(perPeriod));
+        std::this_thread::sleep_until(start + played + kPeriod);
+    }
+    status = SystemStatus::STOPPING;
+    runner.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(system->AudioSync());
+
+    // Ahead by at most what is queued, plus slack for scheduling
+    auto emulated = std::chrono::nanoseconds(std::int64_t(system->GetBus().GetScheduler().Now() * 1000000000 / emulator::gameboy::APU::kClockRate));
+    ASSERT_LE(emulated, elapsed + std::chrono::milliseconds(Audio::kTargetLatencyMs) + std::chrono::milliseconds(50));
+
+    delete system;
+}
+
+// Test audio that is never played falls back to wall clock pacing
+TEST(GameBoySystem, AudioSyncStall)
+{
+    using emulator::component::SystemStatus;
+
+    auto system = CreateSystem();
+    PowerOnLooping(system);
+    system->SetAudioSync(true);
+
+    volatile SystemStatus status = SystemStatus::RUNNING;
+    std::thread runner([&] { system->Run(status); });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (system->AudioSync() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    status = SystemStatus::STOPPING;
+    runner.join();
+
+    ASSERT_FALSE(system->AudioSync());
+
+    delete system;
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <emulator.h>
+
+#include "cpu.h"
+#include "names.h"
+
+using emulator::component::TraceReader;
+using emulator::gameboy::CPU;
+
+// Test every instruction is recorded with the registers it started with
+TEST(GameBoyTrace, RecordsInstructions)
+{
+    auto path = (std::filesystem::temp_directory_path() / "gameboy_trace_test.bin").string();
+
+    auto system = CreateSystem();
+    auto cpu = reinterpret_cast<CPU*>(system->GetComponent(emulator::gameboy::kCPUName));
+    auto& bus = system->GetBus();
+
+    system->PowerOn();
+    cpu->SetRegister<CPU::Registers::PC>(0xC000);
+    cpu->SetRegister<CPU::Registers::SP>(0xFFFE);
+    cpu->SetRegister<CPU::Registers::B>(0);
+
+    // LD B, 3; DEC B; JR NZ, -3; BIT 0, A
+    std::vector<std::uint8_t> program = {0x06, 0x03, 0x05, 0x20, 0xFD, 0xCB, 0x47};
+    for (std::size_t i = 0; i < program.size(); i++) {
+        bus.Write<std::uint8_t>(0xC000 + i, program[i]);
+    }
+
+    system->StartTrace(path);
+    for (int i = 0; i < 1000 && cpu->GetRegister<CPU::Registers::PC>() < 0xC007; i++) {
+        bus.ReceiveTick();
+    }
+    system->StopTrace();
+    delete system;
+
+    std::ifstream file(path, std::ios::binary);
+    TraceReader reader(file);
+    auto& names = reader.RegisterNames();
+    auto bc = std::find(names.begin(), names.end(), "BC") - names.begin();
+    ASSERT_LT(bc, names.size());
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> executed;
+    std::vector<std::uint64_t> b;
+    TraceReader::Record record;
+    while (reader.Next(record)) {
+        executed.push_back({record.pc, record.opcode});
+        b.push_back(record.registers[bc] >> 8);
+    }
+    std::remove(path.c_str());
+
+    ASSERT_EQ(executed, (std::vector<std::pair<std::uint64_t, std::uint32_t>>{
+                            {0xC000, 0x06},
+                            {0xC002, 0x05},
+                            {0xC003, 0x20},
+                            {0xC002, 0x05},
+                            {0xC003, 0x20},
+                            {0xC002, 0x05},
+                            {0xC003, 0x20},
+                            {0xC005, 0xCB47},
+                        }));
+    ASSERT_EQ(b, (std::vector<std::uint64_t>{0, 3, 2, 2, 1, 1, 0, 0}));
+}
@@ -0,0 +1,153 @@
+#include "timer.h"
+
+#include <components/exceptions/AddressInUse.h>
+
+#include <array>
+
+namespace emulator::gameboy
+{
+
+Timer::Timer() : emulator::component::IComponent(ComponentType::Timer)
+{
+}
+
+Timer::~Timer()
+{
+    CancelOverflow();
+}
+
+Timer::Scheduler::Cycle Timer::Now() const noexcept
+{
+    if (bus_ == nullptr) {
+        return syncCycle_;
+    }
+    return bus_->GetScheduler().Now();
+}
+
+Timer::Scheduler::Cycle Timer::Period() const noexcept
+{
+    // 4096 Hz, 262144 Hz, 65536 Hz, 16384 Hz
+    static constexpr std::array<Scheduler::Cycle, 4> kPeriods = {1024, 16, 64, 256};
+    return kPeriods[TAC_ & 0b11];
+}
+
+void Timer::Sync() noexcept
+{
+    auto now = Now();
+    if (Enabled()) {
+        // TIMA increments on every period boundary of the system counter
+        auto period = Period();
+        auto increments = (now - divStartCycle_) / period - (syncCycle_ - divStartCycle_) / period;
+
+        auto total = TIMA_ + increments;
+        if (total > 0xFF) {
+            TIMA_ = TMA_ + (total - 0x100) % (0x100 - TMA_);
+        } else {
+            TIMA_ = static_cast<std::uint8_t>(total);
+        }
+    }
+    syncCycle_ = now;
+}
+
+void Timer::ScheduleOverflow()
+{
+    CancelOverflow();
+    if (!Enabled() || bus_ == nullptr) {
+        return;
+    }
+
+    auto period = Period();
+    auto nextIncrement = divStartCycle_ + ((syncCycle_ - divStartCycle_) / period + 1) * period;
+    auto deadline = nextIncrement + (0xFF - TIMA_) * period;
+
+    overflowEvent_ = bus_->GetScheduler().ScheduleAt(deadline, [this]() {
+        overflowEvent_ = Scheduler::kInvalidEvent;
+
+        Sync();
+        if (interrupts_ != nullptr) {
+            interrupts_->Request(InterruptController::Interrupt::Timer);
+        }
+        ScheduleOverflow();
+    });
+}
+
+void Timer::CancelOverflow() noexcept
+{
+    if (overflowEvent_ != Scheduler::kInvalidEvent && bus_ != nullptr) {
+        bus_->GetScheduler().Cancel(overflowEvent_);
+    }
+    overflowEvent_ = Scheduler::kInvalidEvent;
+}
+
+void Timer::AttachToBus(emulator::component::Bus* bus)
+{
+    if (!bus->RegisterComponentAddressRange(this, {0xFF04, 0xFF07})) {
+        throw component::AddressInUse(0xFF04, 0x4);
+    }
+    bus_ = bus;
+}
+
+void Timer::RemoveFromBus()
+{
+    CancelOverflow();
+    bus_ = nullptr;
+}
+
+void Timer::PowerOn() noexcept
+{
+    // Scheduler was reset along with the bus, any previous event is gone
+    overflowEvent_ = Scheduler::kInvalidEvent;
+
+    divStartCycle_ = Now();
+    syncCycle_ = divStartCycle_;
+    TIMA_ = 0;
+    TMA_ = 0;
+    TAC_ = 0;
+}
+
+void Timer::PowerOff() noexcept
+{
+    CancelOverflow();
+}
+
+void Timer::WriteUInt8(std::size_t address, std::uint8_t value)
+{
+    Sync();
+
+    switch (address) {
+    case 0xFF04:
+        divStartCycle_ = syncCycle_;
+        break;
+    case 0xFF05:
+        TIMA_ = value;
+        break;
+    case 0xFF06:
+        TMA_ = value;
+        return;
+    case 0xFF07:
+        TAC_ = value & 0b111;
+        break;
+    default:
+        return;
+    }
+
+    ScheduleOverflow();
+}
+
+std::uint8_t Timer::ReadUInt8(std::size_t address)
+{
+    switch (address) {
+    case 0xFF04:
+        return static_cast<std::uint8_t>((Now() - divStartCycle_) >> 8);
+    case 0xFF05:
+        Sync();
+        return TIMA_;
+    case 0xFF06:
+        return TMA_;
+    case 0xFF07:
+        return 0b11111000 | TAC_;
+    }
+    return 0;
+}
+
+}; // namespace emulator::gameboy
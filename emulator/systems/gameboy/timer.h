@@ -0,0 +1,113 @@
+#pragma once
+
+#include <components/bus.h>
+#include <components/component.h>
+#include <components/scheduler.h>
+
+#include "interrupts.h"
+#include "names.h"
+
+namespace emulator::gameboy
+{
+
+/*
+Timer registers:
+    Address	Name	Explanation
+    0xFF04	DIV	Upper 8 bits of the 16-bit system counter, reset on write
+    0xFF05	TIMA	Incremented at the TAC frequency, requests Timer interrupt on overflow
+    0xFF06	TMA	Loaded into TIMA on overflow
+    0xFF07	TAC	Bit 2 enable, bits 0-1 clock select
+
+Nothing is counted per tick, register values are derived from the bus scheduler
+when accessed and the overflow is a scheduled event.
+*/
+class Timer : public emulator::component::IComponent
+{
+private:
+    using Scheduler = emulator::component::Scheduler;
+
+    InterruptController* interrupts_{nullptr};
+
+    // Cycle the system counter was last reset on
+    Scheduler::Cycle divStartCycle_{0};
+
+    // TIMA as of syncCycle_
+    Scheduler::Cycle syncCycle_{0};
+    std::uint8_t TIMA_{0};
+    std::uint8_t TMA_{0};
+    std::uint8_t TAC_{0};
+
+    Scheduler::EventID overflowEvent_{Scheduler::kInvalidEvent};
+
+    Scheduler::Cycle Now() const noexcept;
+
+    bool Enabled() const noexcept
+    {
+        return (TAC_ & 0x4) != 0;
+    }
+
+    Scheduler::Cycle Period() const noexcept;
+
+    void Sync() noexcept;
+    void ScheduleOverflow();
+    void CancelOverflow() noexcept;
+
+public:
+    Timer();
+    ~Timer();
+
+    void SetInterruptController(InterruptController* interrupts) noexcept
+    {
+        interrupts_ = interrupts;
+    }
+
+    void ReceiveTick() override
+    {
+    }
+
+    bool IsTickable() const noexcept override
+    {
+        return false;
+    }
+
+    void AttachToBus(emulator::component::Bus* bus) override;
+    void RemoveFromBus() override;
+
+    void PowerOn() noexcept override;
+    void PowerOff() noexcept override;
+
+    void SaveState(emulator::component::StateWriter& state) const override
+    {
+        state.Write(divStartCycle_);
+        state.Write(syncCycle_);
+        state.Write(TIMA_);
+        state.Write(TMA_);
+        state.Write(TAC_);
+        state.Write(overflowEvent_);
+    }
+
+    void LoadState(emulator::component::StateReader& state) override
+    {
+        state.Read(divStartCycle_);
+        state.Read(syncCycle_);
+        state.Read(TIMA_);
+        state.Read(TMA_);
+        state.Read(TAC_);
+        state.Read(overflowEvent_);
+    }
+
+    void WriteUInt8(std::size_t address, std::uint8_t value) override;
+    std::uint8_t ReadUInt8(std::size_t address) override;
+
+    void WriteInt8(std::size_t address, std::int8_t value) override
+    {
+        WriteUInt8(address, static_cast<std::uint8_t>(value));
+    }
+
+    std::int8_t ReadInt8(std::size_t address) override
+    {
+        return static_cast<std::int8_t>(ReadUInt8(address));
+    }
+};
+
+}; // namespace emulator::gameboy
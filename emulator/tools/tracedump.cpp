@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <tracerecorder.h>
+
+// Prints a recorded instruction trace as text, one instruction per line
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 4) {
+        std::cerr << std::format("Usage: {} <trace> [first instruction] [count]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << std::format("Failed to open {}\n", argv[1]);
+        return 1;
+    }
+
+    std::uint64_t first = argc > 2 ? std::strtoull(argv[2], nullptr, 0) : 0;
+    std::uint64_t count = argc > 3 ? std::strtoull(argv[3], nullptr, 0) : UINT64_MAX;
+
+    try {
+        emulator::component::TraceReader reader(file);
+        auto& names = reader.RegisterNames();
+
+        emulator::component::TraceReader::Record record;
+        for (std::uint64_t index = 0; reader.Next(record); index++) {
+            if (index < first) {
+                continue;
+            } else if (index - first >= count) {
+                break;
+            }
+
+            auto line = std::format("#{} @ {}: {:04X} [{:02X}]", index, record.cycle, record.pc, record.opcode);
+            for (std::size_t i = 0; i < names.size(); i++) {
+                line += std::format(" {}={:X}", names[i], record.registers[i]);
+            }
+            std::cout << line << '\n';
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}\n", argv[1], e.what());
+        return 1;
+    }
+    return 0;
+}